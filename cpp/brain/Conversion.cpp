@@ -20,6 +20,7 @@
 #include <fstream>
 #include <map>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -33,14 +34,18 @@ namespace revolve
 {
   namespace brain
   {
-    std::map< CPPNConfigPtr, cppneat::GeneticEncodingPtr > RegisteredGenotypes;
-
-    std::map< cppneat::Neuron::Ntype, cppneat::Neuron::NeuronTypeSpec >
-            brain_spec;
-
-    std::map< int, size_t > InputMap;
-
-    std::map< int, size_t > OutputMap;
+    namespace
+    {
+      /// \brief Position of the neuron with _innovationNumber in
+      /// _positions, 0 if it has none
+      size_t Position(
+              const std::map< int, size_t > &_positions,
+              const size_t _innovationNumber)
+      {
+        auto position = _positions.find(static_cast< int >(_innovationNumber));
+        return position == _positions.end() ? 0 : position->second;
+      }
+    }
 
     void SetParameters(
             cppneat::Neuron::ParamSpec &_specification,
@@ -59,8 +64,11 @@ namespace revolve
       _specification.max = _maximum;
     }
 
-    void SetBrainSpec(bool _isHyperNeat)
+    std::map< cppneat::Neuron::Ntype, cppneat::Neuron::NeuronTypeSpec >
+    BrainSpec(bool _isHyperNeat)
     {
+      std::map< cppneat::Neuron::Ntype, cppneat::Neuron::NeuronTypeSpec >
+              brain_spec;
       double eps = 1e-9;
       bool max_inclusive = false;
       bool min_inclusive = false;
@@ -192,14 +200,16 @@ namespace revolve
 
         brain_spec[cppneat::Neuron::DIFFERENTIAL_CPG] = differentialNeuron;
       }
+      return brain_spec;
     }
 
 
-    CPPNConfigPtr convertForController(cppneat::GeneticEncodingPtr _genotype)
+    CPPNConfigPtr NEATConverter::convertForController(
+            cppneat::GeneticEncodingPtr _genotype)
     {
       assert(not _genotype->isLayered_);
-      auto neuron_genes = _genotype->neuronGenes_;
-      auto connection_genes = _genotype->connectionGenes_;
+      const auto &neuron_genes = _genotype->neuronGenes_;
+      const auto &connection_genes = _genotype->connectionGenes_;
 
       std::map< int, NeuronPtr > innov_number_to_neuron;
 
@@ -207,22 +217,22 @@ namespace revolve
       for (const auto &neuron : neuron_genes)
       {
         NeuronPtr newNeuron;
-        auto neuronId = neuron->neuron_->neuronId_;
-        auto neuron_params = neuron->neuron_->parameters_;
+        const auto &neuronId = neuron.NeuronId();
+        auto neuron_params = _genotype->Parameters(neuron);
 
-        switch (neuron->neuron_->layer_)
+        switch (neuron.layer_)
         {
           case cppneat::Neuron::INPUT_LAYER:
           {
             newNeuron.reset(new InputNeuron(neuronId, neuron_params));
             config->inputNeurons_.push_back(newNeuron);
             config->inputPositionMap_[newNeuron] =
-                    InputMap[neuron->InnovationNumber()];
+                    Position(inputMap_, neuron.InnovationNumber());
             break;
           }
           case cppneat::Neuron::HIDDEN_LAYER:
           {
-            switch (neuron->neuron_->neuronType_)
+            switch (neuron.neuronType_)
             {
               case cppneat::Neuron::INPUT:
               case cppneat::Neuron::SIMPLE:
@@ -284,7 +294,7 @@ namespace revolve
           }
           case cppneat::Neuron::OUTPUT_LAYER:
           {
-            switch (neuron->neuron_->neuronType_)
+            switch (neuron.neuronType_)
             {
               case cppneat::Neuron::INPUT:
               case cppneat::Neuron::SIMPLE:
@@ -343,7 +353,7 @@ namespace revolve
             }
             config->outputNeurons_.push_back(newNeuron);
             config->outputPositionMap_[newNeuron] =
-                    OutputMap[neuron->InnovationNumber()];
+                    Position(outputMap_, neuron.InnovationNumber());
             break;
           }
           default:
@@ -353,27 +363,40 @@ namespace revolve
         }
         config->allNeurons_.push_back(newNeuron);
         config->idToNeuron_[neuronId] = newNeuron;
-        innov_number_to_neuron[neuron->InnovationNumber()] = newNeuron;
+        innov_number_to_neuron[neuron.InnovationNumber()] = newNeuron;
       }
-      for (cppneat::ConnectionGenePtr &connection : connection_genes)
+      for (const auto &connection : connection_genes)
       {
-        auto dst = innov_number_to_neuron[connection->to_];
+        auto dst = innov_number_to_neuron[connection.to_];
         NeuralConnectionPtr newConnection(new NeuralConnection(
-                innov_number_to_neuron[connection->from_],
+                innov_number_to_neuron[connection.from_],
                 dst,
-                connection->weight_));
+                connection.weight_));
         dst->AddIncomingConnection(
                 dst->SocketId(),
                 newConnection);
         config->connections_.push_back(newConnection);
       }
-      RegisteredGenotypes[config] = _genotype;
+      registeredGenotypes_[config] = _genotype;
       return config;
     }
 
-    cppneat::GeneticEncodingPtr convertForLearner(CPPNConfigPtr _config)
+    cppneat::GeneticEncodingPtr NEATConverter::convertForLearner(
+            CPPNConfigPtr _config)
+    {
+      auto genotype = registeredGenotypes_.find(_config);
+      return genotype == registeredGenotypes_.end()
+             ? nullptr
+             : genotype->second;
+    }
+
+    boost::shared_ptr< Converter< CPPNConfigPtr, cppneat::GeneticEncodingPtr > >
+    NEATConverter::Clone() const
     {
-      return RegisteredGenotypes[_config];
+      auto clone = boost::make_shared< NEATConverter >();
+      clone->inputMap_ = inputMap_;
+      clone->outputMap_ = outputMap_;
+      return clone;
     }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -390,48 +413,46 @@ namespace revolve
     }
 ///////////////////////////////////////////////////////////////////////////////
 
-
-    boost::shared_ptr< CPPNConfig > RafCpgNetwork;
-
-    std::map< std::string, std::tuple< int, int, int>> neuronCoordinates;
-
-    cppneat::GeneticEncodingPtr last_genotype_;
-
     boost::shared_ptr< LayeredExtNNConfig >
-    convertForLayeredExtNN(cppneat::GeneticEncodingPtr genotype)
+    convertForLayeredExtNN(
+            cppneat::GeneticEncodingPtr genotype,
+            const std::map< int, size_t > &_inputMap,
+            const std::map< int, size_t > &_outputMap)
     {
       assert(genotype->isLayered_);
-      auto layers = genotype->layers_;
-      auto connection_genes = genotype->connectionGenes_;
+      const auto &connection_genes = genotype->connectionGenes_;
 
       std::map< int, NeuronPtr > neuron_inovation_numbers;
 
       boost::shared_ptr< LayeredExtNNConfig > cppn(new LayeredExtNNConfig());
       cppn->layers_ = std::vector< std::vector< NeuronPtr > >(
-              layers.size(),
+              genotype->NumLayers(),
               std::vector< NeuronPtr >());
 
-      for (size_t index = 0; index < layers.size(); ++index)
+      // Within a layer the neurons are in innovation order
+      for (const auto &layer : genotype->Layers())
       {
-        for (const auto &neuron : layers.at(index))
+        for (const auto geneIndex : layer)
         {
+          const auto &neuron = genotype->neuronGenes_[geneIndex];
+          const auto index = neuron.layerIndex_;
           NeuronPtr newNeuron;
-          auto neuronId = neuron->neuron_->neuronId_;
-          auto neuronParams = neuron->neuron_->parameters_;
+          const auto &neuronId = neuron.NeuronId();
+          auto neuronParams = genotype->Parameters(neuron);
 
-          switch (neuron->neuron_->layer_)
+          switch (neuron.layer_)
           {
             case cppneat::Neuron::INPUT_LAYER:
             {
               newNeuron.reset(new InputNeuron(neuronId, neuronParams));
               cppn->layers_[index].push_back(newNeuron);
               cppn->inputPositionMap_[newNeuron] =
-                      InputMap[neuron->InnovationNumber()];
+                      Position(_inputMap, neuron.InnovationNumber());
               break;
             }
             case cppneat::Neuron::HIDDEN_LAYER:
             {
-              switch (neuron->neuron_->neuronType_)
+              switch (neuron.neuronType_)
               {
                 case cppneat::Neuron::INPUT:
                 case cppneat::Neuron::SIMPLE:
@@ -493,7 +514,7 @@ namespace revolve
             }
             case cppneat::Neuron::OUTPUT_LAYER:
             {
-              switch (neuron->neuron_->neuronType_)
+              switch (neuron.neuronType_)
               {
                 case cppneat::Neuron::INPUT:
                 case cppneat::Neuron::SIMPLE:
@@ -552,7 +573,7 @@ namespace revolve
               }
               cppn->layers_[index].push_back(newNeuron);
               cppn->outputPositionMap_[newNeuron] =
-                      OutputMap[neuron->InnovationNumber()];
+                      Position(_outputMap, neuron.InnovationNumber());
               break;
             }
             default:
@@ -561,17 +582,17 @@ namespace revolve
             }
           }
           cppn->idToNeuron_[neuronId] = newNeuron;
-          neuron_inovation_numbers[neuron->InnovationNumber()] =
+          neuron_inovation_numbers[neuron.InnovationNumber()] =
                   newNeuron;
         }
       }
       for (const auto &connection : connection_genes)
       {
-        auto destination_neuron = neuron_inovation_numbers[connection->to_];
+        auto destination_neuron = neuron_inovation_numbers[connection.to_];
         NeuralConnectionPtr newConnection(new NeuralConnection(
-                neuron_inovation_numbers[connection->from_],
+                neuron_inovation_numbers[connection.from_],
                 destination_neuron,
-                connection->weight_));
+                connection.weight_));
         destination_neuron->AddIncomingConnection(
                 destination_neuron->SocketId(),
                 newConnection);
@@ -582,6 +603,8 @@ namespace revolve
 
     void write_debugplot(
             boost::shared_ptr< CPPNConfig > conf,
+            const std::map< std::string, std::tuple< int, int, int>>
+            &coordinates,
             bool include_coordinates)
     {
       std::ofstream write_to("debug_plot_extnn.dot");
@@ -613,7 +636,10 @@ namespace revolve
         }
         if (include_coordinates)
         {
-          auto coord = neuronCoordinates[conf->allNeurons_[i]->Id()];
+          auto found = coordinates.find(conf->allNeurons_[i]->Id());
+          auto coord = found == coordinates.end()
+                       ? std::make_tuple(0, 0, 0)
+                       : found->second;
           nodeName << "(x,y,z) = (" << std::get< 0 >(coord)
                    << "," << std::get< 1 >(coord)
                    << "," << std::get< 2 >(coord)
@@ -628,16 +654,16 @@ namespace revolve
 //////////////////////////////////////////////////////////////////////////////
 /// HyperNEAT_CPG
 ///////////////////////////////////////////////////////////////////////////////
-    boost::shared_ptr< CPPNConfig > convertGEtoNN(
+    CPPNConfigPtr HyperNEATCPGConverter::convertForController(
             cppneat::GeneticEncodingPtr _genotype)
     {
-      auto cppn = convertForLayeredExtNN(_genotype);
-      for (const auto &connection : RafCpgNetwork->connections_)
+      auto cppn = convertForLayeredExtNN(_genotype, inputMap_, outputMap_);
+      for (const auto &connection : rafCpgNetwork_->connections_)
       {
         auto src_neuron = connection->GetInputNeuron();
         auto dst_neuron = connection->GetOutputNeuron();
-        auto coord_src = neuronCoordinates[src_neuron->Id()];
-        auto coord_dst = neuronCoordinates[dst_neuron->Id()];
+        auto coord_src = neuronCoordinates_[src_neuron->Id()];
+        auto coord_dst = neuronCoordinates_[dst_neuron->Id()];
         for (const auto &neuron : cppn->layers_.at(0))
         {
           // could be faster by neuron->Id()[6] but less easy to read
@@ -688,10 +714,10 @@ namespace revolve
           }
         }
       }
-      for (const auto &neuron : RafCpgNetwork->allNeurons_)
+      for (const auto &neuron : rafCpgNetwork_->allNeurons_)
       {
         // Retrieve coordinates of source and destination neuron
-        auto coord_src = neuronCoordinates[neuron->Id()];
+        auto coord_src = neuronCoordinates_[neuron->Id()];
         auto coord_dst = std::make_tuple(0, 0, 0);
         for (const auto &inputNeuron : cppn->layers_[0])
         {
@@ -742,15 +768,21 @@ namespace revolve
         }
         neuron->SetParameters(params);
       }
-      last_genotype_ = _genotype;
-      // write_debugplot(RafCpgNetwork, true);
-      return RafCpgNetwork;
+      lastGenotype_ = _genotype;
+      // write_debugplot(rafCpgNetwork_, neuronCoordinates_, true);
+      return rafCpgNetwork_;
     }
 
-    cppneat::GeneticEncodingPtr convertNNtoGE(
+    cppneat::GeneticEncodingPtr HyperNEATCPGConverter::convertForLearner(
             CPPNConfigPtr /*config*/)
     {
-      return last_genotype_;
+      return lastGenotype_;
+    }
+
+    boost::shared_ptr< Converter< CPPNConfigPtr, cppneat::GeneticEncodingPtr > >
+    HyperNEATCPGConverter::Clone() const
+    {
+      return nullptr;
     }
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -758,16 +790,6 @@ namespace revolve
 //////////////////////////////////////////////////////////////////////////////
 /// HyperNEAT_Splines
 ///////////////////////////////////////////////////////////////////////////////
-    std::vector< std::pair< int, int >> sorted_coordinates;
-
-    PolicyPtr policy;
-
-    size_t spline_size;
-
-    size_t update_rate;
-
-    size_t cur_step = 0;
-
     cppneat::GeneticEncodingPtr HyperNeatSplines()
     {
       size_t innovationNumber = 1;
@@ -778,70 +800,83 @@ namespace revolve
       for (size_t i = 0; i < 3; i++)
       {
         // better names (like input x1 etc) might help
-        cppneat::NeuronPtr neuron(new cppneat::Neuron(
+        cppneat::Neuron neuron(
                 "Input-" + std::to_string(i),
                 cppneat::Neuron::INPUT_LAYER,
                 cppneat::Neuron::INPUT,
-                initial_neuron_params));
+                initial_neuron_params);
 
         // Increment innovation number
-        cppneat::NeuronGenePtr neuron_gene(new cppneat::NeuronGene(
+        ret->AddNeuron(
                 neuron,
-                innovationNumber++,
-                true));
-        ret->AddNeuron(neuron_gene, 0, i == 0);
+                cppneat::Gene(innovationNumber++, true),
+                0,
+                i == 0);
       }
 
       // Add output layer
       initial_neuron_params["rv:bias"] = 0;
       initial_neuron_params["rv:gain"] = 0;
-      cppneat::NeuronPtr weight_neuron(new cppneat::Neuron(
+      cppneat::Neuron weight_neuron(
               "weight",
               cppneat::Neuron::OUTPUT_LAYER,
               cppneat::Neuron::SIMPLE,
-              initial_neuron_params));
-      cppneat::NeuronGenePtr weight_neuron_gene(new cppneat::NeuronGene(
+              initial_neuron_params);
+      size_t weight_innovation = innovationNumber++;
+      ret->AddNeuron(
               weight_neuron,
-              innovationNumber++,
-              true));
-      ret->AddNeuron(weight_neuron_gene, 1, true);
+              cppneat::Gene(weight_innovation, true),
+              1,
+              true);
 
       // Connect every input with every output
       for (size_t i = 0; i < 3; ++i)
       {
-        cppneat::ConnectionGenePtr
-                connection_to_weight(new cppneat::ConnectionGene(
-                weight_neuron_gene->InnovationNumber(),
+        ret->AddConnection(cppneat::ConnectionGene(
+                weight_innovation,
                 i + 1,
                 0,
                 innovationNumber++,
                 true,
                 ""));
-        ret->AddConnection(connection_to_weight);
       }
       return ret;
     }
 
-    PolicyPtr convertForSplinesFromHyper(cppneat::GeneticEncodingPtr _genotype)
+    HyperNEATSplinesConverter::HyperNEATSplinesConverter(
+            const size_t _splineSize,
+            const size_t _updateRate)
+            : splineSize_(_splineSize)
+            , updateRate_(_updateRate)
+            , curStep_(0)
+    {
+    }
+
+    PolicyPtr HyperNEATSplinesConverter::convertForController(
+            cppneat::GeneticEncodingPtr _genotype)
     {
       // TODO: fix update rate
-      auto cppn = convertForLayeredExtNN(_genotype);
-      if (++cur_step >= update_rate)
+      // The positions of the neurons don't matter for the splines
+      auto cppn = convertForLayeredExtNN(
+              _genotype,
+              std::map< int, size_t >(),
+              std::map< int, size_t >());
+      if (++curStep_ >= updateRate_)
       {
-        ++spline_size;
-        cur_step = 0;
+        ++splineSize_;
+        curStep_ = 0;
       }
-      policy = PolicyPtr(new Policy(
-              sorted_coordinates.size(),
-              Spline(spline_size, 0)));
-      for (size_t j = 0; j < sorted_coordinates.size(); ++j)
+      PolicyPtr policy(new Policy(
+              sortedCoordinates_.size(),
+              Spline(splineSize_, 0)));
+      for (size_t j = 0; j < sortedCoordinates_.size(); ++j)
       {
-        for (size_t i = 0; i < spline_size; ++i)
+        for (size_t i = 0; i < splineSize_; ++i)
         {
           std::tuple< double, double, double > coord(
-                  sorted_coordinates[j].first,
-                  sorted_coordinates[j].second,
-                  i / (static_cast<double >(spline_size)));
+                  sortedCoordinates_[j].first,
+                  sortedCoordinates_[j].second,
+                  i / (static_cast<double >(splineSize_)));
           for (const auto &neuron : cppn->layers_.at(0))
           {
             // could be faster by neuron->Id()[6] but less easy to read
@@ -882,14 +917,22 @@ namespace revolve
           }
         }
       }
-      last_genotype_ = _genotype;
+      lastGenotype_ = _genotype;
       return policy;
     }
 
     cppneat::GeneticEncodingPtr
-    convertForHyperFromSplines(PolicyPtr /*policy*/)
+    HyperNEATSplinesConverter::convertForLearner(PolicyPtr /*policy*/)
+    {
+      return lastGenotype_;
+    }
+
+    boost::shared_ptr< Converter< PolicyPtr, cppneat::GeneticEncodingPtr > >
+    HyperNEATSplinesConverter::Clone() const
     {
-      return last_genotype_;
+      auto clone = boost::make_shared< HyperNEATSplinesConverter >(*this);
+      clone->lastGenotype_.reset();
+      return clone;
     }
   }
 }
@@ -22,9 +22,11 @@
 
 #include <map>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "brain/Converter.h"
 #include "brain/controller/RafCPGController.h"
 #include "brain/controller/LayeredExtCPPN.h"
 #include "brain/learner/NEATLearner.h"
@@ -35,23 +37,51 @@ namespace revolve
 {
   namespace brain
   {
+    /// \brief Neuron types and parameters of standard neat, for the mutator
+    /// of the cppneat learner. The conversions below only work for these.
+    std::map< cppneat::Neuron::Ntype, cppneat::Neuron::NeuronTypeSpec >
+    BrainSpec(bool _isHyperNeat);
+
+    /// \brief converts a layered genotype to a layered phenotype only works if
+    /// genotype->layered == true. _inputMap and _outputMap give the position
+    /// of the input and output neurons by innovation number.
+    boost::shared_ptr< LayeredExtNNConfig >
+    convertForLayeredExtNN(
+            cppneat::GeneticEncodingPtr genotype,
+            const std::map< int, size_t > &_inputMap,
+            const std::map< int, size_t > &_outputMap);
+
     /// \brief used for communication between cppneat learner and ext nn net
     /// controller the conversion methods work only when using standard neat
-    extern std::map< cppneat::Neuron::Ntype, cppneat::Neuron::NeuronTypeSpec >
-            brain_spec;
+    class NEATConverter
+            : public Converter< CPPNConfigPtr, cppneat::GeneticEncodingPtr >
+    {
+      public:
+      /// \brief
+      CPPNConfigPtr
+      convertForController(cppneat::GeneticEncodingPtr _genotype) override;
 
-    extern std::map< int, size_t > InputMap;
+      /// \brief The genotype _config was converted from
+      cppneat::GeneticEncodingPtr
+      convertForLearner(CPPNConfigPtr _config) override;
 
-    extern std::map< int, size_t > OutputMap;
+      /// \brief A converter with the same maps
+      boost::shared_ptr< Converter > Clone() const override;
 
-    void SetBrainSpec(bool _isHyperNeat);
+      /// \brief Position of the input neurons by innovation number
+      std::map< int, size_t > inputMap_;
 
-    CPPNConfigPtr convertForController(cppneat::GeneticEncodingPtr _genotype);
+      /// \brief Position of the output neurons by innovation number
+      std::map< int, size_t > outputMap_;
 
-    cppneat::GeneticEncodingPtr convertForLearner(CPPNConfigPtr _config);
+      private:
+      /// \brief
+      std::map< CPPNConfigPtr, cppneat::GeneticEncodingPtr >
+              registeredGenotypes_;
+    };
 
 ///////////////////////////////////////////////////////////////////////////////
-/// HyperNEAT_CPG
+/// RLPower_CPG~RLPower_CPPN
 ///////////////////////////////////////////////////////////////////////////////
     /// \brief used for communication between rlpower learner and
     /// ext nn weights controller
@@ -60,49 +90,95 @@ namespace revolve
     PolicyPtr convertDoubleToNull(std::vector< double > _phenotype);
 ///////////////////////////////////////////////////////////////////////////////
 
-    /// \brief used for communication between hyperneat learner and
-    /// ext nn net controller
-    extern boost::shared_ptr< CPPNConfig > RafCpgNetwork;
-
-    extern std::map< std::string, std::tuple< int, int, int>>
-            neuronCoordinates;
-
-    extern cppneat::GeneticEncodingPtr last_genotype_;
-
-    /// \brief converts a layered genotype to a layered phenotype only works if
-    /// genotype->layered == true
-    boost::shared_ptr< LayeredExtNNConfig >
-    convertForLayeredExtNN(cppneat::GeneticEncodingPtr genotype);
-
 ///////////////////////////////////////////////////////////////////////////////
-/// RLPower_CPG~RLPower_CPPN
+/// HyperNEAT_CPG
 ///////////////////////////////////////////////////////////////////////////////
-    boost::shared_ptr< CPPNConfig >
-    convertGEtoNN(cppneat::GeneticEncodingPtr _genotype);
-
-    cppneat::GeneticEncodingPtr
-    convertNNtoGE(boost::shared_ptr< CPPNConfig > config);
+    /// \brief used for communication between hyperneat learner and
+    /// ext nn net controller. Sets the weights and parameters of rafCpgNetwork_
+    /// from the CPPN of the genotype and returns it, so every robot needs a
+    /// converter of its own, set up with its own network.
+    class HyperNEATCPGConverter
+            : public Converter< CPPNConfigPtr, cppneat::GeneticEncodingPtr >
+    {
+      public:
+      /// \brief
+      CPPNConfigPtr
+      convertForController(cppneat::GeneticEncodingPtr _genotype) override;
+
+      /// \brief The genotype last converted
+      cppneat::GeneticEncodingPtr
+      convertForLearner(CPPNConfigPtr _config) override;
+
+      /// \brief nullptr, because rafCpgNetwork_ belongs to one robot
+      boost::shared_ptr< Converter > Clone() const override;
+
+      /// \brief Network of the robot
+      boost::shared_ptr< CPPNConfig > rafCpgNetwork_;
+
+      /// \brief Coordinates of the neurons of rafCpgNetwork_ by id
+      std::map< std::string, std::tuple< int, int, int>> neuronCoordinates_;
+
+      /// \brief
+      std::map< int, size_t > inputMap_;
+
+      /// \brief
+      std::map< int, size_t > outputMap_;
+
+      private:
+      /// \brief
+      cppneat::GeneticEncodingPtr lastGenotype_;
+    };
 ///////////////////////////////////////////////////////////////////////////////
 
-    /// \brief used for communication between spline controller and hyperneat
-    /// learner contains the coordinates of the actuators matching the order the
-    /// actuators are given in the update method coordinate of actuators[0] is
-    /// in sorted_coordinates[0]
-    extern std::vector< std::pair< int, int>> sorted_coordinates;
-
-    extern size_t spline_size;
-
-    extern size_t update_rate;
-
-    extern size_t cur_step;
-
+///////////////////////////////////////////////////////////////////////////////
+/// HyperNEAT_Splines
+///////////////////////////////////////////////////////////////////////////////
     /// \brief returns the starting network for hyperneat on splines
     cppneat::GeneticEncodingPtr HyperNeatSplines();
 
-    PolicyPtr
-    convertForSplinesFromHyper(cppneat::GeneticEncodingPtr _genotype);
-
-    cppneat::GeneticEncodingPtr convertForHyperFromSplines(PolicyPtr policy);
+    /// \brief used for communication between spline controller and hyperneat
+    /// learner
+    class HyperNEATSplinesConverter
+            : public Converter< PolicyPtr, cppneat::GeneticEncodingPtr >
+    {
+      public:
+      /// \brief
+      /// \param _splineSize Initial number of points of the splines
+      /// \param _updateRate Conversions after which the splines get another
+      /// point
+      HyperNEATSplinesConverter(
+              const size_t _splineSize,
+              const size_t _updateRate);
+
+      /// \brief
+      PolicyPtr
+      convertForController(cppneat::GeneticEncodingPtr _genotype) override;
+
+      /// \brief The genotype last converted
+      cppneat::GeneticEncodingPtr convertForLearner(PolicyPtr policy) override;
+
+      /// \brief A converter with the same coordinates and splines
+      boost::shared_ptr< Converter > Clone() const override;
+
+      /// \brief contains the coordinates of the actuators matching the order
+      /// the actuators are given in the update method coordinate of
+      /// actuators[0] is in sortedCoordinates_[0]
+      std::vector< std::pair< int, int>> sortedCoordinates_;
+
+      private:
+      /// \brief
+      size_t splineSize_;
+
+      /// \brief
+      size_t updateRate_;
+
+      /// \brief
+      size_t curStep_;
+
+      /// \brief
+      cppneat::GeneticEncodingPtr lastGenotype_;
+    };
+///////////////////////////////////////////////////////////////////////////////
   }
 }
 
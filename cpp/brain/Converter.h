@@ -0,0 +1,97 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Conversion between the genotypes of a learner and the
+* phenotypes of a controller
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVEBRAIN_BRAIN_CONVERTER_H_
+#define REVOLVEBRAIN_BRAIN_CONVERTER_H_
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace revolve
+{
+  namespace brain
+  {
+    /// \brief Converts the genotypes of a learner to phenotypes of a
+    /// controller and back. A converter keeps the state of the conversion,
+    /// so every ConverterSplitBrain and every robot of its fleet owns its own
+    /// and brains on different threads don't share any.
+    template < typename Phenotype, typename Genotype >
+    class Converter
+    {
+      public:
+      /// \brief
+      virtual ~Converter()
+      {}
+
+      /// \brief Phenotype of _genotype for the controller
+      virtual Phenotype convertForController(Genotype _genotype) = 0;
+
+      /// \brief Genotype of _phenotype for the learner
+      virtual Genotype convertForLearner(Phenotype _phenotype) = 0;
+
+      /// \brief A converter of its own for another robot with the same
+      /// body, or nullptr if one has to be set up for that robot
+      virtual boost::shared_ptr< Converter > Clone() const = 0;
+    };
+
+    /// \brief A converter of two functions that keep no state
+    template < typename Phenotype, typename Genotype >
+    class FunctionConverter
+            : public Converter< Phenotype, Genotype >
+    {
+      public:
+      /// \brief
+      FunctionConverter(
+              Phenotype (*convertForController)(Genotype),
+              Genotype (*convertForLearner)(Phenotype))
+              : convertForController_(convertForController)
+              , convertForLearner_(convertForLearner)
+      {}
+
+      /// \brief
+      Phenotype convertForController(Genotype _genotype) override
+      {
+        return convertForController_(_genotype);
+      }
+
+      /// \brief
+      Genotype convertForLearner(Phenotype _phenotype) override
+      {
+        return convertForLearner_(_phenotype);
+      }
+
+      /// \brief
+      boost::shared_ptr< Converter< Phenotype, Genotype > >
+      Clone() const override
+      {
+        return boost::make_shared< FunctionConverter >(*this);
+      }
+
+      private:
+      /// \brief
+      Phenotype (*convertForController_)(Genotype);
+
+      /// \brief
+      Genotype (*convertForLearner_)(Phenotype);
+    };
+  }
+}
+
+#endif  //  REVOLVEBRAIN_BRAIN_CONVERTER_H_
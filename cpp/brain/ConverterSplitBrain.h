@@ -22,9 +22,15 @@
 
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include <boost/make_shared.hpp>
+
+#include "util/profiler.h"
+
+#include "Converter.h"
 #include "Evaluator.h"
 #include "SplitBrain.h"
 
@@ -38,23 +44,36 @@ namespace revolve
     {
       public:
       /// \brief
+      /// \param converter Converter of this brain, not shared with others
+      /// \param model_name Prefix of the log file
       ConverterSplitBrain(
-              Phenotype (*convertForController)(Genotype),
-              Genotype (*convertForLearner)(Phenotype),
+              boost::shared_ptr< Converter< Phenotype, Genotype > > converter,
               const std::string model_name
       )
               : name_(model_name)
               , isFirstRun_(true)
               , numRuns_(0)
-              , convertForController_(convertForController)
-              , convertForLearner_(convertForLearner)
+              , converter_(converter)
+      {}
+
+      /// \brief Converts with two functions that keep no state
+      ConverterSplitBrain(
+              Phenotype (*convertForController)(Genotype),
+              Genotype (*convertForLearner)(Phenotype),
+              const std::string model_name
+      )
+              : ConverterSplitBrain(
+              boost::make_shared< FunctionConverter< Phenotype, Genotype > >(
+                      convertForController, convertForLearner),
+              model_name)
       {}
 
       /// \brief
       virtual ~ConverterSplitBrain()
       {}
 
-      /// \brief Update step called for the brain.
+      /// \brief Update step called for the brain. Without a fleet the
+      /// learner is used through currentGenotype() and reportFitness().
       /// \param actuators List of actuators
       /// \param sensors List of sensors
       /// \param t Current simulation time
@@ -64,10 +83,121 @@ namespace revolve
               const std::vector< SensorPtr > &sensors,
               double t,
               double step)
+      {
+        NEAT_PROFILE("ConverterSplitBrain::update");
+        if (fleet_.empty())
+        {
+          this->updateAlone(actuators, sensors, t, step);
+          return;
+        }
+        self_.controller = this->controller_;
+        self_.evaluator = evaluator_;
+        self_.converter = converter_;
+        this->updateEvaluation(self_, actuators, sensors, t, step);
+      }
+
+      /// \brief Adds a robot that is evaluated next to the one of this brain,
+      /// so one learner drives a whole fleet of robots in parallel. Idle
+      /// robots get their genotypes from the learner in one batch, with
+      /// askBatch() and tellBatch(). Robots have to be added before the
+      /// first update().
+      /// \param controller Controller of the robot
+      /// \param evaluator Fitness of the robot
+      /// \param converter Converter for the robot; by default a clone of the
+      /// one of the brain. Needed for converters that can't be cloned, such
+      /// as one that sets up the network of a single robot.
+      /// \return index of the robot for updateRobot()
+      size_t addRobot(
+              boost::shared_ptr< Controller< Phenotype > > controller,
+              EvaluatorPtr evaluator,
+              boost::shared_ptr< Converter< Phenotype, Genotype > > converter =
+                      nullptr)
+      {
+        Robot robot;
+        robot.controller = controller;
+        robot.evaluator = evaluator;
+        robot.converter = converter ? converter : converter_->Clone();
+        if (not robot.converter)
+        {
+          throw std::invalid_argument(
+                  "addRobot: the converter of the brain can't be cloned, "
+                  "pass one for the robot");
+        }
+        if (not isFirstRun_)
+        {
+          throw std::logic_error(
+                  "addRobot: robots have to be added before the first "
+                  "update()");
+        }
+        fleet_.push_back(robot);
+        return fleet_.size() - 1;
+      }
+
+      /// \brief Update step of robot _robot of the fleet. A robot waits
+      /// without moving while the learner has no genotype for it.
+      /// \param robot Index returned by addRobot()
+      /// \param actuators List of actuators
+      /// \param sensors List of sensors
+      /// \param t Current simulation time
+      /// \param step Actuation step size in seconds
+      void updateRobot(
+              const size_t robot,
+              const std::vector< ActuatorPtr > &actuators,
+              const std::vector< SensorPtr > &sensors,
+              double t,
+              double step)
+      {
+        NEAT_PROFILE("ConverterSplitBrain::updateRobot");
+        this->updateEvaluation(fleet_.at(robot), actuators, sensors, t, step);
+      }
+
+      /// \brief
+      void writeCurrent(const double _fitness)
+      {
+        std::ofstream outputFile;
+        outputFile.open(name_ + ".log",
+                        std::ios::app | std::ios::out | std::ios::ate);
+        outputFile << "- generation: " << numGeneration_ << std::endl;
+        outputFile << "  velocity: " << _fitness << std::endl;
+        // TODO: Should we record an entire generation?
+        outputFile.close();
+      }
+
+      protected:
+      /// \brief A robot evaluating genotypes of the learner
+      struct Robot
+      {
+        /// \brief
+        boost::shared_ptr< Controller< Phenotype > > controller;
+
+        /// \brief
+        EvaluatorPtr evaluator;
+
+        /// \brief
+        boost::shared_ptr< Converter< Phenotype, Genotype > > converter;
+
+        /// \brief Whether the robot is evaluating the genotype of ticket
+        bool evaluating = false;
+
+        /// \brief
+        Ticket ticket = 0;
+
+        /// \brief
+        double startTime = 0;
+      };
+
+      /// \brief Evaluates the genotypes of the learner one after the other on
+      /// the robot of this brain
+      void updateAlone(
+              const std::vector< ActuatorPtr > &actuators,
+              const std::vector< SensorPtr > &sensors,
+              double t,
+              double step)
       {
         if (isFirstRun_)
         {
-          this->controller_->setPhenotype(convertForController_(
+          NEAT_PROFILE("convertForController");
+          this->controller_->setPhenotype(converter_->convertForController(
                   this->learner_->currentGenotype()));
 
           startTime_ = t;
@@ -81,35 +211,113 @@ namespace revolve
           double fitness = evaluator_->fitness();
           writeCurrent(fitness);
           std::cout << "reporting fitness..." << std::endl;
-          this->learner_->reportFitness(
-                  name_,
-                  convertForLearner_(this->controller_->getPhenotype()),
-                  fitness);
+          Genotype genotype;
+          {
+            NEAT_PROFILE("convertForLearner");
+            genotype = converter_->convertForLearner(
+                    this->controller_->getPhenotype());
+          }
+          {
+            NEAT_PROFILE("Learner::reportFitness");
+            this->learner_->reportFitness(name_, genotype, fitness);
+          }
 
-          Phenotype controllerPhenotype = convertForController_(
-                  this->learner_->currentGenotype());
+          Phenotype controllerPhenotype;
+          {
+            NEAT_PROFILE("convertForController");
+            controllerPhenotype = converter_->convertForController(
+                    this->learner_->currentGenotype());
+          }
 
           this->controller_->setPhenotype(controllerPhenotype);
           startTime_ = t;
           numGeneration_++;
           evaluator_->start();
         }
+        NEAT_PROFILE("Controller::update");
         this->controller_->update(actuators, sensors, t, step);
       }
 
-      /// \brief
-      void writeCurrent(const double _fitness)
+      /// \brief Ends the evaluation of _robot when its time is up, hands out
+      /// genotypes to the idle robots and updates the controller of _robot
+      void updateEvaluation(
+              Robot &_robot,
+              const std::vector< ActuatorPtr > &actuators,
+              const std::vector< SensorPtr > &sensors,
+              double t,
+              double step)
       {
-        std::ofstream outputFile;
-        outputFile.open(name_ + ".log",
-                        std::ios::app | std::ios::out | std::ios::ate);
-        outputFile << "- generation: " << numGeneration_ << std::endl;
-        outputFile << "  velocity: " << _fitness << std::endl;
-        // TODO: Should we record an entire generation?
-        outputFile.close();
+        // and generation_counter_ < max_evaluations_) {
+        if (_robot.evaluating and (t - _robot.startTime) > evaluationRate_)
+        {
+          double fitness = _robot.evaluator->fitness();
+          writeCurrent(fitness);
+          std::cout << "reporting fitness..." << std::endl;
+          toldTickets_.push_back(_robot.ticket);
+          toldFitnesses_.push_back(fitness);
+          _robot.evaluating = false;
+          numGeneration_++;
+        }
+
+        if (not _robot.evaluating)
+        {
+          this->assignGenotypes(t);
+        }
+        isFirstRun_ = false;
+
+        if (_robot.evaluating)
+        {
+          NEAT_PROFILE("Controller::update");
+          _robot.controller->update(actuators, sensors, t, step);
+        }
+      }
+
+      /// \brief Tells the learner the fitnesses collected so far and asks for
+      /// a genotype for every idle robot
+      void assignGenotypes(double t)
+      {
+        if (not toldTickets_.empty())
+        {
+          NEAT_PROFILE("Learner::tellBatch");
+          this->learner_->tellBatch(name_, toldTickets_, toldFitnesses_);
+          toldTickets_.clear();
+          toldFitnesses_.clear();
+        }
+
+        std::vector< Robot * > idle;
+        if (self_.controller and not self_.evaluating)
+        {
+          idle.push_back(&self_);
+        }
+        for (auto &robot : fleet_)
+        {
+          if (not robot.evaluating)
+          {
+            idle.push_back(&robot);
+          }
+        }
+
+        typename Learner< Genotype >::Batch batch;
+        {
+          NEAT_PROFILE("Learner::askBatch");
+          batch = this->learner_->askBatch(idle.size());
+        }
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+          Phenotype controllerPhenotype;
+          {
+            NEAT_PROFILE("convertForController");
+            controllerPhenotype =
+                    idle[i]->converter->convertForController(batch[i].second);
+          }
+          idle[i]->controller->setPhenotype(controllerPhenotype);
+          idle[i]->ticket = batch[i].first;
+          idle[i]->evaluating = true;
+          idle[i]->startTime = t;
+          idle[i]->evaluator->start();
+        }
       }
 
-      protected:
       /// \brief
       std::string name_;
 
@@ -122,7 +330,8 @@ namespace revolve
       /// \brief
       int numRuns_;
 
-      /// \brief
+      /// \brief Start of the evaluation of the robot of this brain, without
+      /// a fleet
       double startTime_ = 0;
 
       /// \brief
@@ -132,10 +341,19 @@ namespace revolve
       EvaluatorPtr evaluator_;
 
       /// \brief
-      Phenotype (*convertForController_)(Genotype);
+      boost::shared_ptr< Converter< Phenotype, Genotype > > converter_;
+
+      /// \brief The robot of this brain, with controller_ and evaluator_
+      Robot self_;
+
+      /// \brief Robots added with addRobot()
+      std::vector< Robot > fleet_;
+
+      /// \brief Finished evaluations not told to the learner yet
+      std::vector< Ticket > toldTickets_;
 
       /// \brief
-      Genotype (*convertForLearner_)(Phenotype);
+      std::vector< double > toldFitnesses_;
     };
   }
 }
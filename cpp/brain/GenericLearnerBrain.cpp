@@ -20,6 +20,8 @@
 
 #include <vector>
 
+#include "util/profiler.h"
+
 #include "GenericLearnerBrain.h"
 
 using namespace revolve::brain;
@@ -39,6 +41,12 @@ void GenericLearnerBrain::update(const std::vector<ActuatorPtr> &actuators,
                                  double t,
                                  double step)
 {
-  BaseController *controller = learner->update(sensors, t, step);
+  NEAT_PROFILE("GenericLearnerBrain::update");
+  BaseController *controller;
+  {
+    NEAT_PROFILE("BaseLearner::update");
+    controller = learner->update(sensors, t, step);
+  }
+  NEAT_PROFILE("BaseController::update");
   controller->update(actuators, sensors, t, step);
 }
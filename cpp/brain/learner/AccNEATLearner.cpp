@@ -21,10 +21,13 @@
 #include <ctime>
 #include <fstream>
 #include <limits>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "brain/controller/AccNEATCPPNController.h"
+#include "util/profiler.h"
 
 #include "AccNEATLearner.h"
 
@@ -45,6 +48,7 @@ AccNEATLearner::AccNEATLearner(
         , n_outputs(n_outputs)
         , generation_counter(0)
         , start_eval_time(std::numeric_limits< double >::lowest())
+        , next_ticket(0)
         , MAX_EVALUATIONS(maxEvaluations)
         , EVALUATION_TIME(evaluationTime)
 {
@@ -53,17 +57,18 @@ AccNEATLearner::AccNEATLearner(
 
 AccNEATLearner::~AccNEATLearner()
 {
-  AsyncNeat::CleanUp();
 }
 
 void AccNEATLearner::initAsyncNeat()
 {
-  AsyncNeat::Init(robot_name);
+  // Every learner has its own settings and genome manager, so the robots in
+  // one process evolve independently.
   std::unique_ptr< AsyncNeat > neat(new AsyncNeat(
           (size_t)n_inputs,
           (size_t)n_outputs,
           (int)std::time(0),  // random seed,
-          robot_name));
+          robot_name,
+          AsyncNeat::DefaultSettings()));
   this->neat = std::move(neat);
 }
 
@@ -109,6 +114,7 @@ BaseController *AccNEATLearner::update(
 
 BaseController *AccNEATLearner::create_new_controller(double fitness)
 {
+  NEAT_PROFILE("AccNEATLearner::create_new_controller");
   if (current_evalaution)
   {
     // not first `create_new_controller`
@@ -125,6 +131,48 @@ BaseController *AccNEATLearner::create_new_controller(double fitness)
   return controller;
 }
 
+std::vector< std::pair< Ticket, const NEAT::Organism * > >
+AccNEATLearner::askBatch(const size_t n)
+{
+  NEAT_PROFILE("AccNEATLearner::askBatch");
+  std::vector< std::pair< Ticket, const NEAT::Organism * > > batch;
+  while (batch.size() < n)
+  {
+    std::shared_ptr< NeatEvaluation > evaluation = neat->Evaluation();
+    if (not evaluation)
+    {
+      break;
+    }
+    batch_evaluations[next_ticket] = evaluation;
+    batch.push_back({next_ticket++, evaluation->Organism()});
+  }
+  return batch;
+}
+
+void AccNEATLearner::tellBatch(
+        const std::vector< Ticket > &tickets,
+        const std::vector< double > &fitnesses)
+{
+  NEAT_PROFILE("AccNEATLearner::tellBatch");
+  if (tickets.size() not_eq fitnesses.size())
+  {
+    throw std::invalid_argument("AccNEATLearner::tellBatch: "
+                                "a fitness is needed for every ticket");
+  }
+  for (size_t i = 0; i < tickets.size(); ++i)
+  {
+    auto ticket = batch_evaluations.find(tickets[i]);
+    if (ticket == batch_evaluations.end())
+    {
+      throw std::invalid_argument("AccNEATLearner::tellBatch: unknown ticket "
+                                  + std::to_string(tickets[i]));
+    }
+    ticket->second->finish(static_cast<float>(fitnesses[i]));
+    batch_evaluations.erase(ticket);
+    generation_counter++;
+  }
+}
+
 float AccNEATLearner::getFitness()
 {
   // Calculate fitness for current policy
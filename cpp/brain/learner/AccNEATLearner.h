@@ -21,12 +21,15 @@
 #ifndef REVOLVE_BRAIN_ACCNEATLEARNER_H
 #define REVOLVE_BRAIN_ACCNEATLEARNER_H
 
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "neat/AsyncNEAT.h"
 #include "brain/Evaluator.h"
 #include "BaseLearner.h"
+#include "Learner.h"
 
 namespace revolve
 {
@@ -54,6 +57,18 @@ namespace revolve
               double t,
               double step) override;
 
+      /// \brief Organisms to be evaluated at the same time, e.g. by a fleet
+      /// of robots, as in Learner::askBatch. Fewer or none are returned while
+      /// the next generation needs the outstanding evaluations. Don't mix
+      /// with update().
+      std::vector< std::pair< Ticket, const NEAT::Organism * > >
+      askBatch(const size_t n);
+
+      /// \brief Finishes the evaluations of organisms handed out by askBatch
+      void tellBatch(
+              const std::vector< Ticket > &tickets,
+              const std::vector< double > &fitnesses);
+
       protected:
       /// \brief
       virtual BaseController *create_new_controller(double fitness) override;
@@ -87,6 +102,12 @@ namespace revolve
       /// \brief
       std::shared_ptr< NeatEvaluation > current_evalaution;
 
+      /// \brief
+      Ticket next_ticket;
+
+      /// \brief Evaluations handed out by askBatch that weren't told yet
+      std::map< Ticket, std::shared_ptr< NeatEvaluation > > batch_evaluations;
+
       /// \brief Number of evaluations before the program quits. Usefull to do
       /// long run tests. If negative (default value), it will never stop.
       ///
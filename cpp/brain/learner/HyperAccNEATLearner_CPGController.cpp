@@ -66,8 +66,8 @@ HyperAccNEATLearner_CPGController::HyperAccNEATLearner_CPGController(
   this->active_controller = std::move(controller);
 
   // NEAT settings
-  AsyncNeat::SetRecurProb(0);
-  AsyncNeat::SetRecurOnlyProb(0);
+  neat->Settings().recur_prob = 0;
+  neat->Settings().recur_only_prob = 0;
 }
 
 BaseController *HyperAccNEATLearner_CPGController::create_new_controller(
@@ -21,12 +21,19 @@
 #ifndef REVOLVEBRAIN_BRAIN_LEARNER_BRAINLEARNER_H_
 #define REVOLVEBRAIN_BRAIN_LEARNER_BRAINLEARNER_H_
 
+#include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace revolve
 {
   namespace brain
   {
+    /// \brief Identifies a genotype handed out by Learner::askBatch until its
+    /// fitness is told
+    typedef size_t Ticket;
+
     template < typename Genotype >
     class Learner
     {
@@ -51,6 +58,28 @@ namespace revolve
       /// \param[in] id: identifier of a robot (in case there are multiple ones)
       /// \return new genome
       virtual Genotype currentGenotype() = 0;
+
+      /// \brief Genotypes handed out by askBatch with their tickets
+      typedef std::vector< std::pair< Ticket, Genotype > > Batch;
+
+      /// \brief Hands out genotypes to be evaluated at the same time, e.g. by
+      /// a fleet of robots. Don't mix with currentGenotype and reportFitness.
+      /// Every ticket has to be told with tellBatch eventually; until then
+      /// the learner keeps what it needs to rank its genotype. Later batches
+      /// may be asked while earlier tickets are still outstanding.
+      /// \param[in] n: number of genotypes wanted
+      /// \return up to n genotypes, fewer or none if the learner needs the
+      /// fitness of outstanding tickets first
+      virtual Batch askBatch(const size_t _n) = 0;
+
+      /// \brief Reports the fitness of genotypes handed out by askBatch
+      /// \param[in] id: identifier of the robots (for logging)
+      /// \param[in] tickets: tickets of the evaluated genotypes
+      /// \param[in] fitnesses: fitness of each ticket
+      virtual void tellBatch(
+              const std::string &_id,
+              const std::vector< Ticket > &_tickets,
+              const std::vector< double > &_fitnesses) = 0;
     };
   }
 }
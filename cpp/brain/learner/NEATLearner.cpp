@@ -21,6 +21,8 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,6 +30,9 @@
 #include <yaml-cpp/yaml.h>
 
 #include "brain/learner/cppneat/CPPNCrossover.h"
+#include "brain/learner/cppneat/GeneticEncodingFile.h"
+#include "util/profiler.h"
+#include "util/scheduler.h"
 
 #include "NEATLearner.h"
 
@@ -60,9 +65,29 @@ namespace cppneat
           , repeatEvaluation_(_config.repeat_evaluations)
           , startFrom_(_config.startFrom)
           , interspeciesMateProbability_(_config.interspeciesMateProbability)
+          , fitnessCache_(std::max(_config.fitnessCacheSize, 0),
+                          std::max(_config.fitnessCacheSamples, 1))
+          , fitnessCacheWeightQuantum_(_config.fitnessCacheWeightQuantum)
+          , activeHash_(0)
+          , activeTickets_(0)
+          , nextTicket_(0)
+          , numGenotypes_(0)
   {
-    std::random_device rd;
-    generator.seed(rd());
+    if (_config.rngSeed not_eq 0)
+    {
+      generator.seed(_config.rngSeed);
+      this->mutator_->Seed(generator());
+    }
+    else
+    {
+      std::random_device rd;
+      generator.seed(rd());
+    }
+    if (fitnessCache_.enabled() and not (fitnessCacheWeightQuantum_ > 0))
+    {
+      throw std::invalid_argument("NEATLearner: the fitness cache needs a "
+                                  "positive fitnessCacheWeightQuantum");
+    }
     if (populationSize_ < 2)
     {
       populationSize_ = 2;
@@ -81,6 +106,9 @@ namespace cppneat
 //    }
     if (startFrom_ not_eq nullptr)
     {
+      // before the initial structural mutations, so that they reuse the
+      // innovation numbers of the starting network
+      this->mutator_->RegisterStartingGenotype(startFrom_);
       std::cout << "generating inital population from starting network"
                 << std::endl;
       Initialise(GeneticEncodingPtrs());
@@ -91,7 +119,6 @@ namespace cppneat
               << "no starting network given, initialise has to be called"
               << std::endl;
     }
-    this->mutator_->RegisterStartingGenotype(startFrom_);
     std::cout
             << "\033[1;33m"
             << "-------------------------------------------------"
@@ -219,6 +246,30 @@ namespace cppneat
             << interspeciesMateProbability_
             << "\033[0m"
             << std::endl;
+    std::cout.width(100);
+    std::cout
+            << std::right
+            << "Number of brains whose fitness is reused (0 for none): "
+            << "\033[1;36m"
+            << _config.fitnessCacheSize
+            << "\033[0m"
+            << std::endl;
+    std::cout.width(100);
+    std::cout
+            << std::right
+            << "Evaluations averaged before the fitness is reused: "
+            << "\033[1;36m"
+            << _config.fitnessCacheSamples
+            << "\033[0m"
+            << std::endl;
+    std::cout.width(100);
+    std::cout
+            << std::right
+            << "Weight difference below which brains are identical: "
+            << "\033[1;36m"
+            << _config.fitnessCacheWeightQuantum
+            << "\033[0m"
+            << std::endl;
     std::cout
             << "\033[1;33m"
             << "-------------------------------------------------"
@@ -243,10 +294,10 @@ namespace cppneat
     this->evaluationQueue_.clear();
     for (const auto &brain : this->brainPpopulation_)
     {
+      brain->serial_ = ++this->numGenotypes_;
       this->evaluationQueue_.push_back(brain);
     }
-    this->activeBrain_ = this->evaluationQueue_.back();
-    this->evaluationQueue_.pop_back();
+    this->NextBrain();
   }
 
   /////////////////////////////////////////////////
@@ -316,17 +367,14 @@ namespace cppneat
                 neuron_params[param_name] = param_node.as< double >();
               }
             }
-            NeuronPtr new_neuron(new Neuron(
+            Neuron new_neuron(
                     id,
                     nlayer,
                     type,
-                    neuron_params));
-            NeuronGenePtr new_neuron_gene(new NeuronGene(
-                    new_neuron,
-                    innovationNumber,
-                    true));
+                    neuron_params);
             newGenome->AddNeuron(
-                    new_neuron_gene,
+                    new_neuron,
+                    Gene(innovationNumber, true),
                     counter,
                     is_new_layer);
             is_new_layer = false;
@@ -351,14 +399,13 @@ namespace cppneat
           {
             innovationNumber = old_to_new[connection["in_no"].as< int >()];
           }
-          ConnectionGenePtr newConnection(new ConnectionGene(
+          newGenome->AddConnection(ConnectionGene(
                   to,
                   from,
                   weight,
                   innovationNumber,
                   true,
                   ""));
-          newGenome->AddConnection(newConnection);
         }
         genotypes.push_back(newGenome);
       }
@@ -400,7 +447,7 @@ namespace cppneat
                       to,
                       innovationNumber);
 
-              ConnectionGenePtr newConnection(new ConnectionGene(
+              newGenome->AddConnection(ConnectionGene(
                       to,
                       from,
                       weight,
@@ -409,7 +456,6 @@ namespace cppneat
                       _yamlPath,
                       first,
                       ""));
-              newGenome->AddConnection(newConnection);
             }
 
             // Load neurons
@@ -443,22 +489,17 @@ namespace cppneat
                 neuron_params[param_name] = param_node.as< double >();
               }
             }
-            NeuronPtr new_neuron(new Neuron(
+            Neuron new_neuron(
                     id,
                     nlayer,
                     type,
-                    neuron_params));
-            NeuronGenePtr new_neuron_gene(new NeuronGene(
-                    new_neuron,
-                    innov_numb,
-                    true,
-                    _yamlPath,
-                    first));
+                    neuron_params);
 
             mutator_->InsertNeuronInnovation(type, innov_numb);
 
             newGenome->AddNeuron(
-                    new_neuron_gene,
+                    new_neuron,
+                    Gene(innov_numb, true, _yamlPath, first),
                     counter,
                     is_new_layer);
             is_new_layer = false;
@@ -471,6 +512,34 @@ namespace cppneat
     }
   }
 
+  /////////////////////////////////////////////////
+  GeneticEncodingPtrs NEATLearner::BinaryBrains(const std::string &_path)
+  {
+    GeneticEncodingPtrs genotypes;
+    if (not GeneticEncodingFile::Load(_path, genotypes))
+    {
+      std::cout << "Failed to load the genotype file." << std::endl;
+      return GeneticEncodingPtrs();
+    }
+    for (const auto &genotype : genotypes)
+    {
+      for (const auto &neuron_gene : genotype->neuronGenes_)
+      {
+        mutator_->InsertNeuronInnovation(
+                neuron_gene.neuronType_,
+                neuron_gene.InnovationNumber());
+      }
+      for (const auto &connection : genotype->connectionGenes_)
+      {
+        mutator_->InsertConnectionInnovation(
+                connection.from_,
+                connection.to_,
+                connection.InnovationNumber());
+      }
+    }
+    return genotypes;
+  }
+
   /////////////////////////////////////////////////
   GeneticEncodingPtrs NEATLearner::InitBrains()
   {
@@ -504,6 +573,7 @@ namespace cppneat
           GeneticEncodingPtr _genotype,
           const double _fitness)
   {
+    NEAT_PROFILE("NEATLearner::reportFitness");
     std::cout << "Evalutation over\n"
               << "Evaluated " << ++numEvaluatedBrains << " brains \n"
               << "Last fitness: " << _fitness << std::endl;
@@ -513,6 +583,7 @@ namespace cppneat
             _genotype);
 
     fitnessBuffer_.push_back(_fitness);
+    this->fitnessCache_.add(this->activeHash_, _fitness);
     if (fitnessBuffer_.size() == this->repeatEvaluation_)
     {
       double sum = 0;
@@ -524,8 +595,25 @@ namespace cppneat
       this->brainFitness_[this->activeBrain_] = avgFitness;
       this->brainVelocity_[this->activeBrain_] = avgFitness;
 
+      this->fitnessBuffer_.clear();
+      this->NextBrain();
+    }
+  }
+
+  /////////////////////////////////////////////////
+  void NEATLearner::NextBrain()
+  {
+    for (;;)
+    {
       if (this->evaluationQueue_.empty())
       {
+        if (not this->tickets_.empty())
+        {
+          // The next generation needs the fitness of the brains still
+          // being evaluated; tellBatch() creates it after the last one.
+          this->activeBrain_ = nullptr;
+          return;
+        }
         this->ShareFitness();
         this->Population();
         std::reverse(evaluationQueue_.begin(), evaluationQueue_.end());
@@ -533,12 +621,28 @@ namespace cppneat
       }
       this->activeBrain_ = this->evaluationQueue_.back();
       this->evaluationQueue_.pop_back();
-      this->fitnessBuffer_.clear();
+      this->activeTickets_ = 0;
       if (this->numGeneration >= this->maxGenerations_)
       {
         std::cout << "Maximum number of generations reached" << std::endl;
         std::exit(0);
       }
+
+      this->activeHash_ = 0;
+      if (this->fitnessCache_.enabled())
+      {
+        this->activeHash_ =
+                this->activeBrain_->Hash(this->fitnessCacheWeightQuantum_);
+      }
+      double fitness;
+      if (not this->fitnessCache_.lookup(this->activeHash_, fitness))
+      {
+        return;
+      }
+      std::cout << "Reusing the fitness of an identical brain: " << fitness
+                << std::endl;
+      this->brainFitness_[this->activeBrain_] = fitness;
+      this->brainVelocity_[this->activeBrain_] = fitness;
     }
   }
 
@@ -548,6 +652,92 @@ namespace cppneat
     return this->activeBrain_;
   }
 
+  /////////////////////////////////////////////////
+  NEATLearner::Batch NEATLearner::askBatch(const size_t _n)
+  {
+    NEAT_PROFILE("NEATLearner::askBatch");
+    Batch batch;
+    if (not this->activeBrain_)
+    {
+      return batch;
+    }
+    while (batch.size() < _n)
+    {
+      if (this->activeTickets_ == this->repeatEvaluation_)
+      {
+        this->NextBrain();
+        if (not this->activeBrain_)
+        {
+          break;
+        }
+      }
+      auto ticket = this->nextTicket_++;
+      this->tickets_[ticket] = {this->activeBrain_, this->activeHash_};
+      ++this->activeTickets_;
+      batch.push_back({ticket, this->activeBrain_});
+    }
+    return batch;
+  }
+
+  /////////////////////////////////////////////////
+  void NEATLearner::tellBatch(
+          const std::string &_id,
+          const std::vector< revolve::brain::Ticket > &_tickets,
+          const std::vector< double > &_fitnesses)
+  {
+    NEAT_PROFILE("NEATLearner::tellBatch");
+    if (_tickets.size() not_eq _fitnesses.size())
+    {
+      throw std::invalid_argument("NEATLearner::tellBatch: "
+                                  "a fitness is needed for every ticket");
+    }
+    for (size_t i = 0; i < _tickets.size(); ++i)
+    {
+      auto ticket = this->tickets_.find(_tickets[i]);
+      if (ticket == this->tickets_.end())
+      {
+        throw std::invalid_argument("NEATLearner::tellBatch: unknown ticket "
+                                    + std::to_string(_tickets[i]));
+      }
+      auto brain = ticket->second.first;
+      ++numEvaluatedBrains;
+      this->RecordGenome(_id, brain);
+      this->fitnessCache_.add(ticket->second.second, _fitnesses[i]);
+      this->tickets_.erase(ticket);
+
+      auto &fitnesses = this->batchFitness_[brain];
+      fitnesses.push_back(_fitnesses[i]);
+      if (fitnesses.size() == this->repeatEvaluation_)
+      {
+        double sum = 0;
+        for (double fitness : fitnesses)
+        {
+          sum += fitness;
+        }
+        double avgFitness = sum / this->repeatEvaluation_;
+        this->brainFitness_[brain] = avgFitness;
+        this->brainVelocity_[brain] = avgFitness;
+        this->batchFitness_.erase(brain);
+      }
+    }
+    std::cout << "Evaluated " << numEvaluatedBrains << " brains, "
+              << this->tickets_.size() << " evaluations outstanding"
+              << std::endl;
+
+    if (not _tickets.empty() and not this->activeBrain_
+        and this->tickets_.empty())
+    {
+      // The last brain of the generation is evaluated
+      this->NextBrain();
+    }
+  }
+
+  /////////////////////////////////////////////////
+  int NEATLearner::Generation() const
+  {
+    return this->numGeneration;
+  }
+
   /////////////////////////////////////////////////
   void NEATLearner::RecordGenome(
           const std::string &_robotName,
@@ -559,11 +749,11 @@ namespace cppneat
     outputFile << "- evaluation: " << numEvaluatedBrains << std::endl;
     outputFile << "  brain:" << std::endl;
     outputFile << "    connection_genes:" << std::endl;
-    auto connection_genes = _genome->connectionGenes_;
+    const auto &connection_genes = _genome->connectionGenes_;
     int n_cons = 1;
     for (const auto &conGene : connection_genes)
     {
-      auto connection = conGene.get();
+      auto connection = &conGene;
       outputFile << "      - con_" << n_cons << ":" << std::endl;
       outputFile << "            in_no: "
                  << connection->InnovationNumber() << std::endl;
@@ -576,24 +766,24 @@ namespace cppneat
                  << connection->ParentsIndex() << std::endl;
     }
     outputFile << "    layers:" << std::endl;
-    auto layers = _genome->layers_;
+    auto layers = _genome->Layers();
     int n_layer = 1;
     for (auto it = layers.begin(); it not_eq layers.end(); it++)
     {
       outputFile << "      - layer_" << n_layer << ":" << std::endl;
       for (auto it2 = it->begin(); it2 not_eq it->end(); it2++)
       {
-        auto neuron = it2->get()->neuron_;
-        auto parameters = neuron->parameters_;
-        outputFile << "          - nid: " << neuron->neuronId_ << std::endl;
-        outputFile << "            ntype: " << neuron->neuronType_ << std::endl;
-        outputFile << "            nlayer: " << neuron->layer_ << std::endl;
+        const auto &neuron = _genome->neuronGenes_[*it2];
+        auto parameters = _genome->Parameters(neuron);
+        outputFile << "          - nid: " << neuron.NeuronId() << std::endl;
+        outputFile << "            ntype: " << neuron.neuronType_ << std::endl;
+        outputFile << "            nlayer: " << neuron.layer_ << std::endl;
         outputFile << "            in_no: "
-                   << it2->get()->InnovationNumber() << std::endl;
+                   << neuron.InnovationNumber() << std::endl;
         outputFile << "            parent_name: "
-                   << it2->get()->ParentsName() << std::endl;
+                   << neuron.ParentsName() << std::endl;
         outputFile << "            parent_index: "
-                   << it2->get()->ParentsIndex() << std::endl;
+                   << neuron.ParentsIndex() << std::endl;
         outputFile << "            params:" << std::endl;
         for (const auto &param : parameters)
         {
@@ -609,66 +799,119 @@ namespace cppneat
   /////////////////////////////////////////////////
   void NEATLearner::ShareFitness()
   {
+    NEAT_PROFILE("NEATLearner::ShareFitness");
     // speciate
-    std::map< GeneticEncodingPtr, GeneticEncodingPtrs > oldSpecies = species_;
-    species_.clear();
     // choose representative from previous generation
-    // (or do nothing for first run)
-    for (auto spPair : oldSpecies)
+    // (or do nothing for first run), in the order of species_
+    GeneticEncodingPtrs representatives;
+    for (const auto &spPair : species_)
     {
       std::uniform_int_distribution< int > choose(0, spPair.second.size() - 1);
-      GeneticEncodingPtr representative = spPair.second[choose(generator)];
-      species_.insert({representative, GeneticEncodingPtrs()});
+      representatives.push_back(spPair.second[choose(generator)]);
     }
+    std::sort(representatives.begin(),
+              representatives.end(),
+              GenotypeOrder());
 
-    for (auto currentBrain : brainVelocity_)
+    GeneticEncodingPtrs brains;
+    for (const auto &brain : brainVelocity_)
+    {
+      brains.push_back(brain.first);
+    }
+
+    // search for the first matching representative of each brain
+    const size_t noMatch = representatives.size();
+    std::vector< size_t > matches(brains.size(), noMatch);
+    static NEAT::Scheduler scheduler("NEATLearner::ShareFitness");
+    scheduler.run(brains.size(),
+                  [&brains](size_t i)
+                  {
+                    return static_cast< double >(brains[i]->NumGenes());
+                  },
+                  [&](size_t i)
+                  {
+                    for (size_t j = 0; j < representatives.size(); ++j)
+                    {
+                      // TODO: coefficients
+                      double dissimilarity = GeneticEncoding::Dissimilarity(
+                              representatives[j],
+                              brains[i],
+                              1,
+                              1,
+                              0.4);
+                      if (dissimilarity < speciationThreshold_)
+                      {
+                        matches[i] = j;
+                        break;
+                      }
+                    }
+                  });
+
+    species_.clear();
+    for (const auto &representative : representatives)
+    {
+      species_.insert({representative, GeneticEncodingPtrs()});
+    }
+    // Species founded by earlier brains come in between the old ones in the
+    // order of species_, so they are searched here, up to the match found
+    // above.
+    std::set< GeneticEncodingPtr, GenotypeOrder > founders;
+    for (size_t i = 0; i < brains.size(); ++i)
     {
-      bool added = false;
-      // search for matching species
-      for (std::pair< GeneticEncodingPtr, std::vector< GeneticEncodingPtr>>
-                spPair
-              : species_)
+      GeneticEncodingPtr species = nullptr;
+      if (matches[i] not_eq noMatch)
       {
-        // TODO: coefficients
-//        std::cout << "<<<<<<<<<< NEATLearner::shareFitness:632 " << std::endl;
+        species = representatives[matches[i]];
+      }
+      for (const auto &founder : founders)
+      {
+        if (species and not GenotypeOrder()(founder, species))
+        {
+          break;
+        }
         double dissimilarity = GeneticEncoding::Dissimilarity(
-                spPair.first,
-                currentBrain.first,
+                founder,
+                brains[i],
                 1,
                 1,
                 0.4);
-//        std::cout << "<<<<<<<<<< NEATLearner::shareFitness:639 " << std::endl;
-
         if (dissimilarity < speciationThreshold_)
         {
-          added = true;
-          species_[spPair.first].push_back(currentBrain.first);
+          species = founder;
           break;
         }
       }
+
+      if (species)
+      {
+        species_[species].push_back(brains[i]);
+      }
       // add new species in case of no matches
-      if (not added)
+      else
       {
         species_.insert(std::make_pair(
-                currentBrain.first,
-                GeneticEncodingPtrs(1, currentBrain.first)));
+                brains[i],
+                GeneticEncodingPtrs(1, brains[i])));
+        founders.insert(brains[i]);
       }
     }
-    oldSpecies = species_;
-    species_.clear();
     // only keep species which are not empty
-    for (auto sppair : oldSpecies)
+    for (auto it = species_.begin(); it not_eq species_.end();)
     {
-      if (not sppair.second.empty())
+      if (it->second.empty())
       {
-        species_.insert(sppair);
+        it = species_.erase(it);
+      }
+      else
+      {
+        ++it;
       }
     }
     // actual sharing
-    std::map< GeneticEncodingPtr, double > new_fitness;
-    for (auto sppair : species_)
+    GenotypeMap< double > new_fitness;
+    for (const auto &sppair : species_)
     {
-      for (GeneticEncodingPtr brain : sppair.second)
+      for (const auto &brain : sppair.second)
       {
         new_fitness[brain] = brainVelocity_[brain] / sppair.second.size();
       }
@@ -724,13 +967,15 @@ namespace cppneat
 
   /////////////////////////////////////////////////
   void
-  NEATLearner::Reproduce(std::map< GeneticEncodingPtr, size_t > _offsprings)
+  NEATLearner::Reproduce(GenotypeMap< size_t > _offsprings)
   {
+    NEAT_PROFILE("NEATLearner::Reproduce");
     std::uniform_real_distribution< double > uniform(0, 1);
-    for (auto spPair : this->species_)
+    ParentPairs parentPairs;
+    for (const auto &spPair : this->species_)
     {
       FitnessPairs fitnessPairs;
-      for (auto brain : spPair.second)
+      for (const auto &brain : spPair.second)
       {
         fitnessPairs.push_back(FitnessPair(
                 brain,
@@ -745,7 +990,6 @@ namespace cppneat
                   return a.second > b.second;
                 });
 
-      ParentPairs parentPairs;
       for (size_t top = 0; top < _offsprings[spPair.first]; ++top)
       {
         if (spPair.second.size() == 1
@@ -769,8 +1013,8 @@ namespace cppneat
           }
 
           FitnessPairs toSort;
-          GeneticEncodingPtrs bachelors = (species_iterator)->second;
-          for (auto brain : bachelors)
+          const auto &bachelors = (species_iterator)->second;
+          for (const auto &brain : bachelors)
           {
             toSort.push_back(FitnessPair(
                     brain,
@@ -799,22 +1043,49 @@ namespace cppneat
           parentPairs.push_back(selected);
         }
       }
+    }
 
-      for (auto parents : parentPairs)
-      {
-        GeneticEncodingPtr offspring = ProduceChild(
-                parents.first,
-                parents.second);
-        this->evaluationQueue_.push_back(offspring);
-      }
+    // Every child has its own random numbers, so it doesn't matter which
+    // thread creates it.
+    std::vector< std::mt19937::result_type > seeds;
+    for (size_t i = 0; i < parentPairs.size(); ++i)
+    {
+      seeds.push_back(generator());
+    }
+    GeneticEncodingPtrs offsprings(parentPairs.size());
+    static NEAT::Scheduler scheduler("NEATLearner::Reproduce");
+    scheduler.run(parentPairs.size(),
+                  [&parentPairs](size_t i)
+                  {
+                    return static_cast< double >(
+                            parentPairs[i].first->NumGenes());
+                  },
+                  [&](size_t i)
+                  {
+                    std::mt19937 childGenerator(seeds[i]);
+                    offsprings[i] = this->ProduceChild(
+                            parentPairs[i].first,
+                            parentPairs[i].second,
+                            childGenerator);
+                    // ready for the lookups of the structural mutation
+                    offsprings[i]->Index();
+                  });
+
+    // Structural mutations register their innovations with the mutator, so
+    // they are applied in the order of the children.
+    for (const auto &offspring : offsprings)
+    {
+      this->ApplyStructuralMutation(offspring);
+      offspring->serial_ = ++this->numGenotypes_;
+      this->evaluationQueue_.push_back(offspring);
     }
   }
 
   /////////////////////////////////////////////////
-  std::map< GeneticEncodingPtr, size_t > NEATLearner::NumChildrenPerSpecie()
+  GenotypeMap< size_t > NEATLearner::NumChildrenPerSpecie()
   {
     double totalFitness = 0;
-    std::map< GeneticEncodingPtr, double > fitnesses;
+    GenotypeMap< double > fitnesses;
     for (auto spPair : this->species_)
     {
       double currentSum = 0;
@@ -826,7 +1097,7 @@ namespace cppneat
       totalFitness += currentSum;
     }
 
-    std::map< GeneticEncodingPtr, size_t > offsprings;
+    GenotypeMap< size_t > offsprings;
     size_t numOffsprings = 0;
     double threshold = 0;
     double avgFitness = totalFitness / this->numChildren_;
@@ -858,7 +1129,8 @@ namespace cppneat
   /////////////////////////////////////////////////
   GeneticEncodingPtr NEATLearner::ProduceChild(
           GeneticEncodingPtr _parent1,
-          GeneticEncodingPtr _parent2)
+          GeneticEncodingPtr _parent2,
+          std::mt19937 &_generator)
   {
     GeneticEncodingPtr offspring;
     if (this->isAsexual_)
@@ -867,20 +1139,20 @@ namespace cppneat
     }
     else
     {
-      offspring = Crossover::crossover(_parent1, _parent2);
+      offspring = Crossover::crossover(_parent1, _parent2, _generator);
     }
 
     mutator_->MutateWeights(
             offspring,
             weightMutationProbability_,
-            weightMutationSigma_);
+            weightMutationSigma_,
+            _generator);
 
     mutator_->MutateNeuronParams(
             offspring,
             paramMutationProbability_,
-            paramMutationSigma_);
-
-    this->ApplyStructuralMutation(offspring);
+            paramMutationSigma_,
+            _generator);
 
     return offspring;
   }
@@ -969,4 +1241,13 @@ namespace cppneat
 
   /////////////////////////////////////////////////
   const double NEATLearner::INTERSPECIES_MATE_PROBABILITY = 0.001;
+
+  /////////////////////////////////////////////////
+  const int NEATLearner::FITNESS_CACHE_SIZE = 0;
+
+  /////////////////////////////////////////////////
+  const int NEATLearner::FITNESS_CACHE_SAMPLES = 1;
+
+  /////////////////////////////////////////////////
+  const double NEATLearner::FITNESS_CACHE_WEIGHT_QUANTUM = 1e-6;
 }
@@ -31,6 +31,7 @@
 #include "Learner.h"
 #include "brain/learner/cppneat/CPPNTypes.h"
 #include "brain/learner/cppneat/CPPNMutator.h"
+#include "util/fitnesscache.h"
 
 /// \brief crossover between genotypes
 namespace cppneat
@@ -48,6 +49,23 @@ namespace cppneat
 
   typedef std::vector< FitnessPair > FitnessPairs;
 
+  /// \brief Orders genotypes by their serial number, and only genotypes
+  /// without one by address, so that a seeded run visits species and brains
+  /// in the same order every time
+  struct GenotypeOrder
+  {
+    bool operator()(
+            const GeneticEncodingPtr &_a,
+            const GeneticEncodingPtr &_b) const
+    {
+      return _a->serial_ not_eq _b->serial_ ? _a->serial_ < _b->serial_
+                                             : _a < _b;
+    }
+  };
+
+  template < typename T >
+  using GenotypeMap = std::map< GeneticEncodingPtr, T, GenotypeOrder >;
+
   class NEATLearner
           : public revolve::brain::Learner< GeneticEncodingPtr >
   {
@@ -72,6 +90,25 @@ namespace cppneat
       double structuralRemovalProbability;
       double interspeciesMateProbability;
 
+      /// \brief Number of genotypes whose fitness is remembered, so that an
+      /// identical one isn't evaluated again; 0, the default, evaluates every
+      /// genotype
+      int fitnessCacheSize = FITNESS_CACHE_SIZE;
+
+      /// \brief Evaluations of a genotype that are averaged before the
+      /// average is reused instead of evaluating it again
+      int fitnessCacheSamples = FITNESS_CACHE_SAMPLES;
+
+      /// \brief Genotypes whose weights and parameters round to the same
+      /// multiple of this count as identical for the fitness cache. Has to
+      /// be positive if fitnessCacheSize is.
+      double fitnessCacheWeightQuantum = FITNESS_CACHE_WEIGHT_QUANTUM;
+
+      /// \brief Seeds the random numbers of selection and mutation, so that
+      /// a run can be repeated on any number of threads; 0 draws a seed from
+      /// std::random_device
+      unsigned int rngSeed = 0;
+
       GeneticEncodingPtr startFrom;
     };
 
@@ -84,6 +121,9 @@ namespace cppneat
     /// \brief
     void Initialise(GeneticEncodingPtrs _genotypes);
 
+    /// \brief Number of generations created after the first one
+    int Generation() const;
+
     /// \brief
     GeneticEncodingPtrs InitBrains();
 
@@ -92,9 +132,26 @@ namespace cppneat
             const std::string &_yamlPath,
             const int _offset);
 
+    /// \brief Loads genotypes written by cppneat::GeneticEncodingFile::Save
+    /// and registers their innovation numbers with the mutator
+    GeneticEncodingPtrs BinaryBrains(const std::string &_path);
+
     /// \brief
     void ApplyStructuralMutation(GeneticEncodingPtr _genotype);
 
+    /// \brief Hands out every brain repeat_evaluations times. The next
+    /// generation needs the fitness of the whole current one, so the batch
+    /// falls short while the last brains of a generation are evaluated, and
+    /// is empty until they are all told.
+    virtual Batch askBatch(const size_t _n);
+
+    /// \brief Averages the fitnesses of a brain once all its evaluations
+    /// are told
+    virtual void tellBatch(
+            const std::string &_id,
+            const std::vector< revolve::brain::Ticket > &_tickets,
+            const std::vector< double > &_fitnesses);
+
     // standard parameters
     static const bool ASEXUAL;
     static const int POP_SIZE;
@@ -111,6 +168,9 @@ namespace cppneat
     static const int REPEAT_EVALUATIONS;
     static const int INITIAL_STRUCTURAL_MUTATIONS;
     static const double INTERSPECIES_MATE_PROBABILITY;
+    static const int FITNESS_CACHE_SIZE;
+    static const int FITNESS_CACHE_SAMPLES;
+    static const double FITNESS_CACHE_WEIGHT_QUANTUM;
     private:
     /// \brief
     virtual void reportFitness(
@@ -121,27 +181,41 @@ namespace cppneat
     /// \brief
     virtual GeneticEncodingPtr currentGenotype();
 
+    /// \brief Takes the next brain to evaluate from the queue, creating a new
+    /// generation when it is empty. Brains whose fitness is in the cache are
+    /// passed over. While the queue is empty and evaluations handed out by
+    /// askBatch() are outstanding, there is no next brain and activeBrain_
+    /// is unset.
+    void NextBrain();
+
     /// \brief
     void RecordGenome(
             const std::string &_robotName,
             GeneticEncodingPtr _genome);
 
-    /// \brief
+    /// \brief Divides the population into species and shares fitness within
+    /// them. The comparisons with the representatives of the previous
+    /// generation run in parallel.
     void ShareFitness();
 
     /// \brief
     void Population();
 
-    /// \brief
-    void Reproduce(std::map< GeneticEncodingPtr, size_t > _offsprings);
+    /// \brief Selects the parents of every child, then creates the children
+    /// in parallel and finally applies their structural mutations in order,
+    /// so innovation numbers don't depend on the threads
+    void Reproduce(GenotypeMap< size_t > _offsprings);
 
     /// \brief
-    std::map< GeneticEncodingPtr, size_t > NumChildrenPerSpecie();
+    GenotypeMap< size_t > NumChildrenPerSpecie();
 
-    /// \brief
+    /// \brief Crossover and mutation of weights and parameters, drawing
+    /// from _generator. Safe to call from several threads at once; the
+    /// structural mutation is left to the caller.
     GeneticEncodingPtr ProduceChild(
             GeneticEncodingPtr _parent1,
-            GeneticEncodingPtr _parent2);
+            GeneticEncodingPtr _parent2,
+            std::mt19937 &_generator);
 
     /// \brief
     ParentPair TournamentSelection(
@@ -159,13 +233,13 @@ namespace cppneat
     GeneticEncodingPtrs brainPpopulation_;
 
     /// \brief
-    std::map< GeneticEncodingPtr, double > brainFitness_;
+    GenotypeMap< double > brainFitness_;
 
     /// \brief
-    std::map< GeneticEncodingPtr, double > brainVelocity_;
+    GenotypeMap< double > brainVelocity_;
 
     /// \brief
-    std::map< GeneticEncodingPtr, std::vector< GeneticEncodingPtr>> species_;
+    GenotypeMap< GeneticEncodingPtrs > species_;
 
     /// \brief
     std::vector< double > fitnessBuffer_;
@@ -232,6 +306,31 @@ namespace cppneat
 
     /// \brief
     std::mt19937 generator;
+
+    /// \brief
+    NEAT::FitnessCache fitnessCache_;
+
+    /// \brief Quantum of the weights in the hash of a brain
+    double fitnessCacheWeightQuantum_;
+
+    /// \brief Hash of activeBrain_ for the fitness cache
+    uint64_t activeHash_;
+
+    /// \brief Tickets of activeBrain_ handed out by askBatch
+    size_t activeTickets_;
+
+    /// \brief
+    revolve::brain::Ticket nextTicket_;
+
+    /// \brief Brain and hash of each ticket that wasn't told yet
+    std::map< revolve::brain::Ticket,
+              std::pair< GeneticEncodingPtr, uint64_t > > tickets_;
+
+    /// \brief Fitnesses told so far of brains with outstanding evaluations
+    GenotypeMap< std::vector< double > > batchFitness_;
+
+    /// \brief Serial number of the last genotype created
+    size_t numGenotypes_;
   };
 }
 
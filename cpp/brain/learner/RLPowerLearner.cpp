@@ -22,10 +22,13 @@
 #include <iostream>
 #include <fstream>
 #include <random>
+#include <stdexcept>
 
 #include <gsl/gsl_spline.h>
 #include <yaml-cpp/yaml.h>
 
+#include "util/profiler.h"
+
 #include "RLPowerLearner.h"
 
 using namespace revolve::brain;
@@ -142,15 +145,19 @@ void RLPowerLearner::reportFitness(
         PolicyPtr /*_genotype*/,
         const double curr_fitness)
 {
-  // Insert ranked policy in list
-  PolicyPtr policy_copy = std::make_shared< Policy >(numActuators_);
-  for (size_t i = 0; i < numActuators_; i++)
-  {
-    Spline &spline = currentPolicy_->at(i);
-    policy_copy->at(i) = Spline(spline.begin(), spline.end());
+  NEAT_PROFILE("RLPowerLearner::reportFitness");
 
-    spline.resize(numSteps_);
-  }
+  this->RankPolicy(*currentPolicy_, curr_fitness);
+  this->GeneratePolicy(*currentPolicy_);
+}
+
+PolicyPtr RLPowerLearner::RankPolicy(
+        const Policy &_policy,
+        const double curr_fitness)
+{
+  // Insert ranked policy in list
+  PolicyPtr policy_copy = std::make_shared< Policy >(_policy);
+  this->Resample(*policy_copy);
   rankedPolicies_.insert({curr_fitness, policy_copy});
 
   // Remove worst policies
@@ -187,6 +194,11 @@ void RLPowerLearner::reportFitness(
     this->IncreaseSplinePoints();
   }
 
+  return policy_copy;
+}
+
+void RLPowerLearner::GeneratePolicy(Policy &_policy)
+{
   /// Actual policy generation
 
   /// Determine which mutation operator to use
@@ -229,7 +241,7 @@ void RLPowerLearner::reportFitness(
     {
       for (size_t j = 0; j < numSteps_; j++)
       {
-        (*currentPolicy_)[i][j] = dist(mt);
+        _policy[i][j] = dist(mt);
       }
     }
   }
@@ -264,17 +276,17 @@ void RLPowerLearner::reportFitness(
         {
           // Apply modifier
           double spline_point = 0;
-          spline_point += ((policy1->at(i)[j] - (*currentPolicy_)[i][j]))
+          spline_point += ((policy1->at(i)[j] - _policy[i][j]))
                           * (fitness1 / total_fitness);
-          spline_point += ((policy2->at(i)[j] - (*currentPolicy_)[i][j]))
+          spline_point += ((policy2->at(i)[j] - _policy[i][j]))
                           * (fitness2 / total_fitness);
 
           // Add a mutation + current
           // TODO: Verify do we use current in this case
-          spline_point += dist(mt) + (*currentPolicy_)[i][j];
+          spline_point += dist(mt) + _policy[i][j];
 
           // Set a newly generated point as current
-          (*currentPolicy_)[i][j] = spline_point;
+          _policy[i][j] = spline_point;
         }
       }
     }
@@ -303,22 +315,95 @@ void RLPowerLearner::reportFitness(
             double fitness = it.first;
             PolicyPtr policy = it.second;
 
-            spline_point += ((policy->at(i)[j] - (*currentPolicy_)[i][j]))
+            spline_point += ((policy->at(i)[j] - _policy[i][j]))
                             * (fitness / total_fitness);
           }
 
           // Add a mutation + current
           // TODO: Verify do we use 'currentPolicy_' in this case
-          spline_point += dist(mt) + (*currentPolicy_)[i][j];
+          spline_point += dist(mt) + _policy[i][j];
 
           // Set a newly generated point as current
-          (*currentPolicy_)[i][j] = spline_point;
+          _policy[i][j] = spline_point;
         }
       }
     }
   }
 }
 
+RLPowerLearner::Batch RLPowerLearner::askBatch(const size_t _n)
+{
+  NEAT_PROFILE("RLPowerLearner::askBatch");
+  Batch batch;
+  for (size_t i = 0; i < _n; ++i)
+  {
+    // The current policy itself, then samples around it
+    PolicyPtr policy = std::make_shared< Policy >(*currentPolicy_);
+    if (currentAsked_)
+    {
+      this->GeneratePolicy(*policy);
+    }
+    currentAsked_ = true;
+    tickets_[nextTicket_] = policy;
+    batch.push_back({nextTicket_++, policy});
+  }
+  return batch;
+}
+
+void RLPowerLearner::tellBatch(
+        const std::string &/*_id*/,
+        const std::vector< Ticket > &_tickets,
+        const std::vector< double > &_fitnesses)
+{
+  NEAT_PROFILE("RLPowerLearner::tellBatch");
+  if (_tickets.size() not_eq _fitnesses.size())
+  {
+    throw std::invalid_argument("RLPowerLearner::tellBatch: "
+                                "a fitness is needed for every ticket");
+  }
+  PolicyPtr best = nullptr;
+  double bestFitness = 0;
+  for (size_t i = 0; i < _tickets.size(); ++i)
+  {
+    auto ticket = tickets_.find(_tickets[i]);
+    if (ticket == tickets_.end())
+    {
+      throw std::invalid_argument("RLPowerLearner::tellBatch: unknown ticket "
+                                  + std::to_string(_tickets[i]));
+    }
+    PolicyPtr ranked = this->RankPolicy(*ticket->second, _fitnesses[i]);
+    tickets_.erase(ticket);
+    if (not best or _fitnesses[i] > bestFitness)
+    {
+      best = ranked;
+      bestFitness = _fitnesses[i];
+    }
+  }
+
+  // Move on from the best policy, like reportFitness does from the only one
+  if (best)
+  {
+    *currentPolicy_ = *best;
+    this->Resample(*currentPolicy_);
+    this->GeneratePolicy(*currentPolicy_);
+    currentAsked_ = false;
+  }
+}
+
+void RLPowerLearner::Resample(Policy &_policy)
+{
+  if (_policy.empty() or _policy.front().size() == numSteps_)
+  {
+    return;
+  }
+  Policy policy_copy(_policy);
+  for (auto &spline : _policy)
+  {
+    spline.resize(numSteps_);
+  }
+  this->InterpolateCubic(&policy_copy, &_policy);
+}
+
 PolicyPtr RLPowerLearner::currentGenotype()
 {
   return currentPolicy_;
@@ -62,6 +62,17 @@ namespace revolve
 
       virtual ~RLPowerLearner();
 
+      /// \brief The current policy, then policies generated from it as
+      /// reportFitness would. Every policy is kept until its ticket is told.
+      virtual Batch askBatch(const size_t _n);
+
+      /// \brief Ranks the told policies and generates the next current policy
+      /// from the fittest of them
+      virtual void tellBatch(
+              const std::string &_id,
+              const std::vector< Ticket > &_tickets,
+              const std::vector< double > &_fitnesses);
+
       /// \brief = 1000; // max number of evaluations
       static const size_t MAX_EVALUATIONS;
 
@@ -143,6 +154,20 @@ namespace revolve
       /// \brief
       virtual PolicyPtr currentGenotype();
 
+      /// \brief Inserts a copy of _policy with its fitness in the ranked
+      /// policies, and counts the evaluation
+      /// \return the copy
+      PolicyPtr RankPolicy(
+              const Policy &_policy,
+              const double curr_fitness);
+
+      /// \brief Recombines _policy with the ranked policies and mutates it
+      void GeneratePolicy(Policy &_policy);
+
+      /// \brief Interpolates the splines of _policy to the current number of
+      /// spline points, if they have another size
+      void Resample(Policy &_policy);
+
       /// \brief Load saved policy from JSON file
       void LoadPolicy(const std::string &_policyPath);
 
@@ -172,6 +197,16 @@ namespace revolve
       /// \brief Pointer to the current policy
       PolicyPtr currentPolicy_ = NULL;
 
+      /// \brief Whether askBatch handed out the current policy already
+      bool currentAsked_ = false;
+
+      /// \brief
+      Ticket nextTicket_ = 0;
+
+      /// \brief Policies handed out by askBatch that weren't told yet. Only
+      /// tellBatch removes them, so a ticket that is never told stays here.
+      std::map< Ticket, PolicyPtr > tickets_;
+
       /// \brief Number of 'interpolation_cache_' sample points
       size_t numInterpolationPoints_;
 
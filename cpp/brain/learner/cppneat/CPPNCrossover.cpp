@@ -17,7 +17,6 @@
 *
 */
 
-#include <iostream>
 #include <random>
 #include <vector>
 
@@ -29,87 +28,56 @@ namespace cppneat
           GeneticEncodingPtr _genotype1,
           GeneticEncodingPtr _genotype2)
   {
-    assert(_genotype2->isLayered_ == _genotype1->isLayered_);
     std::random_device rd;
     std::mt19937 mt(rd());
+    return crossover(_genotype1, _genotype2, mt);
+  }
+
+  GeneticEncodingPtr Crossover::crossover(
+          GeneticEncodingPtr _genotype1,
+          GeneticEncodingPtr _genotype2,
+          std::mt19937 &_generator)
+  {
+    assert(_genotype2->isLayered_ == _genotype1->isLayered_);
     std::uniform_real_distribution< double > udist(0, 1);
-    _genotype1 = _genotype1->Copy();
-    _genotype2 = _genotype2->Copy();
 
-    auto betterGenes = _genotype1->SortedGenes();
-    auto worseGenes = _genotype2->SortedGenes();
-    auto genePairs = GeneticEncoding::Pair(betterGenes, worseGenes);
+    // A gene is only in the child if it is in the more fit parent, so the
+    // child starts as a copy of that parent, sharing its genes, and keeps
+    // its layers. The parents are only read; the child's arrays are only
+    // written if it takes a gene of the other parent that differs.
+    GeneticEncodingPtr childGenotype = _genotype1->Copy();
 
-    std::vector< GenePtr > offspring;
-    for (auto pair : genePairs)
+    const auto &worseNeurons = _genotype2->neuronGenes_;
+    GeneAlignment neurons(_genotype1->neuronGenes_, worseNeurons);
+    for (size_t row = 0; row < neurons.Size(); ++row)
     {
-      if (pair.first not_eq nullptr
-          and pair.second not_eq nullptr)
+      auto better = neurons.Index(row, 0);
+      auto worse = neurons.Index(row, 1);
+      if (better == GeneAlignment::NO_GENE)
       {
-        (udist(mt) < 0.5)
-        ? offspring.push_back(pair.first)
-        : offspring.push_back(pair.second);
+        continue;
       }
-      else if (pair.first not_eq nullptr)
+      if (worse not_eq GeneAlignment::NO_GENE and udist(_generator) >= 0.5)
       {
-        offspring.push_back(pair.first);
+        childGenotype->ReplaceNeuron(better, worseNeurons[worse],
+                                     *_genotype2);
       }
     }
 
-    GeneticEncodingPtr childGenotype;
-    if (not _genotype2->isLayered_)
+    const auto &worseConnections = _genotype2->connectionGenes_;
+    GeneAlignment connections(_genotype1->connectionGenes_, worseConnections);
+    for (size_t row = 0; row < connections.Size(); ++row)
     {
-      childGenotype = GeneticEncodingPtr(new GeneticEncoding(false));
-      for (auto gene : offspring)
+      auto better = connections.Index(row, 0);
+      auto worse = connections.Index(row, 1);
+      if (better == GeneAlignment::NO_GENE)
       {
-        switch (gene->type_)
-        {
-          case Gene::NEURON_GENE:
-            childGenotype->AddNeuron(
-                    boost::dynamic_pointer_cast< NeuronGene >(gene));
-            break;
-          case Gene::CONNECTION_GENE:
-            childGenotype->AddConnection(
-                    boost::dynamic_pointer_cast< ConnectionGene >(gene));
-            break;
-        }
+        continue;
       }
-    }
-    else
-    {
-      // what helps us tremendously here is the fact that a gene is only in the
-      // child if it is in the more fit parent therefore we can use the same
-      // layer structure as in the more fit parent here
-      _genotype1->connectionGenes_.clear();
-      for (auto gene : offspring)
+      if (worse not_eq GeneAlignment::NO_GENE and udist(_generator) >= 0.5)
       {
-        switch (gene->type_)
-        {
-          case Gene::NEURON_GENE:
-          {
-            if (not _genotype1->ExistingNeuron(gene->InnovationNumber()))
-            {
-              std::cout << "BEGIN Neuron NOT exists" << std::endl;
-              _genotype1->AddNeuron(
-                      boost::dynamic_pointer_cast< NeuronGene >(gene),
-                      1, false);
-              std::cout << "END Neuron NOT exists" << std::endl;
-            }
-            auto index = _genotype1->CoordinatesByInnovationNumber(
-                    gene->InnovationNumber());
-            _genotype1->layers_.at(index.first).at(index.second) =
-                    boost::dynamic_pointer_cast< NeuronGene >(gene);
-            break;
-          }
-          case Gene::CONNECTION_GENE:
-          {
-            _genotype1->AddConnection(
-                    boost::dynamic_pointer_cast< ConnectionGene >(gene));
-            break;
-          }
-        }
+        childGenotype->ReplaceConnection(better, worseConnections[worse]);
       }
-      childGenotype = _genotype1;
     }
 
     return childGenotype;
@@ -20,6 +20,8 @@
 #ifndef REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_CROSSOVER_H_
 #define REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_CROSSOVER_H_
 
+#include <random>
+
 #include "GeneticEncoding.h"
 
 namespace cppneat
@@ -31,6 +33,14 @@ namespace cppneat
     crossover(
             GeneticEncodingPtr _genotype1,
             GeneticEncodingPtr _genotype2);
+
+    /// \brief Draws from _generator, and only reads the parents, so several
+    /// children can be created on different threads
+    static GeneticEncodingPtr
+    crossover(
+            GeneticEncodingPtr _genotype1,
+            GeneticEncodingPtr _genotype2,
+            std::mt19937 &_generator);
   };
 }
 
@@ -17,6 +17,7 @@
 *
 */
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <map>
@@ -70,14 +71,19 @@ namespace cppneat
     }
   }
 
+  void Mutator::Seed(const unsigned int _seed)
+  {
+    this->generator_.seed(_seed);
+  }
+
   void Mutator::RegisterStartingGenotype(GeneticEncodingPtr _genotype)
   {
     for (const auto &connection : _genotype->connectionGenes_)
     {
       std::pair< size_t, size_t > innovation(
-              connection->from_,
-              connection->to_);
-      connectionInnovations_[innovation] = connection->InnovationNumber();
+              connection.from_,
+              connection.to_);
+      connectionInnovations_[innovation] = connection.InnovationNumber();
     }
   }
 
@@ -183,57 +189,78 @@ namespace cppneat
 //    }
 //  }
 
+  void Mutator::DrawPerturbations(
+          const size_t _n,
+          const double _probability,
+          const double _sigma,
+          std::vector< char > &_mask,
+          std::vector< double > &_perturbations,
+          std::mt19937 &_generator)
+  {
+    // _generator yields uniform 32-bit values, so comparing them with a
+    // scaled threshold is an exact Bernoulli draw.
+    const double threshold =
+            _probability * (static_cast< double >(_generator.max()) + 1.0);
+    _mask.resize(_n);
+    for (size_t i = 0; i < _n; ++i)
+    {
+      _mask[i] = _generator() < threshold;
+    }
+
+    // One distribution for the whole block, so the second value of every
+    // pair it generates is used as well.
+    std::normal_distribution< double > normal(0, _sigma);
+    _perturbations.assign(_n, 0.0);
+    for (size_t i = 0; i < _n; ++i)
+    {
+      if (_mask[i])
+      {
+        _perturbations[i] = normal(_generator);
+      }
+    }
+  }
+
   void Mutator::MutateNeuronParams(
           GeneticEncodingPtr _genotype,
           const double _probability,
           const double _sigma)
   {
-    std::uniform_real_distribution< double > uniform(0, 1);
-    if (not _genotype->isLayered_)
+    this->MutateNeuronParams(_genotype, _probability, _sigma, generator_);
+  }
+
+  void Mutator::MutateNeuronParams(
+          GeneticEncodingPtr _genotype,
+          const double _probability,
+          const double _sigma,
+          std::mt19937 &_generator) const
+  {
+    const auto &neurons = _genotype->neuronGenes_;
+    std::vector< char > mask;
+    std::vector< double > perturbations;
+    DrawPerturbations(
+            neurons.size(), _probability, _sigma, mask, perturbations,
+            _generator);
+
+    for (size_t i = 0; i < neurons.size(); ++i)
     {
-      for (const auto &neuron : _genotype->neuronGenes_)
+      if (not mask[i])
       {
-        if (uniform(generator_) < _probability)
-        {
-          auto parameters =
-                  specification_[neuron->neuron_->neuronType_].parameters;
-          if (not parameters.empty())
-          {
-            std::uniform_int_distribution< size_t >
-                    uniform_int(0, parameters.size() - 1);
-            auto param = parameters[uniform_int(generator_)];
-            auto currentValue = neuron->neuron_->parameters_[param.name];
-
-            std::normal_distribution< double > normal(0, _sigma);
-            currentValue += normal(generator_);
-            neuron->neuron_->SetNeuronParameters(currentValue, param);
-          }
-        }
+        continue;
       }
-    }
-    else
-    {
-      for (const auto &layer : _genotype->layers_)
+      auto specification = specification_.find(neurons[i].neuronType_);
+      if (specification == specification_.end())
       {
-        for (const auto &neuron : layer)
-        {
-          if (uniform(generator_) < _probability)
-          {
-            auto parameters =
-                    specification_[neuron->neuron_->neuronType_].parameters;
-            if (not parameters.empty())
-            {
-              std::uniform_int_distribution< size_t >
-                      uniform_int(0, parameters.size() - 1);
-              auto param = parameters[uniform_int(generator_)];
-              auto currentValue = neuron->neuron_->parameters_[param.name];
-
-              std::normal_distribution< double > normal(0, _sigma);
-              currentValue += normal(generator_);
-              neuron->neuron_->SetNeuronParameters(currentValue, param);
-            }
-          }
-        }
+        continue;
+      }
+      const auto &parameters = specification->second.parameters;
+      if (not parameters.empty())
+      {
+        std::uniform_int_distribution< size_t >
+                uniform_int(0, parameters.size() - 1);
+        const auto &param = parameters[uniform_int(_generator)];
+        auto currentValue = _genotype->Parameter(neurons[i], param.name);
+        currentValue += perturbations[i];
+        _genotype->SetParameter(i, param.name, currentValue);
       }
     }
   }
@@ -243,13 +270,32 @@ namespace cppneat
           const double _probability,
           const double _sigma)
   {
-    std::uniform_real_distribution< double > uniform(0, 1);
-    std::normal_distribution< double > normal(0, _sigma);
-    for (const auto &connection_gene : _genotype->connectionGenes_)
+    this->MutateWeights(_genotype, _probability, _sigma, generator_);
+  }
+
+  void Mutator::MutateWeights(
+          GeneticEncodingPtr _genotype,
+          const double _probability,
+          const double _sigma,
+          std::mt19937 &_generator) const
+  {
+    std::vector< char > mask;
+    std::vector< double > perturbations;
+    DrawPerturbations(
+            _genotype->NumConnections(), _probability, _sigma, mask,
+            perturbations, _generator);
+    if (std::find(mask.begin(), mask.end(), 1) == mask.end())
     {
-      if (uniform(generator_) < _probability)
+      // Leave the connections shared
+      return;
+    }
+
+    auto &connections = _genotype->connectionGenes_.Write();
+    for (size_t i = 0; i < connections.size(); ++i)
+    {
+      if (mask[i])
       {
-        connection_gene->weight_ += normal(generator_);
+        connections[i].weight_ += perturbations[i];
       }
     }
   }
@@ -283,79 +329,52 @@ namespace cppneat
           GeneticEncodingPtr _genotype,
           const double _sigma)
   {
-    size_t numAttempts = 1;
-    if (not _genotype->isLayered_)
+    // Layered genotypes only connect forward, the others anything but an
+    // input.
+    auto unusable = [&_genotype](
+            const NeuronGene &_from,
+            const NeuronGene &_to)
     {
-      std::uniform_int_distribution< size_t >
-              choice(0, _genotype->NumLayers() - 1);
-      auto fromNeuron = _genotype->neuronGenes_[choice(this->generator_)];
-      auto toNeuron = _genotype->neuronGenes_[choice(this->generator_)];
-      auto from = fromNeuron->InnovationNumber();
-      auto to = toNeuron->InnovationNumber();
-
-      while (_genotype->ExistingConnection(from, to)
-             or toNeuron->neuron_->layer_ == Neuron::INPUT_LAYER)
+      if (_genotype->isLayered_)
       {
-        fromNeuron = _genotype->neuronGenes_[choice(this->generator_)];
-        toNeuron = _genotype->neuronGenes_[choice(this->generator_)];
-        from = fromNeuron->InnovationNumber();
-        to = toNeuron->InnovationNumber();
-
-        ++numAttempts;
-        if (numAttempts > this->maxAttempts_)
-        {
-          return false;
-        }
+        return _from.layerIndex_ >= _to.layerIndex_;
       }
-      std::normal_distribution< double > normal(0, _sigma);
-      this->AddConnection(from, to, normal(generator_), _genotype, "");
-#ifdef CPPNEAT_DEBUG
-      if (not genotype->is_valid())
-      {
-          std::cerr << "add connection mutation caused invalid genotye"
-          << std::endl;
-          throw std::runtime_error("mutation error");
-      }
-#endif
-    }
-    else
+      return _to.layer_ == Neuron::INPUT_LAYER;
+    };
+
+    const auto &neurons = _genotype->neuronGenes_;
+    std::uniform_int_distribution< size_t >
+            choice(0, _genotype->NumNeurons() - 1);
+    size_t numAttempts = 1;
+    const NeuronGene *fromNeuron = &neurons[choice(this->generator_)];
+    const NeuronGene *toNeuron = &neurons[choice(this->generator_)];
+    auto from = fromNeuron->InnovationNumber();
+    auto to = toNeuron->InnovationNumber();
+
+    while (_genotype->ExistingConnection(from, to)
+           or unusable(*fromNeuron, *toNeuron))
     {
-      std::uniform_int_distribution< size_t >
-              choice(0, _genotype->NumNeurons() - 1);
-      auto indexFrom = _genotype->CoordinatesByIndex(choice(generator_));
-      auto indexTo = _genotype->CoordinatesByIndex(choice(generator_));
-      auto fromNeuron = _genotype->layers_[indexFrom.first][indexFrom.second];
-      auto toNeuron = _genotype->layers_[indexTo.first][indexTo.second];
-      auto from = fromNeuron->InnovationNumber();
-      auto to = toNeuron->InnovationNumber();
-
-      while (_genotype->ExistingConnection(from, to)
-             or indexFrom.first >= indexTo.first)
+      fromNeuron = &neurons[choice(this->generator_)];
+      toNeuron = &neurons[choice(this->generator_)];
+      from = fromNeuron->InnovationNumber();
+      to = toNeuron->InnovationNumber();
+
+      ++numAttempts;
+      if (numAttempts > this->maxAttempts_)
       {
-        indexFrom = _genotype->CoordinatesByIndex(choice(generator_));
-        indexTo = _genotype->CoordinatesByIndex(choice(generator_));
-        fromNeuron = _genotype->layers_[indexFrom.first][indexFrom.second];
-        toNeuron = _genotype->layers_[indexTo.first][indexTo.second];
-        from = fromNeuron->InnovationNumber();
-        to = toNeuron->InnovationNumber();
-
-        ++numAttempts;
-        if (numAttempts > this->maxAttempts_)
-        {
-          return false;
-        }
+        return false;
       }
-      std::normal_distribution< double > normal(0, _sigma);
-      AddConnection(from, to, normal(generator_), _genotype, "");
+    }
+    std::normal_distribution< double > normal(0, _sigma);
+    this->AddConnection(from, to, normal(generator_), _genotype, "");
 #ifdef CPPNEAT_DEBUG
-      if (not genotype->is_valid())
-      {
-          std::cerr << "add connection mutation caused invalid genotye"
-           << std::endl;
-          throw std::runtime_error("mutation error");
-      }
-#endif
+    if (not genotype->is_valid())
+    {
+        std::cerr << "add connection mutation caused invalid genotye"
+        << std::endl;
+        throw std::runtime_error("mutation error");
     }
+#endif
     return true;
   }
 
@@ -380,90 +399,50 @@ namespace cppneat
   {
     assert(_genotype->NumConnections() > 0);
     assert(not addableNeurons_.empty());
-    if (not _genotype->isLayered_)
+    std::uniform_int_distribution< size_t >
+            choice1(0, _genotype->NumConnections() - 1);
+    auto splitId = choice1(generator_);
+    // A copy, the gene itself is removed
+    ConnectionGene split = _genotype->connectionGenes_[splitId];
+
+    auto oldWeight = split.weight_;
+    auto from = split.from_;
+    auto to = split.to_;
+
+    _genotype->RemoveConnection(splitId);
+
+    std::uniform_int_distribution< size_t >
+            choice2(0, addableNeurons_.size() - 1);
+    auto neuronType = addableNeurons_[choice2(generator_)];
+
+    auto neuronParameters = RandomParameters(
+            specification_[neuronType],
+            _sigma);
+
+    Neuron neuron_middle(
+            "augment" + std::to_string(innovationNumber_ + 1),
+            Neuron::HIDDEN_LAYER,
+            neuronType,
+            neuronParameters);
+    auto mark_middle = AddNeuron(neuron_middle, _genotype, split);
+#ifdef CPPNEAT_DEBUG
+    if (not genotype->is_valid())
     {
-      std::uniform_int_distribution< size_t >
-              choice1(0, _genotype->NumConnections() - 1);
-      auto splitId = choice1(generator_);
-      auto split = _genotype->connectionGenes_[splitId];
-
-      auto oldWeight = split->weight_;
-      auto from = split->from_;
-      auto to = split->to_;
-
-      _genotype->RemoveConnection(splitId);
-      auto fromNeuron = boost::dynamic_pointer_cast< NeuronGene >(
-              _genotype->Find(from))->neuron_;
-      auto toNeuron = boost::dynamic_pointer_cast< NeuronGene >(
-              _genotype->Find(to))->neuron_;
-
-      std::uniform_int_distribution< size_t >
-              choice2(0, addableNeurons_.size() - 1);
-      auto neuronType = addableNeurons_[choice2(generator_)];
-
-      auto neuronParameters = RandomParameters(
-              specification_[neuronType],
-              _sigma);
-
-      NeuronPtr neuron_middle(new Neuron(
-              ("augment" + std::to_string(innovationNumber_ + 1)),
-              Neuron::HIDDEN_LAYER,
-              neuronType,
-              neuronParameters));
-      auto mark_middle = AddNeuron(neuron_middle, _genotype, split);
-      this->AddConnection(from, mark_middle, oldWeight, _genotype, "");
-      this->AddConnection(mark_middle, to, 1.0, _genotype, "");
+        std::cerr << "add neuron mutation caused invalid genotye1"
+        << std::endl;
+        throw std::runtime_error("mutation error");
     }
-    else
-    {
-      std::uniform_int_distribution< size_t >
-              choice1(0, _genotype->NumConnections() - 1);
-      auto splitId = choice1(generator_);
-      auto split = _genotype->connectionGenes_[splitId];
-
-      auto old_weight = split->weight_;
-      auto from = split->from_;
-      auto to = split->to_;
-
-      _genotype->RemoveConnection(splitId);
-      auto fromNeuron = boost::dynamic_pointer_cast< NeuronGene >(
-              _genotype->Find(from))->neuron_;
-      auto toNeuron = boost::dynamic_pointer_cast< NeuronGene >(
-              _genotype->Find(to))->neuron_;
-
-      std::uniform_int_distribution< size_t >
-              choice2(0, addableNeurons_.size() - 1);
-      auto new_neuron_type = addableNeurons_[choice2(generator_)];
-
-      auto new_neuron_params = RandomParameters(
-              specification_[new_neuron_type],
-              _sigma);
-
-      NeuronPtr neuron_middle(new Neuron(
-              "augment" + std::to_string(innovationNumber_ + 1),
-              Neuron::HIDDEN_LAYER,
-              new_neuron_type,
-              new_neuron_params));
-      auto mark_middle = AddNeuron(neuron_middle, _genotype, split);
-#ifdef CPPNEAT_DEBUG
-      if (not genotype->is_valid())
-      {
-          std::cerr << "add neuron mutation caused invalid genotye1"
-          << std::endl;
-          throw std::runtime_error("mutation error");
-      }
 #endif
-      this->AddConnection(from, mark_middle, old_weight, _genotype, "");
+    this->AddConnection(from, mark_middle, oldWeight, _genotype, "");
 #ifdef CPPNEAT_DEBUG
-      if (not genotype->is_valid())
-      {
-          std::cerr << "add neuron mutation caused invalid genotye2"
-          << std::endl;
-          throw std::runtime_error("mutation error");
-      }
-#endif
-      this->AddConnection(mark_middle, to, 1.0, _genotype, "");
+    if (not genotype->is_valid())
+    {
+        std::cerr << "add neuron mutation caused invalid genotye2"
+        << std::endl;
+        throw std::runtime_error("mutation error");
     }
+#endif
+    this->AddConnection(mark_middle, to, 1.0, _genotype, "");
 #ifdef CPPNEAT_DEBUG
     if (not genotype->is_valid())
     {
@@ -481,31 +460,33 @@ namespace cppneat
     }
     std::uniform_int_distribution< size_t >
             choice(0, _genotype->NumConnections() - 1);
-    _genotype->connectionGenes_.erase(
-            _genotype->connectionGenes_.begin() + choice(generator_));
+    _genotype->RemoveConnection(choice(generator_));
   }
 
   void Mutator::RemoveNeuronMutation(GeneticEncodingPtr _genotype)
   {
     std::vector< size_t > hidden_neuron_ids;
-    for (size_t i = 0; i < _genotype->NumLayers(); i++)
+    for (size_t i = 0; i < _genotype->NumNeurons(); i++)
     {
-      if (_genotype->neuronGenes_[i]->neuron_->layer_ == Neuron::HIDDEN_LAYER)
+      if (_genotype->neuronGenes_[i].layer_ == Neuron::HIDDEN_LAYER)
       {
         hidden_neuron_ids.push_back(i);
       }
     }
+    if (hidden_neuron_ids.empty())
+    {
+      return;
+    }
     std::uniform_int_distribution< size_t >
             choice(0, hidden_neuron_ids.size() - 1);
     auto geneId = hidden_neuron_ids[choice(generator_)];
-    auto neuron_gene = _genotype->neuronGenes_[geneId];
-    auto neuron_mark = neuron_gene->InnovationNumber();
+    auto neuron_mark = _genotype->neuronGenes_[geneId].InnovationNumber();
 
     std::vector< size_t > bad_connections;
     for (size_t i = 0; i < _genotype->NumConnections(); i++)
     {
-      if (_genotype->connectionGenes_[i]->from_ == neuron_mark
-          or _genotype->connectionGenes_[i]->to_ == neuron_mark)
+      if (_genotype->connectionGenes_[i].from_ == neuron_mark
+          or _genotype->connectionGenes_[i].to_ == neuron_mark)
       {
         bad_connections.push_back(i);
       }
@@ -518,84 +499,56 @@ namespace cppneat
   }
 
   size_t Mutator::AddNeuron(
-          NeuronPtr _neuron,
+          const Neuron &_neuron,
           GeneticEncodingPtr _genotype,
-          ConnectionGenePtr _split)
+          const ConnectionGene &_split)
   {
-    auto connection_split_in = _split->InnovationNumber();
+    auto connection_split_in = _split.InnovationNumber();
     std::pair< size_t, Neuron::Ntype > neuron_pair(
             connection_split_in,
-            _neuron->neuronType_);
-    if (neuronInnovations_.find(neuron_pair) not_eq neuronInnovations_.end())
+            _neuron.neuronType_);
+    size_t innovationNumber = 0;
+    auto found = neuronInnovations_.find(neuron_pair);
+    if (found not_eq neuronInnovations_.end())
     {
-      size_t i = 0;
-      while (i < neuronInnovations_[neuron_pair].size()
-             and _genotype->Find(neuronInnovations_[neuron_pair][i])
-                 not_eq nullptr)
-      {
-        i++;
-      }
-      // some previous innovation is not are already present in
-      // the genome-> add a it
-      if (i < neuronInnovations_[neuron_pair].size())
+      // some previous innovation may not be present in the genome yet, then
+      // add that one
+      for (const auto innovation : found->second)
       {
-        NeuronGenePtr new_neuron_gene(new NeuronGene(
-                _neuron,
-                neuronInnovations_[neuron_pair][i],
-                true,
-                "none",
-                -1));
-        if (not _genotype->isLayered_)
+        if (not _genotype->ExistingNeuron(innovation))
         {
-          _genotype->AddNeuron(new_neuron_gene);
+          innovationNumber = innovation;
+          break;
         }
-        else
-        {
-          auto from = _split->from_;
-          auto to = _split->to_;
-          auto fromIndex = _genotype->CoordinatesByInnovationNumber(from);
-          auto toIndex = _genotype->CoordinatesByInnovationNumber(to);
-          assert(fromIndex.first < toIndex.first);
-
-          // we need a new layer iff the two layers are
-          // "right next to each other"
-          _genotype->AddNeuron(
-                  new_neuron_gene,
-                  fromIndex.first + 1,
-                  fromIndex.first + 1 ==
-                  toIndex.first);
-        }
-        return new_neuron_gene->InnovationNumber();
       }
     }
-    // new innovation -> add new neuron with new innovation number
-    NeuronGenePtr new_neuron_gene(new NeuronGene(
-            _neuron,
-            ++innovationNumber_,
-            true,
-            "none",
-            -1));
-    // in base case a new vector is constructed here
-    neuronInnovations_[neuron_pair].push_back(innovationNumber_);
+    if (innovationNumber == 0)
+    {
+      // new innovation -> add new neuron with new innovation number
+      // in base case a new vector is constructed here
+      innovationNumber = ++innovationNumber_;
+      neuronInnovations_[neuron_pair].push_back(innovationNumber);
+    }
+
+    Gene gene(innovationNumber, true, "none", -1);
     if (not _genotype->isLayered_)
     {
-      _genotype->AddNeuron(new_neuron_gene);
+      _genotype->AddNeuron(_neuron, gene);
     }
     else
     {
-      auto from = _split->from_;
-      auto to = _split->to_;
-      auto fromIndex = _genotype->CoordinatesByInnovationNumber(from);
-      auto toIndex = _genotype->CoordinatesByInnovationNumber(to);
-      assert(fromIndex.first < toIndex.first);
+      auto fromLayer = _genotype->FindNeuron(_split.from_)->layerIndex_;
+      auto toLayer = _genotype->FindNeuron(_split.to_)->layerIndex_;
+      assert(fromLayer < toLayer);
 
       // we need a new layer iff the two layers are "right next to each other"
       _genotype->AddNeuron(
-              new_neuron_gene,
-              fromIndex.first + 1,
-              fromIndex.first + 1 == toIndex.first);
+              _neuron,
+              gene,
+              fromLayer + 1,
+              fromLayer + 1 == toLayer);
     }
-    return new_neuron_gene->InnovationNumber();
+    return innovationNumber;
   }
 
   size_t Mutator::AddConnection(
@@ -606,42 +559,33 @@ namespace cppneat
           const std::string &_socket)
   {
     std::pair< size_t, size_t > innovation_pair(_from, _to);
-    if (connectionInnovations_.find(innovation_pair)
-        not_eq connectionInnovations_.end())
+    auto innovation = connectionInnovations_.find(innovation_pair);
+    if (innovation not_eq connectionInnovations_.end())
     {
-      GenePtr found = _genotype->Find(
-              connectionInnovations_[innovation_pair]);
-      if (found not_eq nullptr)
-      {
-        boost::dynamic_pointer_cast< ConnectionGene >(found)->SetEnabled(true);
-        return connectionInnovations_[innovation_pair];
-      }
-      else
+      if (not _genotype->EnableConnection(innovation->second))
       {
-        ConnectionGenePtr new_conn_gene(new ConnectionGene(
+        _genotype->AddConnection(ConnectionGene(
                 _to,
                 _from,
                 _weight,
-                connectionInnovations_[innovation_pair],
+                innovation->second,
                 true,
                 "none",
                 -1,
                 _socket));
-        _genotype->AddConnection(new_conn_gene);
-        return new_conn_gene->InnovationNumber();
       }
+      return innovation->second;
     }
-    ConnectionGenePtr new_conn_gene(new ConnectionGene(
+    connectionInnovations_[innovation_pair] = ++innovationNumber_;
+    _genotype->AddConnection(ConnectionGene(
             _to,
             _from,
             _weight,
-            ++innovationNumber_,
+            innovationNumber_,
             true,
             "none",
             -1,
             _socket));
-    connectionInnovations_[innovation_pair] = innovationNumber_;
-    _genotype->AddConnection(new_conn_gene);
-    return new_conn_gene->InnovationNumber();
+    return innovationNumber_;
   }
 }
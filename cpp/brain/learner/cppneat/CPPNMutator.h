@@ -47,6 +47,10 @@ namespace cppneat
     AddableTypes(
             std::map< Neuron::Ntype, Neuron::NeuronTypeSpec > _specification);
 
+    /// \brief Restarts the random numbers of the mutations that don't take a
+    /// generator, which are seeded from std::random_device by default
+    void Seed(const unsigned int _seed);
+
     /// \brief
     void RegisterStartingGenotype(GeneticEncodingPtr _genotype);
 
@@ -73,12 +77,29 @@ namespace cppneat
             const double _probability,
             const double _sigma);
 
+    /// \brief Draws from _generator instead of the mutator's own, and
+    /// touches nothing but _genotype, so different genotypes can be mutated
+    /// on different threads
+    void MutateNeuronParams(
+            GeneticEncodingPtr _genotype,
+            const double _probability,
+            const double _sigma,
+            std::mt19937 &_generator) const;
+
     /// \brief
     void MutateWeights(
             GeneticEncodingPtr _genotype,
             const double _probability,
             const double _sigma);
 
+    /// \brief Thread-safe like the MutateNeuronParams() that takes a
+    /// generator
+    void MutateWeights(
+            GeneticEncodingPtr _genotype,
+            const double _probability,
+            const double _sigma,
+            std::mt19937 &_generator) const;
+
     /// \brief
     void MutateStructure(
             GeneticEncodingPtr _genotype,
@@ -102,9 +123,9 @@ namespace cppneat
 
     /// \brief
     size_t AddNeuron(
-            NeuronPtr _neuron,
+            const Neuron &_neuron,
             GeneticEncodingPtr _genotype,
-            ConnectionGenePtr _split);
+            const ConnectionGene &_split);
 
     /// \brief
     size_t AddConnection(
@@ -126,6 +147,19 @@ namespace cppneat
       this->innovationNumber_ = _innovationNumber;
     };
 
+    /// \brief Draws for each of _n genes whether it mutates, with
+    /// _probability, and if so a perturbation from N(0, _sigma). All
+    /// decisions are drawn first, then all perturbations, so both loops
+    /// stay tight. Genes that don't mutate get a perturbation of 0.
+    private:
+    static void DrawPerturbations(
+            const size_t _n,
+            const double _probability,
+            const double _sigma,
+            std::vector< char > &_mask,
+            std::vector< double > &_perturbations,
+            std::mt19937 &_generator);
+
     /// \brief <mark_from, mark_to> -> innovation_number
     private:
     std::map< std::pair< size_t, size_t >, size_t > connectionInnovations_;
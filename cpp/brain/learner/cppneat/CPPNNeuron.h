@@ -70,7 +70,7 @@ namespace cppneat
             const std::string &_neuronId,
             Layer _layer,
             Ntype _neuronType,
-            std::map< std::string, double > &_parameters);
+            const std::map< std::string, double > &_parameters);
 
     void SetNeuronParameters(
             const double _value,
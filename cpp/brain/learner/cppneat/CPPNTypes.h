@@ -36,14 +36,8 @@ namespace cppneat
 
   class Mutator;
 
-  typedef boost::shared_ptr< Gene > GenePtr;
-
   typedef boost::shared_ptr< Neuron > NeuronPtr;
 
-  typedef boost::shared_ptr< NeuronGene > NeuronGenePtr;
-
-  typedef boost::shared_ptr< ConnectionGene > ConnectionGenePtr;
-
   typedef boost::shared_ptr< GeneticEncoding > GeneticEncodingPtr;
 
   typedef boost::shared_ptr< Mutator > MutatorPtr;
@@ -20,7 +20,9 @@
 #ifndef REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_CONNECTIONGENOME_H_
 #define REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_CONNECTIONGENOME_H_
 
+#include <cstdint>
 #include <string>
+#include <type_traits>
 
 #include "Genome.h"
 
@@ -37,31 +39,32 @@ namespace cppneat
             double _weight,
             size_t _innovationNumber = 0,
             bool _enabled = true,
-            std::string _parentName = "",
+            const std::string &_parentName = "",
             int _parentIndex = -1,
-            std::string _socket = ""
+            const std::string &_socket = ""
     )
             : Gene(_innovationNumber, _enabled, _parentName, _parentIndex)
             , to_(_to)
             , from_(_from)
             , weight_(_weight)
-            , socket_(_socket)
+            , socket_(GeneStrings().intern(_socket))
     {
-      this->type_ = Gene::CONNECTION_GENE;
     }
 
     /// \brief
-    ConnectionGene(ConnectionGene &_copy)
-            : Gene(_copy.InnovationNumber(),
-                   _copy.IsEnabled(),
-                   _copy.ParentsName(),
-                   _copy.ParentsIndex())
-            , to_(_copy.to_)
-            , from_(_copy.from_)
-            , weight_(_copy.weight_)
-            , socket_(_copy.socket_)
+    inline const std::string &Socket() const
     {
-      this->type_ = Gene::CONNECTION_GENE;
+      return GeneStrings().lookup(this->socket_);
+    }
+
+    /// \brief
+    inline bool operator==(const ConnectionGene &_other) const
+    {
+      return Gene::operator==(_other)
+             and this->to_ == _other.to_
+             and this->from_ == _other.from_
+             and this->weight_ == _other.weight_
+             and this->socket_ == _other.socket_;
     }
 
     public:
@@ -74,9 +77,12 @@ namespace cppneat
     /// \brief
     double weight_;
 
-    /// \brief
-    std::string socket_;
+    /// \brief GeneStrings() id of the socket
+    NEAT::StringTable::id_t socket_;
   };
+
+  static_assert(std::is_trivially_copyable< ConnectionGene >::value,
+                "connection genes are copied as plain memory");
 }
 
 #endif  //  REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_CONNECTIONGENOME_H_
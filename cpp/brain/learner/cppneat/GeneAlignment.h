@@ -0,0 +1,174 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Genes of several genotypes lined up by innovation number
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENEALIGNMENT_H_
+#define REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENEALIGNMENT_H_
+
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace cppneat
+{
+  /// \brief Lines up gene arrays sorted by innovation number, such as the
+  /// neuron or connection genes of several genotypes. There is a row for
+  /// every innovation number in any of the arrays, in increasing order, and
+  /// a column for every array, holding the index of the gene with that
+  /// innovation number in the array, or NO_GENE.
+  ///
+  /// The arrays are merged, so aligning them takes time linear in the
+  /// number of genes (times log of the number of arrays), whatever the
+  /// range of innovation numbers. Any array with size() and operator[]
+  /// will do, such as a std::vector or a GeneArray.
+  class GeneAlignment
+  {
+    public:
+    /// \brief Marks a gene that an array lacks
+    static const size_t NO_GENE = static_cast< size_t >(-1);
+
+    /// \brief Aligns two arrays
+    template < typename Genes >
+    GeneAlignment(
+            const Genes &_genes1,
+            const Genes &_genes2);
+
+    /// \brief Aligns any number of arrays
+    template < typename Genes >
+    explicit GeneAlignment(const std::vector< const Genes * > &_genes);
+
+    /// \brief Number of rows
+    size_t Size() const
+    {
+      return this->size_;
+    }
+
+    /// \brief Number of columns
+    size_t Width() const
+    {
+      return this->width_;
+    }
+
+    /// \brief Innovation number of _row
+    size_t InnovationNumber(const size_t _row) const
+    {
+      return this->rows_[_row * (this->width_ + 1)];
+    }
+
+    /// \brief Index of the gene of _row in array _column, or NO_GENE
+    size_t Index(
+            const size_t _row,
+            const size_t _column) const
+    {
+      return this->rows_[_row * (this->width_ + 1) + 1 + _column];
+    }
+
+    private:
+    /// \brief
+    size_t width_;
+
+    /// \brief
+    size_t size_;
+
+    /// \brief Size() rows of the innovation number followed by Width()
+    /// indices
+    std::vector< size_t > rows_;
+  };
+
+  /////////////////////////////////////////////////
+  template < typename Genes >
+  GeneAlignment::GeneAlignment(
+          const Genes &_genes1,
+          const Genes &_genes2)
+          : width_(2)
+          , size_(0)
+  {
+    this->rows_.reserve(3 * (_genes1.size() + _genes2.size()));
+    size_t i = 0, j = 0;
+    while (i < _genes1.size() or j < _genes2.size())
+    {
+      if (j == _genes2.size()
+          or (i < _genes1.size() and _genes1[i].InnovationNumber()
+                                     < _genes2[j].InnovationNumber()))
+      {
+        this->rows_.push_back(_genes1[i].InnovationNumber());
+        this->rows_.push_back(i++);
+        this->rows_.push_back(NO_GENE);
+      }
+      else if (i == _genes1.size()
+               or _genes2[j].InnovationNumber()
+                  < _genes1[i].InnovationNumber())
+      {
+        this->rows_.push_back(_genes2[j].InnovationNumber());
+        this->rows_.push_back(NO_GENE);
+        this->rows_.push_back(j++);
+      }
+      else
+      {
+        this->rows_.push_back(_genes1[i].InnovationNumber());
+        this->rows_.push_back(i++);
+        this->rows_.push_back(j++);
+      }
+    }
+    this->size_ = this->rows_.size() / 3;
+  }
+
+  /////////////////////////////////////////////////
+  template < typename Genes >
+  GeneAlignment::GeneAlignment(const std::vector< const Genes * > &_genes)
+          : width_(_genes.size())
+          , size_(0)
+  {
+    // The next gene of each array, as (innovation number, array)
+    typedef std::pair< size_t, size_t > Head;
+    std::priority_queue< Head, std::vector< Head >, std::greater< Head > >
+            heads;
+    std::vector< size_t > next(this->width_, 0);
+    for (size_t column = 0; column < this->width_; ++column)
+    {
+      if (_genes[column]->size() > 0)
+      {
+        heads.emplace((*_genes[column])[0].InnovationNumber(), column);
+      }
+    }
+
+    while (not heads.empty())
+    {
+      auto innovation = heads.top().first;
+      this->rows_.push_back(innovation);
+      ++this->size_;
+      this->rows_.resize(this->rows_.size() + this->width_, NO_GENE);
+      auto row = this->rows_.end() - this->width_;
+      while (not heads.empty() and heads.top().first == innovation)
+      {
+        auto column = heads.top().second;
+        heads.pop();
+        const auto &genes = *_genes[column];
+        row[column] = next[column]++;
+        if (next[column] < genes.size())
+        {
+          heads.emplace(genes[next[column]].InnovationNumber(), column);
+        }
+      }
+    }
+  }
+}
+
+#endif  //  REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENEALIGNMENT_H_
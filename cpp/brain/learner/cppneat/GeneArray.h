@@ -0,0 +1,138 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Gene array shared copy-on-write between genotypes
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENEARRAY_H_
+#define REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENEARRAY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace cppneat
+{
+  /// \brief An array of genes that copies share until one of them is
+  /// written. Reading works like a const std::vector; Write() gives the
+  /// array to change, copying it first if another genotype shares it.
+  ///
+  /// Copies may be read and written from different threads, as long as
+  /// each copy is only used by one thread at a time.
+  template < typename GeneType >
+  class GeneArray
+  {
+    public:
+    typedef typename std::vector< GeneType >::const_iterator const_iterator;
+
+    /// \brief
+    GeneArray()
+            : genes_(std::make_shared< std::vector< GeneType > >())
+    {}
+
+    /// \brief
+    explicit GeneArray(std::vector< GeneType > _genes)
+            : genes_(std::make_shared< std::vector< GeneType > >(
+            std::move(_genes)))
+    {}
+
+    /// \brief
+    size_t size() const
+    {
+      return this->genes_->size();
+    }
+
+    /// \brief
+    bool empty() const
+    {
+      return this->genes_->empty();
+    }
+
+    /// \brief
+    const GeneType &operator[](const size_t _index) const
+    {
+      return (*this->genes_)[_index];
+    }
+
+    /// \brief
+    const GeneType &at(const size_t _index) const
+    {
+      return this->genes_->at(_index);
+    }
+
+    /// \brief
+    const GeneType &front() const
+    {
+      return this->genes_->front();
+    }
+
+    /// \brief
+    const GeneType &back() const
+    {
+      return this->genes_->back();
+    }
+
+    /// \brief
+    const GeneType *data() const
+    {
+      return this->genes_->data();
+    }
+
+    /// \brief
+    const_iterator begin() const
+    {
+      return this->genes_->cbegin();
+    }
+
+    /// \brief
+    const_iterator end() const
+    {
+      return this->genes_->cend();
+    }
+
+    /// \brief Whether _other is a copy that nothing was written to since
+    bool Shares(const GeneArray &_other) const
+    {
+      return this->genes_ == _other.genes_;
+    }
+
+    /// \brief The genes to change, no longer shared with any copy.
+    /// Invalidates references obtained by reading.
+    std::vector< GeneType > &Write()
+    {
+      if (this->genes_.use_count() > 1)
+      {
+        this->genes_ = std::make_shared< std::vector< GeneType > >(
+                *this->genes_);
+      }
+      else
+      {
+        // The last other owner may have let go on another thread; its
+        // reads happen before the writes that follow.
+        std::atomic_thread_fence(std::memory_order_acquire);
+      }
+      return *this->genes_;
+    }
+
+    private:
+    /// \brief
+    std::shared_ptr< std::vector< GeneType > > genes_;
+  };
+}
+
+#endif  //  REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENEARRAY_H_
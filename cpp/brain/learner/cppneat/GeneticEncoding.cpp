@@ -18,9 +18,12 @@
 */
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <iostream>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -28,197 +31,328 @@
 
 namespace cppneat
 {
-  //  bool CompareGenes(
-  //          const GenePtr _gene1,
-  //          const GenePtr _gene2)
-  //  {
-  //    return _gene1->InnovationNumber() < _gene2->InnovationNumber();
-  //  }
+  const size_t GeneAlignment::NO_GENE;
 
-  // non-layered
-  void GeneticEncoding::AddNeuron(NeuronGenePtr _neuron)
+  namespace
   {
-    this->SortedGenes();
-    this->neuronGenes_.push_back(_neuron);
-    auto ins = std::upper_bound(
-            this->allSortedGenes_.begin(),
-            this->allSortedGenes_.end(),
-            boost::dynamic_pointer_cast< Gene >(_neuron),
-            [](
-                    GenePtr _gene1,
-                    GenePtr _gene2)
-            {
-              return _gene1->InnovationNumber() < _gene2->InnovationNumber();
-            });
-    this->allSortedGenes_.insert(
-            ins,
-            boost::dynamic_pointer_cast< Gene >(_neuron));
+    bool LessInnovation(
+            const Gene &_gene1,
+            const Gene &_gene2)
+    {
+      return _gene1.InnovationNumber() < _gene2.InnovationNumber();
+    }
+
+    std::vector< NeuronParameter > Pack(
+            const std::map< std::string, double > &_parameters)
+    {
+      std::vector< NeuronParameter > packed;
+      packed.reserve(_parameters.size());
+      for (const auto &param : _parameters)
+      {
+        packed.push_back({GeneStrings().intern(param.first), param.second});
+      }
+      return packed;
+    }
+
+    /// \brief Whether two neuron genes are the same, parameters aside
+    bool SameNeuron(
+            const NeuronGene &_neuron1,
+            const NeuronGene &_neuron2)
+    {
+      return static_cast< const Gene & >(_neuron1) == _neuron2
+             and _neuron1.neuronId_ == _neuron2.neuronId_
+             and _neuron1.layer_ == _neuron2.layer_
+             and _neuron1.neuronType_ == _neuron2.neuronType_
+             and _neuron1.numParams_ == _neuron2.numParams_;
+    }
   }
 
-  // layered
-  void GeneticEncoding::AddNeuron(
-          NeuronGenePtr _neuron,
-          const size_t _layer,
-          const bool _newLayer)
+  void GeneticEncoding::Index()
   {
-    this->SortedGenes();
-    if (_newLayer)
+    if (this->indexed_)
     {
-      layers_.emplace(
-              this->layers_.begin() + _layer,
-              std::vector< NeuronGenePtr >(1, _neuron));
+      return;
     }
-    else
+    this->neuronIndex_.clear();
+    this->connectionIndex_.clear();
+    this->edges_.clear();
+    this->neuronIndex_.reserve(this->neuronGenes_.size());
+    this->connectionIndex_.reserve(this->connectionGenes_.size());
+    this->edges_.reserve(this->connectionGenes_.size());
+    Reindex(this->neuronGenes_, 0, this->neuronIndex_);
+    Reindex(this->connectionGenes_, 0, this->connectionIndex_);
+    for (const auto &connection : this->connectionGenes_)
     {
-      this->layers_[_layer].push_back(_neuron);
+      this->edges_.emplace(
+              std::make_pair(connection.from_, connection.to_),
+              connection.InnovationNumber());
     }
-    auto ins = std::upper_bound(
-            this->allSortedGenes_.begin(),
-            this->allSortedGenes_.end(),
-            boost::dynamic_pointer_cast< Gene >(_neuron),
-            [](
-                    GenePtr _gene1,
-                    GenePtr _gene2)
-            {
-              return _gene1->InnovationNumber() < _gene2->InnovationNumber();
-            });
-    this->allSortedGenes_.insert(
-            ins,
-            boost::dynamic_pointer_cast< Gene >(_neuron));
+    this->indexed_ = true;
   }
 
+  template < typename Genes >
+  void GeneticEncoding::Reindex(
+          const Genes &_genes,
+          const size_t _begin,
+          std::unordered_map< size_t, size_t > &_index)
+  {
+    for (size_t i = _begin; i < _genes.size(); ++i)
+    {
+      _index[_genes[i].InnovationNumber()] = i;
+    }
+  }
 
-  void GeneticEncoding::AddConnection(ConnectionGenePtr _connection)
+  void GeneticEncoding::InsertNeuron(
+          NeuronGene _gene,
+          const NeuronParameter *_parameters)
   {
-    this->SortedGenes();
-    this->connectionGenes_.push_back(_connection);
+    auto &params = this->neuronParams_.Write();
+    _gene.paramsBegin_ = static_cast< uint32_t >(params.size());
+    params.insert(params.end(), _parameters, _parameters + _gene.numParams_);
+    auto &neurons = this->neuronGenes_.Write();
     auto ins = std::upper_bound(
-            this->allSortedGenes_.begin(),
-            this->allSortedGenes_.end(),
-            boost::dynamic_pointer_cast< Gene >(_connection),
-            [](
-                    GenePtr _gene1,
-                    GenePtr _gene2)
-            {
-              return _gene1->InnovationNumber() < _gene2->InnovationNumber();
-            });
-    this->allSortedGenes_.insert(
-            ins,
-            boost::dynamic_pointer_cast< Gene >(_connection));
+            neurons.begin(),
+            neurons.end(),
+            _gene,
+            LessInnovation);
+    auto index = static_cast< size_t >(ins - neurons.begin());
+    neurons.insert(ins, _gene);
+    if (this->indexed_)
+    {
+      // New innovations are usually the highest, so this is cheap
+      Reindex(this->neuronGenes_, index, this->neuronIndex_);
+    }
   }
 
-  // ALERT::only works non-layered but seems to be not needed
-  void GeneticEncoding::Adopt(GeneticEncodingPtr adoptee)
+  // non-layered
+  void GeneticEncoding::AddNeuron(
+          const Neuron &_neuron,
+          const Gene &_gene)
+  {
+    auto parameters = Pack(_neuron.parameters_);
+    NeuronGene gene(_neuron, _gene);
+    gene.numParams_ = static_cast< uint32_t >(parameters.size());
+    this->InsertNeuron(gene, parameters.data());
+  }
+
+  // layered
+  void GeneticEncoding::AddNeuron(
+          const Neuron &_neuron,
+          const Gene &_gene,
+          const size_t _layer,
+          const bool _newLayer)
   {
-    this->SortedGenes();
-    auto sortedAdoptes = adoptee->SortedGenes();
-    auto pairs = GeneticEncoding::Pair(
-            sortedAdoptes,
-            allSortedGenes_);
-    for (const auto pair : pairs)
+    if (_newLayer)
     {
-      // adopt genes that i dont have
-      if (pair.first not_eq nullptr and pair.second == nullptr)
+      for (auto &neuron : this->neuronGenes_.Write())
       {
-        if (pair.first->type_ == Gene::NEURON_GENE)
+        if (neuron.layerIndex_ >= _layer)
         {
-          this->AddNeuron(
-                  boost::dynamic_pointer_cast< NeuronGene >(pair.first));
-        }
-        else if (pair.first->type_ == Gene::CONNECTION_GENE)
-        {
-          this->AddConnection(
-                  boost::dynamic_pointer_cast< ConnectionGene >(pair.first));
+          ++neuron.layerIndex_;
         }
       }
+      ++this->numLayers_;
+    }
+    auto parameters = Pack(_neuron.parameters_);
+    NeuronGene gene(_neuron, _gene);
+    gene.layerIndex_ = static_cast< uint32_t >(_layer);
+    gene.numParams_ = static_cast< uint32_t >(parameters.size());
+    this->InsertNeuron(gene, parameters.data());
+  }
+
+  void GeneticEncoding::AddNeuron(
+          const NeuronGene &_gene,
+          const GeneticEncoding &_source)
+  {
+    if (this->isLayered_)
+    {
+      this->numLayers_ = (std::max)(this->numLayers_,
+                                    static_cast< size_t >(_gene.layerIndex_)
+                                    + 1);
+    }
+    if (&_source == this)
+    {
+      std::vector< NeuronParameter > parameters(
+              this->neuronParams_.begin() + _gene.paramsBegin_,
+              this->neuronParams_.begin() + _gene.paramsBegin_
+              + _gene.numParams_);
+      this->InsertNeuron(_gene, parameters.data());
+    }
+    else
+    {
+      this->InsertNeuron(
+              _gene,
+              _source.neuronParams_.data() + _gene.paramsBegin_);
     }
   }
 
-  std::pair< size_t, size_t > GeneticEncoding::CoordinatesByIndex(
-          const size_t _index)
+  void GeneticEncoding::AddConnection(const ConnectionGene &_connection)
   {
-    size_t layer = 0;
-    size_t in_layer = 0;
-    for (size_t i = 0; i < _index; ++i)
+    auto &connections = this->connectionGenes_.Write();
+    auto ins = std::upper_bound(
+            connections.begin(),
+            connections.end(),
+            _connection,
+            LessInnovation);
+    auto index = static_cast< size_t >(ins - connections.begin());
+    connections.insert(ins, _connection);
+    if (this->indexed_)
     {
-      if (layers_.at(layer).size() == in_layer + 1)
+      Reindex(this->connectionGenes_, index, this->connectionIndex_);
+      this->edges_.emplace(
+              std::make_pair(_connection.from_, _connection.to_),
+              _connection.InnovationNumber());
+    }
+  }
+
+  void GeneticEncoding::ReplaceNeuron(
+          const size_t _index,
+          const NeuronGene &_gene,
+          const GeneticEncoding &_source)
+  {
+    const auto &current = this->neuronGenes_.at(_index);
+    assert(current.InnovationNumber() == _gene.InnovationNumber());
+    auto parameters = _source.neuronParams_.data() + _gene.paramsBegin_;
+    if (SameNeuron(current, _gene))
+    {
+      auto param = this->neuronParams_.data() + current.paramsBegin_;
+      uint32_t p = 0;
+      while (p < _gene.numParams_
+             and param[p].name_ == parameters[p].name_
+             and param[p].value_ == parameters[p].value_)
       {
-        layer++;
-        in_layer = 0;
+        ++p;
       }
-      else
+      if (p == _gene.numParams_)
       {
-        in_layer++;
+        return;
       }
     }
-    return {layer, in_layer};
+
+    NeuronGene gene = _gene;
+    gene.layerIndex_ = current.layerIndex_;
+    gene.paramsBegin_ = current.paramsBegin_;
+    std::vector< NeuronParameter > own;
+    if (&_source == this)
+    {
+      // Writing our parameters may move them
+      own.assign(parameters, parameters + gene.numParams_);
+      parameters = own.data();
+    }
+    auto &params = this->neuronParams_.Write();
+    if (gene.numParams_ not_eq current.numParams_)
+    {
+      // The range can't change size in place, so it moves to the end.
+      gene.paramsBegin_ = static_cast< uint32_t >(params.size());
+      params.resize(params.size() + gene.numParams_);
+    }
+    std::copy(parameters, parameters + gene.numParams_,
+              params.begin() + gene.paramsBegin_);
+    this->neuronGenes_.Write()[_index] = gene;
   }
 
-  std::pair< size_t, size_t > GeneticEncoding::CoordinatesByInnovationNumber(
-          const size_t _innovationNumber)
+  void GeneticEncoding::ReplaceConnection(
+          const size_t _index,
+          const ConnectionGene &_connection)
   {
-    size_t layer = 0, in_layer = 0;
-    while (this->layers_.at(layer).at(in_layer)->InnovationNumber()
-           not_eq _innovationNumber)
+    const auto &current = this->connectionGenes_.at(_index);
+    assert(current.InnovationNumber() == _connection.InnovationNumber());
+    if (current == _connection)
+    {
+      return;
+    }
+    if (this->indexed_ and (current.from_ not_eq _connection.from_
+                            or current.to_ not_eq _connection.to_))
     {
-      assert(this->layers_.at(layer) == nullptr and "A is not equal to B");
-      if (this->layers_.at(layer).size() == in_layer + 1)
+      // The edge moved; rebuild the indexes on the next lookup
+      this->indexed_ = false;
+    }
+    this->connectionGenes_.Write()[_index] = _connection;
+  }
+
+  // ALERT::only works non-layered but seems to be not needed
+  void GeneticEncoding::Adopt(GeneticEncodingPtr adoptee)
+  {
+    // adopt genes that i dont have
+    GeneAlignment neurons(adoptee->neuronGenes_, this->neuronGenes_);
+    for (size_t row = 0; row < neurons.Size(); ++row)
+    {
+      if (neurons.Index(row, 1) == GeneAlignment::NO_GENE)
       {
-        layer++;
-        in_layer = 0;
+        this->AddNeuron(adoptee->neuronGenes_[neurons.Index(row, 0)],
+                        *adoptee);
       }
-      else
+    }
+    GeneAlignment connections(adoptee->connectionGenes_,
+                              this->connectionGenes_);
+    for (size_t row = 0; row < connections.Size(); ++row)
+    {
+      if (connections.Index(row, 1) == GeneAlignment::NO_GENE)
       {
-        in_layer++;
+        this->AddConnection(
+                adoptee->connectionGenes_[connections.Index(row, 0)]);
       }
     }
-    return {layer, in_layer};
   }
 
   GeneticEncodingPtr GeneticEncoding::Copy()
   {
-    if (not this->isLayered_)
+    GeneticEncodingPtr copy_gen(new GeneticEncoding(*this));
+
+    // Parameters of removed neurons, or moved by SetParameter(), are left
+    // behind; don't pass them on.
+    size_t numParams = 0;
+    for (const auto &neuron : this->neuronGenes_)
     {
-      GeneticEncodingPtr copy_gen(new GeneticEncoding(false));
-      for (const auto &neuron_gene : neuronGenes_)
-      {
-        NeuronGenePtr copy_neuron(new NeuronGene(*neuron_gene));
-        copy_gen->AddNeuron(copy_neuron);
-      }
-      for (const auto &connection_gene : connectionGenes_)
+      numParams += neuron.numParams_;
+    }
+    if (numParams not_eq this->neuronParams_.size())
+    {
+      std::vector< NeuronParameter > params;
+      params.reserve(numParams);
+      for (auto &neuron : copy_gen->neuronGenes_.Write())
       {
-        ConnectionGenePtr copy_conn(new ConnectionGene(*connection_gene));
-        copy_gen->AddConnection(copy_conn);
+        auto begin = this->neuronParams_.begin() + neuron.paramsBegin_;
+        neuron.paramsBegin_ = static_cast< uint32_t >(params.size());
+        params.insert(params.end(), begin, begin + neuron.numParams_);
       }
-      return copy_gen;
+      copy_gen->neuronParams_ = GeneArray< NeuronParameter >(
+              std::move(params));
     }
-    else
+    return copy_gen;
+  }
+
+  namespace
+  {
+    /// \brief Counts the genes that only one of the two aligned genotypes
+    /// has, as disjoint when their innovation number is within the range of
+    /// the other genotype and as excess otherwise
+    void CountUnmatched(
+            const GeneAlignment &_alignment,
+            const std::pair< size_t, size_t > &_range1,
+            const std::pair< size_t, size_t > &_range2,
+            int &_excess_num,
+            int &_disjoint_num)
     {
-      GeneticEncodingPtr copy_gen(new GeneticEncoding(true));
-      for (size_t i = 0; i < layers_.size(); i++)
+      for (size_t row = 0; row < _alignment.Size(); ++row)
       {
-        bool first = true;
-        for (const auto &neuron_gene : layers_[i])
+        bool in1 = _alignment.Index(row, 0) not_eq GeneAlignment::NO_GENE;
+        bool in2 = _alignment.Index(row, 1) not_eq GeneAlignment::NO_GENE;
+        if (in1 and in2)
         {
-          if (first)
-          {
-            NeuronGenePtr copy_neuron(new NeuronGene(*neuron_gene));
-            copy_gen->AddNeuron(copy_neuron, i, true);
-            first = false;
-          }
-          else
-          {
-            NeuronGenePtr copy_neuron(new NeuronGene(*neuron_gene));
-            copy_gen->AddNeuron(copy_neuron, i, false);
-          }
+          continue;
+        }
+        const auto &range = in1 ? _range2 : _range1;
+        auto innovation = _alignment.InnovationNumber(row);
+        if (innovation >= range.first and innovation <= range.second)
+        {
+          _disjoint_num++;
+        }
+        else
+        {
+          _excess_num++;
         }
       }
-      for (const auto &connection_gene : connectionGenes_)
-      {
-        ConnectionGenePtr copy_conn(new ConnectionGene(*connection_gene));
-        copy_gen->AddConnection(copy_conn);
-      }
-      return copy_gen;
     }
   }
 
@@ -229,36 +363,35 @@ namespace cppneat
           const double _disjoint_coef,
           const double _weight_diff_coef)
   {
+    auto range1 = _genotype1->RangeInnovationNumbers();
+    auto range2 = _genotype2->RangeInnovationNumbers();
     int excess_num = 0, disjoint_num = 0;
-    GeneticEncoding::ExcessDisjoint(
-            _genotype1,
-            _genotype2,
-            excess_num,
-            disjoint_num);
-    size_t num_genes = (std::max)(
-            _genotype1->NumGenes(),
-            _genotype2->NumGenes());
-    auto pairs = GeneticEncoding::Pair(
-            _genotype1->SortedGenes(),
-            _genotype2->SortedGenes());
+    CountUnmatched(
+            GeneAlignment(_genotype1->neuronGenes_, _genotype2->neuronGenes_),
+            range1, range2, excess_num, disjoint_num);
+
+    // Only connections have a weight
+    const auto &connections1 = _genotype1->connectionGenes_;
+    const auto &connections2 = _genotype2->connectionGenes_;
+    GeneAlignment connections(connections1, connections2);
+    CountUnmatched(connections, range1, range2, excess_num, disjoint_num);
     double weight_diff = 0.0;
     size_t count = 0;
-    for (std::pair< GenePtr, GenePtr > pair : pairs)
+    for (size_t row = 0; row < connections.Size(); ++row)
     {
-      if (pair.first not_eq nullptr and pair.second not_eq nullptr)
+      auto i = connections.Index(row, 0);
+      auto j = connections.Index(row, 1);
+      if (i not_eq GeneAlignment::NO_GENE and j not_eq GeneAlignment::NO_GENE)
       {
-        if (pair.first->type_ == Gene::CONNECTION_GENE
-            and pair.second->type_ == Gene::CONNECTION_GENE)
-        {
-          weight_diff += std::abs(
-                  boost::dynamic_pointer_cast< ConnectionGene >(
-                          pair.first)->weight_
-                  - boost::dynamic_pointer_cast< ConnectionGene >(
-                          pair.second)->weight_);
-          ++count;
-        }
+        weight_diff += std::abs(connections1[i].weight_
+                                - connections2[j].weight_);
+        ++count;
       }
     }
+
+    size_t num_genes = (std::max)(
+            _genotype1->NumGenes(),
+            _genotype2->NumGenes());
     double average_weight_diff = count > 0 ? weight_diff / count : 0;
     double dissimilarity =
             (_disjoint_coef * disjoint_num + _excess_coef * excess_num)
@@ -272,86 +405,35 @@ namespace cppneat
           int &excess_num,
           int &disjoint_num)
   {
-    std::vector< GenePtr > sortedGenes1 = genotype1->SortedGenes();
-    std::vector< GenePtr > sortedGenes2 = genotype2->SortedGenes();
-
-    auto minMark1 = sortedGenes1[0]->InnovationNumber();
-    auto maxMark1 = sortedGenes1[sortedGenes1.size() - 1]->InnovationNumber();
-
-    auto minMark2 = sortedGenes2[0]->InnovationNumber();
-    auto maxMark2 = sortedGenes2[sortedGenes2.size() - 1]->InnovationNumber();
-
-    auto pairs = GeneticEncoding::Pair(
-            sortedGenes1,
-            sortedGenes2);
-
-    for (const auto pair : pairs)
-    {
-      if (pair.first not_eq nullptr and pair.second == nullptr)
-      {
-        if (pair.first->InnovationNumber() > (minMark2 - 1)
-            and pair.first->InnovationNumber() < (maxMark2 + 1))
-        {
-          disjoint_num++;
-        }
-        else
-        {
-          excess_num++;
-        }
-      }
-      else if (pair.first == nullptr and pair.second not_eq nullptr)
-      {
-        if (pair.second->InnovationNumber() > (minMark1 - 1)
-            and pair.second->InnovationNumber() < (maxMark1 + 1))
-        {
-          disjoint_num++;
-        }
-        else
-        {
-          excess_num++;
-        }
-      }
-    }
+    auto range1 = genotype1->RangeInnovationNumbers();
+    auto range2 = genotype2->RangeInnovationNumbers();
+    CountUnmatched(
+            GeneAlignment(genotype1->neuronGenes_, genotype2->neuronGenes_),
+            range1, range2, excess_num, disjoint_num);
+    CountUnmatched(
+            GeneAlignment(genotype1->connectionGenes_,
+                          genotype2->connectionGenes_),
+            range1, range2, excess_num, disjoint_num);
   }
 
   bool GeneticEncoding::ExistingNeuron(const size_t _innovationNumber)
   {
-    if (not this->isLayered_)
-    {
-      for (const auto gene : this->neuronGenes_)
-      {
-        if (gene->InnovationNumber() == _innovationNumber)
-        {
-          return true;
-        }
-      }
-      return false;
-    }
-    else
-    {
-      for (const auto &layer : this->layers_)
-      {
-        for (const auto &neuron_gene : layer)
-        {
-          if (neuron_gene->InnovationNumber() == _innovationNumber)
-          {
-            return true;
-          }
-        }
-      }
-      return false;
-    }
+    this->Index();
+    return this->neuronIndex_.count(_innovationNumber) > 0;
   }
 
   bool GeneticEncoding::ExistingConnection(
           const size_t _from,
           const size_t _to)
   {
-    for (const auto &connection : connectionGenes_)
+    this->Index();
+    // Whether a connection is enabled can change without the genotype
+    // knowing, so that is checked on the gene itself.
+    auto range = this->edges_.equal_range(std::make_pair(_from, _to));
+    for (auto it = range.first; it not_eq range.second; ++it)
     {
-      if ((*connection).from_ == _from
-          and (*connection).to_ == _to
-          and (*connection).IsEnabled())
+      if (this->connectionGenes_[this->connectionIndex_[it->second]]
+              .IsEnabled())
       {
         return true;
       }
@@ -359,344 +441,322 @@ namespace cppneat
     return false;
   }
 
-  GenePtr GeneticEncoding::Find(const size_t _innovationNumber)
+  const NeuronGene *GeneticEncoding::FindNeuron(
+          const size_t _innovationNumber)
   {
-    this->SortedGenes();
-    for (GenePtr gene : this->allSortedGenes_)
-    {
-      if (gene->InnovationNumber() == _innovationNumber)
-      {
-        return gene;
-      }
-    }
-    return nullptr;
+    this->Index();
+    auto it = this->neuronIndex_.find(_innovationNumber);
+    return it == this->neuronIndex_.end()
+           ? nullptr
+           : &this->neuronGenes_[it->second];
   }
 
-  size_t GeneticEncoding::NumConnections()
+  const ConnectionGene *GeneticEncoding::FindConnection(
+          const size_t _innovationNumber)
   {
-    return this->connectionGenes_.size();
+    this->Index();
+    auto it = this->connectionIndex_.find(_innovationNumber);
+    return it == this->connectionIndex_.end()
+           ? nullptr
+           : &this->connectionGenes_[it->second];
   }
 
-  size_t GeneticEncoding::NumGenes()
+  bool GeneticEncoding::EnableConnection(const size_t _innovationNumber)
   {
-    if (not isLayered_)
+    this->Index();
+    auto it = this->connectionIndex_.find(_innovationNumber);
+    if (it == this->connectionIndex_.end())
     {
-      return this->NumNeurons() + this->NumConnections();
+      return false;
     }
-    else
+    if (not this->connectionGenes_[it->second].IsEnabled())
     {
-      size_t sum = 0;
-      for (const auto &layer : layers_)
-      {
-        sum += layer.size();
-      }
-      return sum + this->NumConnections();
+      this->connectionGenes_.Write()[it->second].SetEnabled(true);
     }
+    return true;
   }
 
-  size_t GeneticEncoding::NumNeurons()
+  namespace
   {
-    if (not isLayered_)
+    /// \brief boost::hash_combine followed by the finalizer of MurmurHash3
+    uint64_t HashCombine(
+            uint64_t _hash,
+            const uint64_t _value)
     {
-      return this->NumLayers();
+      _hash ^= _value + 0x9e3779b97f4a7c15ULL + (_hash << 6) + (_hash >> 2);
+      _hash ^= _hash >> 33;
+      _hash *= 0xff51afd7ed558ccdULL;
+      _hash ^= _hash >> 33;
+      _hash *= 0xc4ceb9fe1a85ec53ULL;
+      _hash ^= _hash >> 33;
+      return _hash;
     }
-    else
+
+    uint64_t Quantize(
+            const double _value,
+            const double _quantum)
     {
-      size_t sum = 0;
-      for (const auto &layer : layers_)
+      return static_cast< uint64_t >(std::llround(_value / _quantum));
+    }
+  }
+
+  uint64_t GeneticEncoding::Hash(const double _weightQuantum)
+  {
+    // The parents of the genes don't change the network, so they are left
+    // out. Strings are hashed by their GeneStrings() id, which is the same
+    // for equal strings.
+    uint64_t hash = HashCombine(this->isLayered_, this->NumGenes());
+    for (const auto &neuron : this->neuronGenes_)
+    {
+      hash = HashCombine(hash, neuron.InnovationNumber());
+      hash = HashCombine(hash, neuron.IsEnabled());
+      hash = HashCombine(hash, neuron.neuronId_);
+      hash = HashCombine(hash, neuron.layer_);
+      hash = HashCombine(hash, neuron.neuronType_);
+      hash = HashCombine(hash, neuron.layerIndex_);
+      auto param = this->neuronParams_.begin() + neuron.paramsBegin_;
+      for (uint32_t p = 0; p < neuron.numParams_; ++p, ++param)
       {
-        sum += layer.size();
+        hash = HashCombine(hash, param->name_);
+        hash = HashCombine(hash, Quantize(param->value_, _weightQuantum));
       }
-      return sum;
     }
+    for (const auto &connection : this->connectionGenes_)
+    {
+      hash = HashCombine(hash, connection.InnovationNumber());
+      hash = HashCombine(hash, connection.IsEnabled());
+      hash = HashCombine(hash, connection.from_);
+      hash = HashCombine(hash, connection.to_);
+      hash = HashCombine(hash, connection.socket_);
+      hash = HashCombine(hash, Quantize(connection.weight_, _weightQuantum));
+    }
+    return hash == 0 ? 1 : hash;
   }
 
-  size_t GeneticEncoding::NumLayers()
+  size_t GeneticEncoding::NumConnections()
   {
-    return this->neuronGenes_.size();
+    return this->connectionGenes_.size();
   }
 
-  std::vector< std::pair< GenePtr, GenePtr > > GeneticEncoding::Pair(
-          std::vector< GenePtr > _sortedGenes1,
-          std::vector< GenePtr > _sortedGenes2)
+  size_t GeneticEncoding::NumGenes()
   {
-    auto numGenes1 = _sortedGenes1.size();
-    auto numGenes2 = _sortedGenes2.size();
-
-    auto minMark1 = _sortedGenes1[0]->InnovationNumber();
-    auto maxMark1 =
-            _sortedGenes1[_sortedGenes1.size() - 1]->InnovationNumber();
-
-    auto minMark2 = _sortedGenes2[0]->InnovationNumber();
-    auto maxMark2 =
-            _sortedGenes2[_sortedGenes2.size() - 1]->InnovationNumber();
-
-    auto minMark = (std::min)(minMark1, minMark2);
-    auto maxMark = (std::max)(maxMark1, maxMark2);
+    return this->NumNeurons() + this->NumConnections();
+  }
 
-    std::vector< std::pair< GenePtr, GenePtr>> genePairs;
+  size_t GeneticEncoding::NumNeurons()
+  {
+    return this->neuronGenes_.size();
+  }
 
-    // search for pairs with equal marks
-    size_t start_from1 = 0;
-    size_t start_from2 = 0;
+  size_t GeneticEncoding::NumLayers()
+  {
+    return this->numLayers_;
+  }
 
-    size_t mark = minMark;
+  std::vector< std::vector< size_t > > GeneticEncoding::Layers()
+  {
+    std::vector< std::vector< size_t > > layers(this->numLayers_);
+    for (size_t i = 0; i < this->neuronGenes_.size(); ++i)
+    {
+      layers[this->neuronGenes_[i].layerIndex_].push_back(i);
+    }
+    return layers;
+  }
 
-    while (mark < maxMark + 1)
+  std::map< std::string, double > GeneticEncoding::Parameters(
+          const NeuronGene &_neuron)
+  {
+    std::map< std::string, double > parameters;
+    auto param = this->neuronParams_.begin() + _neuron.paramsBegin_;
+    for (uint32_t p = 0; p < _neuron.numParams_; ++p, ++param)
     {
-      // jump1 and jump2 are here to skip long sequences of empty
-      // historical marks
-      GenePtr gene1 = nullptr;
-      size_t jump1 = mark + 1;
-      for (size_t i = start_from1; i < numGenes1; i++)
-      {
-        if (_sortedGenes1[i]->InnovationNumber() == mark)
-        {
-          gene1 = _sortedGenes1[i];
-          start_from1 = i;
-          break;
-        }
-        else if (_sortedGenes1[i]->InnovationNumber() > mark)
-        { // if there is a gap jump over it
-          jump1 = _sortedGenes1[i]->InnovationNumber();
-          start_from1 = i;
-          break;
-        }
-        else if (i == numGenes1 - 1)
-        { // if the end of the gene sequence is reached
-          jump1 = maxMark + 1;
-          start_from1 = i;
-          break;
-        }
-      }
+      parameters[GeneStrings().lookup(param->name_)] = param->value_;
+    }
+    return parameters;
+  }
 
-      GenePtr gene2 = nullptr;
-      size_t jump2 = mark + 1;
-      for (size_t i = start_from2; i < numGenes2; i++)
+  double GeneticEncoding::Parameter(
+          const NeuronGene &_neuron,
+          const std::string &_name)
+  {
+    auto name = GeneStrings().intern(_name);
+    auto param = this->neuronParams_.begin() + _neuron.paramsBegin_;
+    for (uint32_t p = 0; p < _neuron.numParams_; ++p, ++param)
+    {
+      if (param->name_ == name)
       {
-        if (_sortedGenes2[i]->InnovationNumber() == mark)
-        {
-          gene2 = _sortedGenes2[i];
-          start_from2 = i;
-          break;
-        }
-        else if (_sortedGenes2[i]->InnovationNumber() > mark)
-        { // if there is a gap jump over it
-          jump2 = _sortedGenes2[i]->InnovationNumber();
-          start_from2 = i;
-          break;
-        }
-        else if (i == numGenes2 - 1)
-        { // if the end of the gene sequence is reached
-          jump2 = maxMark + 1;
-          start_from2 = i;
-          break;
-        }
+        return param->value_;
       }
+    }
+    return 0;
+  }
 
-      if (gene1 not_eq nullptr or gene2 not_eq nullptr)
+  void GeneticEncoding::SetParameter(
+          const size_t _index,
+          const std::string &_name,
+          const double _value)
+  {
+    auto name = GeneStrings().intern(_name);
+    NeuronGene neuron = this->neuronGenes_.at(_index);
+    auto param = this->neuronParams_.begin() + neuron.paramsBegin_;
+    for (uint32_t p = 0; p < neuron.numParams_; ++p, ++param)
+    {
+      if (param->name_ == name)
       {
-        genePairs.push_back({gene1, gene2});
+        this->neuronParams_.Write()[neuron.paramsBegin_ + p].value_ = _value;
+        return;
       }
+    }
 
-      mark = std::min(jump1, jump2);
+    // The range can't grow in place, so it moves to the end.
+    auto &params = this->neuronParams_.Write();
+    auto begin = static_cast< uint32_t >(params.size());
+    params.reserve(params.size() + neuron.numParams_ + 1);
+    for (uint32_t p = 0; p < neuron.numParams_; ++p)
+    {
+      params.push_back(params[neuron.paramsBegin_ + p]);
     }
-    return genePairs;
+    params.push_back({name, _value});
+    neuron.paramsBegin_ = begin;
+    ++neuron.numParams_;
+    this->neuronGenes_.Write()[_index] = neuron;
   }
 
   std::pair< size_t, size_t > GeneticEncoding::RangeInnovationNumbers()
   {
-    this->SortedGenes();
-    return {allSortedGenes_[0]->InnovationNumber(),
-            allSortedGenes_[allSortedGenes_.size() - 1]->InnovationNumber()};
+    size_t min = static_cast< size_t >(-1), max = 0;
+    if (not this->neuronGenes_.empty())
+    {
+      min = this->neuronGenes_.front().InnovationNumber();
+      max = this->neuronGenes_.back().InnovationNumber();
+    }
+    if (not this->connectionGenes_.empty())
+    {
+      min = (std::min)(min, this->connectionGenes_.front().InnovationNumber());
+      max = (std::max)(max, this->connectionGenes_.back().InnovationNumber());
+    }
+    return {min, max};
   }
 
   void GeneticEncoding::RemoveNeuron(const size_t _index)
   {
-    GenePtr oldGene = boost::dynamic_pointer_cast< Gene >
-            (this->neuronGenes_.at(_index));
-    this->neuronGenes_.erase(this->neuronGenes_.begin() + _index);
-    auto gene = std::find(
-            this->allSortedGenes_.begin(),
-            this->allSortedGenes_.end(),
-            oldGene);
-    this->allSortedGenes_.erase(gene);
-  }
-
-  void GeneticEncoding::RemoveNeuron(NeuronGenePtr _gene)
-  {
-    auto gene = std::find(
-            this->neuronGenes_.begin(),
-            this->neuronGenes_.end(),
-            _gene);
-    this->neuronGenes_.erase(gene);
-    auto sortedGene = std::find(
-            this->allSortedGenes_.begin(),
-            this->allSortedGenes_.end(),
-            _gene);
-
-    this->allSortedGenes_.erase(sortedGene);
-  }
-
-  void GeneticEncoding::RemoveNeuron(
-          const size_t _layer,
-          const size_t _index)
-  {
-    auto oldGene = boost::dynamic_pointer_cast< Gene >
-            (this->layers_.at(_layer).at(_index));
-    if (this->layers_.at(_layer).size() == 1)
+    auto layer = this->neuronGenes_.at(_index).layerIndex_;
+    if (this->indexed_)
     {
-      this->layers_.erase(layers_.begin() + _layer);
+      this->neuronIndex_.erase(this->neuronGenes_[_index].InnovationNumber());
     }
-    else
+    auto &neurons = this->neuronGenes_.Write();
+    neurons.erase(neurons.begin() + _index);
+    if (this->indexed_)
     {
-      this->layers_.at(_layer).erase(
-              this->layers_.at(_layer).begin() + _index);
+      Reindex(this->neuronGenes_, _index, this->neuronIndex_);
     }
-    auto gene = std::find(
-            this->allSortedGenes_.begin(),
-            this->allSortedGenes_.end(),
-            oldGene);
-    this->allSortedGenes_.erase(gene);
+    if (not this->isLayered_)
+    {
+      return;
+    }
+    for (const auto &neuron : neurons)
+    {
+      if (neuron.layerIndex_ == layer)
+      {
+        return;
+      }
+    }
+    for (auto &neuron : neurons)
+    {
+      if (neuron.layerIndex_ > layer)
+      {
+        --neuron.layerIndex_;
+      }
+    }
+    --this->numLayers_;
   }
 
   void GeneticEncoding::RemoveConnection(const size_t _index)
   {
-    auto old = boost::dynamic_pointer_cast< Gene >(connectionGenes_[_index]);
-    this->connectionGenes_.erase(this->connectionGenes_.begin() + _index);
-    auto it = std::find(
-            this->allSortedGenes_.begin(),
-            this->allSortedGenes_.end(),
-            old);
-    this->allSortedGenes_.erase(it);
-  }
-
-  std::vector< GenePtr > GeneticEncoding::SortedGenes()
-  {
-    if (not all_genes_valid)
+    if (this->indexed_)
     {
-      this->allSortedGenes_.clear();
-      if (not isLayered_)
+      const auto &connection = this->connectionGenes_.at(_index);
+      auto innovation = connection.InnovationNumber();
+      auto range = this->edges_.equal_range(
+              std::make_pair(connection.from_, connection.to_));
+      for (auto it = range.first; it not_eq range.second; ++it)
       {
-        for (const auto &neuron : neuronGenes_)
-        {
-          this->allSortedGenes_.push_back(
-                  boost::dynamic_pointer_cast< Gene >(neuron));
-        }
-        for (const auto &connection : connectionGenes_)
+        if (it->second == innovation)
         {
-          this->allSortedGenes_.push_back(
-                  boost::dynamic_pointer_cast< Gene >(connection));
-        }
-      }
-      else
-      {
-        for (std::vector< NeuronGenePtr > layer : layers_)
-        {
-          for (const auto &neuron : layer)
-          {
-            this->allSortedGenes_.push_back(
-                    boost::dynamic_pointer_cast< Gene >(neuron));
-          }
-        }
-        for (const auto &connection : connectionGenes_)
-        {
-          this->allSortedGenes_.push_back(boost::dynamic_pointer_cast< Gene >(
-                  connection));
+          this->edges_.erase(it);
+          break;
         }
       }
-      std::sort(
-              this->allSortedGenes_.begin(),
-              this->allSortedGenes_.end(),
-              [](
-                      GenePtr _gene1,
-                      GenePtr _gene2)
-              {
-                return _gene1->InnovationNumber() < _gene2->InnovationNumber();
-              });
-      all_genes_valid = true;
+      this->connectionIndex_.erase(innovation);
+    }
+    auto &connections = this->connectionGenes_.Write();
+    connections.erase(connections.begin() + _index);
+    if (this->indexed_)
+    {
+      Reindex(this->connectionGenes_, _index, this->connectionIndex_);
     }
-    return this->allSortedGenes_;
   }
 
   std::vector< std::pair< size_t, size_t > > GeneticEncoding::SpaceMap(
           std::vector< GeneticEncodingPtr > _genotypes,
           std::map< Neuron::Ntype, Neuron::NeuronTypeSpec > _config)
   {
-    std::vector< std::vector< GenePtr>> sortedGenes;
+    std::vector< const GeneArray< NeuronGene > * > neuronGenes;
+    std::vector< const GeneArray< ConnectionGene > * > connectionGenes;
     for (const auto &genotype : _genotypes)
     {
-      sortedGenes.push_back(genotype->SortedGenes());
+      neuronGenes.push_back(&genotype->neuronGenes_);
+      connectionGenes.push_back(&genotype->connectionGenes_);
     }
+    GeneAlignment neurons(neuronGenes);
+    GeneAlignment connections(connectionGenes);
 
-    auto globMinIn = sortedGenes[0][0]->InnovationNumber();
-    auto globMaxIn =
-            sortedGenes[0][sortedGenes.size() - 1]->InnovationNumber();
-
-    for (std::vector< GenePtr > genes : sortedGenes)
+    size_t globMaxIn = 0;
+    if (neurons.Size() > 0)
     {
-      auto minIn = genes.at(0)->InnovationNumber();
-      auto maxIn = genes.at(genes.size() - 1)->InnovationNumber();
-
-      if (minIn < globMinIn)
-      {
-        globMinIn = minIn;
-      }
-      if (maxIn > globMaxIn)
-      {
-        globMaxIn = maxIn;
-      }
+      globMaxIn = neurons.InnovationNumber(neurons.Size() - 1);
+    }
+    if (connections.Size() > 0)
+    {
+      globMaxIn = (std::max)(
+              globMaxIn,
+              connections.InnovationNumber(connections.Size() - 1));
     }
 
+    // Neurons and connections draw from the same innovation numbers, so the
+    // rows of the two alignments interleave.
     std::vector< std::pair< size_t, size_t >> innovationNumbers;
+    innovationNumbers.reserve(globMaxIn + 1);
     // TODO: check of 0 is necessary
-    // TODO: make this faster
+    size_t neuronRow = 0, connectionRow = 0;
     for (size_t inNum = 0; inNum <= globMaxIn; inNum++)
     {
-      GenePtr currentGene = nullptr;
-      for (std::vector< GenePtr > gene_vector : sortedGenes)
+      size_t space = 0;
+      if (connectionRow < connections.Size()
+          and connections.InnovationNumber(connectionRow) == inNum)
       {
-        bool total_break = false;
-        for (const auto &gene : gene_vector)
-        {
-          if (gene->InnovationNumber() == inNum)
-          {
-            currentGene = gene;
-            total_break = true;
-            break;
-          }
-          else if (gene->InnovationNumber() > inNum)
-          {
-            break;
-          }
-        }
-        if (total_break)
-        {
-          break;
-        }
-      }
-      if (currentGene == nullptr)
-      {
-        innovationNumbers.push_back({inNum, 0});
+        space = 1;
+        ++connectionRow;
       }
-      else
+      if (neuronRow < neurons.Size()
+          and neurons.InnovationNumber(neuronRow) == inNum)
       {
-        switch (currentGene->type_)
+        if (space == 0)
         {
-          case Gene::CONNECTION_GENE:
-            innovationNumbers.push_back({inNum, 1});
-            break;
-          case Gene::NEURON_GENE:
-            Neuron::Ntype
-                    neuron_type = boost::dynamic_pointer_cast< NeuronGene >(
-                    currentGene)->neuron_->neuronType_;
-            Neuron::NeuronTypeSpec neuron_spec = _config[neuron_type];
-            innovationNumbers.push_back(
-                    {inNum,
-                     neuron_spec.parameters.size()});
-            break;
+          // The first genotype with the neuron decides its type
+          size_t column = 0;
+          while (neurons.Index(neuronRow, column) == GeneAlignment::NO_GENE)
+          {
+            ++column;
+          }
+          const auto &neuron = _genotypes[column]->neuronGenes_[
+                  neurons.Index(neuronRow, column)];
+          space = _config[neuron.neuronType_].parameters.size();
         }
+        ++neuronRow;
       }
+      innovationNumbers.push_back({inNum, space});
     }
     return innovationNumbers;
   }
@@ -20,47 +20,61 @@
 #ifndef REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENETICENCODING_H_
 #define REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENETICENCODING_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "CPPNTypes.h"
 #include "CPPNNeuron.h"
 #include "ConnectionGenome.h"
+#include "GeneAlignment.h"
+#include "GeneArray.h"
 #include "NeuronGenome.h"
 
 /// \brief class for the encoding of one genotype
 namespace cppneat
 {
+  /// \brief The genes are values in two arrays sorted by innovation number,
+  /// and the neuron parameters are a third array that neuron genes index
+  /// into. A copy shares the three arrays with the original until either
+  /// of them changes one, see GeneArray, and comparing two genotypes is a
+  /// merge of their sorted arrays, see GeneAlignment.
+  ///
+  /// A layered genotype keeps the layer of each neuron in
+  /// NeuronGene::layerIndex_; a non-layered one has all neurons in layer 0.
+  ///
+  /// FindNeuron(), FindConnection(), ExistingNeuron() and
+  /// ExistingConnection() use hash indexes over the genes, which are built
+  /// by the first of them and then kept up to date by the methods that add
+  /// and remove genes. Copies start without them.
   class GeneticEncoding
   {
     public:
     /// \brief
-    GeneticEncoding(
-            std::vector< NeuronGenePtr > neuron_genes,
-            std::vector< ConnectionGenePtr > connection_genes
-    )
-            : neuronGenes_(neuron_genes)
-            , connectionGenes_(connection_genes)
-            , isLayered_(false)
-    {}
-
-    /// \brief
-    GeneticEncoding(
-            std::vector< std::vector< NeuronGenePtr>> layers,
-            std::vector< ConnectionGenePtr > connection_genes
-    )
-            : layers_(layers)
-            , connectionGenes_(connection_genes)
-            , isLayered_(true)
+    explicit GeneticEncoding(bool layered)
+            : isLayered_(layered)
+            , serial_(0)
+            , numLayers_(layered ? 0 : 1)
+            , indexed_(false)
     {}
 
-    /// \brief
-    GeneticEncoding(bool layered)
-            : isLayered_(layered)
+    /// \brief Shares the genes but not the indexes
+    GeneticEncoding(const GeneticEncoding &_other)
+            : neuronGenes_(_other.neuronGenes_)
+            , connectionGenes_(_other.connectionGenes_)
+            , neuronParams_(_other.neuronParams_)
+            , isLayered_(_other.isLayered_)
+            , serial_(0)
+            , numLayers_(_other.numLayers_)
+            , indexed_(false)
     {}
 
-    /// \brief
+    /// \brief Shares the genes, unless parameters were left behind by
+    /// removed neurons or SetParameter(), which the copy drops
     GeneticEncodingPtr Copy();
 
     /// \brief
@@ -75,7 +89,11 @@ namespace cppneat
     /// \brief
     size_t NumLayers();
 
-    /// \brief
+    /// \brief Indices into neuronGenes_ of the neurons of each layer, in
+    /// innovation order. A non-layered genotype has a single layer.
+    std::vector< std::vector< size_t > > Layers();
+
+    /// \brief Whether an enabled connection from _from to _to exists
     bool ExistingConnection(
             const size_t _from,
             const size_t _to);
@@ -95,13 +113,9 @@ namespace cppneat
             int &excess_num,
             int &disjoint_num);
 
-    /// \brief
-    static std::vector< std::pair< GenePtr, GenePtr>>
-    Pair(
-            std::vector< GenePtr > _sortedGenes1,
-            std::vector< GenePtr > _sortedGenes2);
-
-    /// \brief
+    /// \brief For every innovation number up to the highest one in
+    /// _genotypes, the number of values its gene has: 1 for a connection,
+    /// the number of parameters for a neuron and 0 if no genotype has it
     static std::vector< std::pair< size_t, size_t>>
     SpaceMap(
             std::vector< GeneticEncodingPtr > _genotypes,
@@ -110,80 +124,161 @@ namespace cppneat
     /// \brief
     void Adopt(GeneticEncodingPtr adoptee);
 
-    /// \brief
-    std::vector< GenePtr > SortedGenes();
-
     /// \brief
     std::pair< size_t, size_t > RangeInnovationNumbers();
 
-    /// \brief
-    GenePtr Find(const size_t _innovationNumber);
+    /// \brief The neuron gene with _innovationNumber, or nullptr.
+    /// Invalidated by changing the neurons.
+    const NeuronGene *FindNeuron(const size_t _innovationNumber);
+
+    /// \brief The connection gene with _innovationNumber, or nullptr.
+    /// Invalidated by changing the connections.
+    const ConnectionGene *FindConnection(const size_t _innovationNumber);
+
+    /// \brief Enables the connection with _innovationNumber. Returns false
+    /// if there is none.
+    bool EnableConnection(const size_t _innovationNumber);
+
+    /// \brief Hash over the genes sorted by innovation number, with weights
+    /// and neuron parameters rounded to a multiple of _weightQuantum. Equal
+    /// genotypes, such as a copy that no mutation changed, hash the same.
+    /// Never 0.
+    uint64_t Hash(const double _weightQuantum);
+
+    /// \brief The parameters of _neuron, which has to be a gene of this
+    /// genotype
+    std::map< std::string, double > Parameters(const NeuronGene &_neuron);
+
+    /// \brief A parameter of _neuron, 0 if it has none by that name
+    double Parameter(
+            const NeuronGene &_neuron,
+            const std::string &_name);
+
+    /// \brief Sets a parameter of neuronGenes_[_index], adding it if
+    /// necessary
+    void SetParameter(
+            const size_t _index,
+            const std::string &_name,
+            const double _value);
 
     /// \brief non-layered
-    void AddNeuron(NeuronGenePtr _neuron);
+    void AddNeuron(
+            const Neuron &_neuron,
+            const Gene &_gene);
 
     /// \brief layered
     void AddNeuron(
-            NeuronGenePtr _neuron,
+            const Neuron &_neuron,
+            const Gene &_gene,
             const size_t _layer,
             const bool _newLayer);
 
+    /// \brief Adds a copy of _gene of _source, with its parameters, in
+    /// layer _gene.layerIndex_
+    void AddNeuron(
+            const NeuronGene &_gene,
+            const GeneticEncoding &_source);
+
     /// \brief
-    void AddConnection(ConnectionGenePtr _connection);
+    void AddConnection(const ConnectionGene &_connection);
+
+    /// \brief Replaces neuronGenes_[_index] by _gene of _source, with its
+    /// parameters, keeping the layer. _gene needs the same innovation
+    /// number. Nothing is written if the two are equal.
+    void ReplaceNeuron(
+            const size_t _index,
+            const NeuronGene &_gene,
+            const GeneticEncoding &_source);
+
+    /// \brief Replaces connectionGenes_[_index] by _connection, which needs
+    /// the same innovation number. Nothing is written if the two are equal.
+    void ReplaceConnection(
+            const size_t _index,
+            const ConnectionGene &_connection);
 
     /// \brief
     void RemoveConnection(const size_t _index);
 
-    /// \brief non-layered
+    /// \brief Removes neuronGenes_[_index], and its layer if it was the
+    /// last neuron in it
     void RemoveNeuron(const size_t _index);
 
-    /// \brief
-    void RemoveNeuron(NeuronGenePtr _gene);
-
-    /// \brief layered
-    void RemoveNeuron(
-            const size_t _layer,
-            const size_t _index);
-
     /// \brief
     bool ExistingNeuron(const size_t _innovationNumber);
 
+    /// \brief Builds the lookup indexes now, unless they are up to date,
+    /// instead of in the first lookup. Lets a worker thread do it for a new
+    /// genotype.
+    void Index();
+
 #ifdef CPPNEAT_DEBUG
     bool is_valid();
 #endif
 
-    /// \brief
-    std::pair< size_t, size_t > CoordinatesByIndex(const size_t _index);
-
-    /// \brief
-    std::pair< size_t, size_t >
-    CoordinatesByInnovationNumber(const size_t _innovationNumber);
-
-    public:
-    /// \brief non-layered
     public:
-    /// \brief
-    std::vector< NeuronGenePtr > neuronGenes_;
+    /// \brief both, sorted by innovation number. Add and remove genes only
+    /// through the methods above.
+    GeneArray< NeuronGene > neuronGenes_;
 
     public:
-    /// \brief layered
-    std::vector< std::vector< NeuronGenePtr>> layers_;
+    /// \brief both, sorted by innovation number
+    GeneArray< ConnectionGene > connectionGenes_;
 
     public:
-    /// \brief both
-    std::vector< ConnectionGenePtr > connectionGenes_;
+    /// \brief Parameters of all neuron genes, see NeuronGene
+    GeneArray< NeuronParameter > neuronParams_;
 
     public:
     /// \brief
     bool isLayered_;
 
+    public:
+    /// \brief Number given by NEATLearner in the order it creates genotypes,
+    /// so that they are ordered independently of their addresses; 0 before
+    /// that and in copies
+    size_t serial_;
+
     private:
-    /// \brief
-    std::vector< GenePtr > allSortedGenes_;
+    /// \brief Inserts _gene in innovation order, with _parameters
+    void InsertNeuron(
+            NeuronGene _gene,
+            const NeuronParameter *_parameters);
+
+    /// \brief Updates the index entries of _genes from _begin on, after an
+    /// insertion or removal there
+    template < typename Genes >
+    static void Reindex(
+            const Genes &_genes,
+            const size_t _begin,
+            std::unordered_map< size_t, size_t > &_index);
 
     private:
     /// \brief
-    bool all_genes_valid;
+    size_t numLayers_;
+
+    /// \brief Hashes a (from, to) pair of neuron innovation numbers
+    struct EdgeHash
+    {
+      size_t operator()(const std::pair< size_t, size_t > &_edge) const
+      {
+        return std::hash< size_t >()(_edge.first * 0x9e3779b97f4a7c15ULL
+                                     ^ _edge.second);
+      }
+    };
+
+    /// \brief Whether the indexes below match the genes
+    bool indexed_;
+
+    /// \brief Innovation number to index in neuronGenes_
+    std::unordered_map< size_t, size_t > neuronIndex_;
+
+    /// \brief Innovation number to index in connectionGenes_
+    std::unordered_map< size_t, size_t > connectionIndex_;
+
+    /// \brief (from, to) to the innovation numbers of the connections
+    /// between them, enabled or not
+    std::unordered_multimap< std::pair< size_t, size_t >, size_t, EdgeHash >
+            edges_;
   };
 }
 
@@ -0,0 +1,671 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Binary and YAML files of genotypes
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "GeneticEncodingFile.h"
+
+namespace cppneat
+{
+  namespace
+  {
+    const char MAGIC[8] = {'C', 'P', 'P', 'N', 'E', 'A', 'T', 'G'};
+
+    // All records have a fixed layout and 8-byte alignment, so a mapped file
+    // can be read in place.
+    struct FileHeader
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t nstrings;
+      uint64_t ngenotypes;
+    };
+
+    struct GenotypeRecord
+    {
+      uint8_t layered;
+      uint8_t pad[3];
+      uint32_t nlayers;
+      uint64_t nneurons;
+      uint64_t nparams;
+      uint64_t nconnections;
+    };
+
+    struct NeuronRecord
+    {
+      uint64_t innovation;
+      int32_t parent_index;
+      uint32_t parent_name;
+      uint32_t neuron_id;
+      uint32_t layer;
+      uint32_t type;
+      uint32_t nparams;
+      uint8_t enabled;
+      uint8_t pad[7];
+    };
+
+    struct ParamRecord
+    {
+      uint32_t name;
+      uint32_t pad;
+      double value;
+    };
+
+    struct ConnectionRecord
+    {
+      uint64_t innovation;
+      uint64_t to;
+      uint64_t from;
+      double weight;
+      int32_t parent_index;
+      uint32_t parent_name;
+      uint32_t socket;
+      uint8_t enabled;
+      uint8_t pad[3];
+    };
+
+    static_assert(sizeof(GenotypeRecord) % 8 == 0
+                  and sizeof(NeuronRecord) % 8 == 0
+                  and sizeof(ParamRecord) % 8 == 0
+                  and sizeof(ConnectionRecord) % 8 == 0,
+                  "records must keep 8-byte alignment");
+
+    bool IsLittleEndian()
+    {
+      const uint16_t probe = 1;
+      return *reinterpret_cast< const uint8_t * >(&probe) == 1;
+    }
+
+    size_t Padding(size_t _offset)
+    {
+      return (8 - (_offset % 8)) % 8;
+    }
+
+    /// \brief Assigns each distinct string a small index
+    class StringIndex
+    {
+      public:
+      uint32_t operator()(const std::string &_string)
+      {
+        auto it = this->ids_.find(_string);
+        if (it not_eq this->ids_.end())
+        {
+          return it->second;
+        }
+        uint32_t id = static_cast< uint32_t >(this->strings_.size());
+        this->ids_.emplace(_string, id);
+        this->strings_.push_back(_string);
+        return id;
+      }
+
+      const std::vector< std::string > &Strings() const
+      {
+        return this->strings_;
+      }
+
+      private:
+      std::unordered_map< std::string, uint32_t > ids_;
+
+      std::vector< std::string > strings_;
+    };
+
+    /// \brief Bounds checked cursor over a mapped file
+    class Cursor
+    {
+      public:
+      Cursor(
+              const char *_data,
+              size_t _size)
+              : data_(_data)
+              , size_(_size)
+              , offset_(0)
+      {}
+
+      template < typename T >
+      const T *Take(size_t _n = 1)
+      {
+        if (_n > (this->size_ - this->offset_) / sizeof(T))
+        {
+          return nullptr;
+        }
+        const T *items = reinterpret_cast< const T * >(
+                this->data_ + this->offset_);
+        this->offset_ += _n * sizeof(T);
+        return items;
+      }
+
+      bool Align()
+      {
+        size_t pad = Padding(this->offset_);
+        if (pad > this->size_ - this->offset_)
+        {
+          return false;
+        }
+        this->offset_ += pad;
+        return true;
+      }
+
+      private:
+      const char *data_;
+
+      size_t size_;
+
+      size_t offset_;
+    };
+
+    /// \brief Read-only private mapping of a whole file
+    class MappedFile
+    {
+      public:
+      MappedFile()
+              : data_(nullptr)
+              , size_(0)
+      {}
+
+      ~MappedFile()
+      {
+        if (this->data_ not_eq nullptr)
+        {
+          munmap(this->data_, this->size_);
+        }
+      }
+
+      bool Open(const std::string &_path)
+      {
+        int fd = open(_path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+          return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) not_eq 0 or st.st_size == 0)
+        {
+          close(fd);
+          return false;
+        }
+        this->size_ = static_cast< size_t >(st.st_size);
+        void *data = mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+          return false;
+        }
+        this->data_ = data;
+        return true;
+      }
+
+      const char *Data() const
+      {
+        return static_cast< const char * >(this->data_);
+      }
+
+      size_t Size() const
+      {
+        return this->size_;
+      }
+
+      private:
+      MappedFile(const MappedFile &);
+
+      MappedFile &operator=(const MappedFile &);
+
+      void *data_;
+
+      size_t size_;
+    };
+  }
+
+  /////////////////////////////////////////////////
+  bool GeneticEncodingFile::Save(
+          const std::string &_path,
+          const std::vector< GeneticEncodingPtr > &_genotypes)
+  {
+    if (not IsLittleEndian())
+    {
+      std::cerr << "Binary genotype files are little-endian only" << std::endl;
+      return false;
+    }
+
+    // Strings are referenced by index, so the table has to be complete before
+    // it is written; build all records up front.
+    StringIndex strings;
+    std::vector< GenotypeRecord > genotypes;
+    std::vector< uint32_t > layerSizes;
+    std::vector< NeuronRecord > neurons;
+    std::vector< ParamRecord > params;
+    std::vector< ConnectionRecord > connections;
+
+    for (const auto &genotype : _genotypes)
+    {
+      GenotypeRecord record;
+      std::memset(&record, 0, sizeof(record));
+      record.layered = genotype->isLayered_ ? 1 : 0;
+
+      for (const auto &layer : genotype->Layers())
+      {
+        layerSizes.push_back(static_cast< uint32_t >(layer.size()));
+        record.nlayers++;
+        for (const auto index : layer)
+        {
+          const NeuronGene &gene = genotype->neuronGenes_[index];
+          NeuronRecord nr;
+          std::memset(&nr, 0, sizeof(nr));
+          nr.innovation = gene.InnovationNumber();
+          nr.parent_index = gene.ParentsIndex();
+          nr.parent_name = strings(gene.ParentsName());
+          nr.neuron_id = strings(gene.NeuronId());
+          nr.layer = static_cast< uint32_t >(gene.layer_);
+          nr.type = static_cast< uint32_t >(gene.neuronType_);
+          nr.nparams = gene.numParams_;
+          nr.enabled = gene.IsEnabled() ? 1 : 0;
+          neurons.push_back(nr);
+          record.nneurons++;
+
+          for (uint32_t p = 0; p < gene.numParams_; ++p)
+          {
+            const NeuronParameter &param =
+                    genotype->neuronParams_[gene.paramsBegin_ + p];
+            ParamRecord pr;
+            std::memset(&pr, 0, sizeof(pr));
+            pr.name = strings(GeneStrings().lookup(param.name_));
+            pr.value = param.value_;
+            params.push_back(pr);
+            record.nparams++;
+          }
+        }
+      }
+
+      for (const auto &gene : genotype->connectionGenes_)
+      {
+        ConnectionRecord cr;
+        std::memset(&cr, 0, sizeof(cr));
+        cr.innovation = gene.InnovationNumber();
+        cr.to = gene.to_;
+        cr.from = gene.from_;
+        cr.weight = gene.weight_;
+        cr.parent_index = gene.ParentsIndex();
+        cr.parent_name = strings(gene.ParentsName());
+        cr.socket = strings(gene.Socket());
+        cr.enabled = gene.IsEnabled() ? 1 : 0;
+        connections.push_back(cr);
+        record.nconnections++;
+      }
+
+      genotypes.push_back(record);
+    }
+
+    std::ofstream out(_path, std::ios::binary | std::ios::trunc);
+    if (not out)
+    {
+      std::cerr << "Could not open " << _path << " for writing" << std::endl;
+      return false;
+    }
+
+    size_t offset = 0;
+    auto write = [&out, &offset](const void *_data, size_t _size)
+    {
+      out.write(static_cast< const char * >(_data), _size);
+      offset += _size;
+    };
+    auto align = [&write, &offset]()
+    {
+      static const char zeros[8] = {0};
+      write(zeros, Padding(offset));
+    };
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nstrings = static_cast< uint32_t >(strings.Strings().size());
+    header.ngenotypes = genotypes.size();
+    write(&header, sizeof(header));
+
+    for (const auto &string : strings.Strings())
+    {
+      uint32_t length = static_cast< uint32_t >(string.size());
+      write(&length, sizeof(length));
+      write(string.data(), length);
+    }
+
+    const uint32_t *layerSize = layerSizes.data();
+    const NeuronRecord *neuron = neurons.data();
+    const ParamRecord *param = params.data();
+    const ConnectionRecord *connection = connections.data();
+    for (const auto &record : genotypes)
+    {
+      align();
+      write(&record, sizeof(record));
+      write(layerSize, record.nlayers * sizeof(uint32_t));
+      align();
+      write(neuron, record.nneurons * sizeof(NeuronRecord));
+      write(param, record.nparams * sizeof(ParamRecord));
+      write(connection, record.nconnections * sizeof(ConnectionRecord));
+
+      layerSize += record.nlayers;
+      neuron += record.nneurons;
+      param += record.nparams;
+      connection += record.nconnections;
+    }
+
+    return static_cast< bool >(out);
+  }
+
+  /////////////////////////////////////////////////
+  bool GeneticEncodingFile::Load(
+          const std::string &_path,
+          std::vector< GeneticEncodingPtr > &_genotypes)
+  {
+    MappedFile file;
+    if (not file.Open(_path))
+    {
+      std::cerr << "Could not map " << _path << std::endl;
+      return false;
+    }
+
+    Cursor cursor(file.Data(), file.Size());
+    const FileHeader *header = cursor.Take< FileHeader >();
+    if (header == nullptr
+        or std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) not_eq 0)
+    {
+      std::cerr << _path << " is not a genotype file" << std::endl;
+      return false;
+    }
+    if (header->version not_eq VERSION)
+    {
+      std::cerr << _path << " has version " << header->version
+                << ", expected " << VERSION << std::endl;
+      return false;
+    }
+    if (not IsLittleEndian())
+    {
+      std::cerr << "Binary genotype files are little-endian only" << std::endl;
+      return false;
+    }
+
+    std::vector< std::string > strings;
+    strings.reserve(header->nstrings);
+    for (uint32_t i = 0; i < header->nstrings; i++)
+    {
+      const uint32_t *length = cursor.Take< uint32_t >();
+      const char *chars = length ? cursor.Take< char >(*length) : nullptr;
+      if (chars == nullptr)
+      {
+        std::cerr << _path << " is truncated" << std::endl;
+        return false;
+      }
+      strings.emplace_back(chars, *length);
+    }
+    auto string = [&strings](uint32_t _id) -> const std::string &
+    {
+      static const std::string empty;
+      return _id < strings.size() ? strings[_id] : empty;
+    };
+
+    std::vector< GeneticEncodingPtr > loaded;
+    loaded.reserve(header->ngenotypes);
+    for (uint64_t g = 0; g < header->ngenotypes; g++)
+    {
+      const GenotypeRecord *record = nullptr;
+      const uint32_t *layerSizes = nullptr;
+      const NeuronRecord *neurons = nullptr;
+      const ParamRecord *params = nullptr;
+      const ConnectionRecord *connections = nullptr;
+      if (cursor.Align())
+      {
+        record = cursor.Take< GenotypeRecord >();
+      }
+      if (record not_eq nullptr)
+      {
+        layerSizes = cursor.Take< uint32_t >(record->nlayers);
+      }
+      if (layerSizes not_eq nullptr and cursor.Align())
+      {
+        neurons = cursor.Take< NeuronRecord >(record->nneurons);
+        params = cursor.Take< ParamRecord >(record->nparams);
+        connections = cursor.Take< ConnectionRecord >(record->nconnections);
+      }
+      if (neurons == nullptr or params == nullptr or connections == nullptr)
+      {
+        std::cerr << _path << " is truncated" << std::endl;
+        return false;
+      }
+
+      GeneticEncodingPtr genotype(new GeneticEncoding(record->layered));
+      const NeuronRecord *neuron = neurons;
+      const NeuronRecord *neuronsEnd = neurons + record->nneurons;
+      const ParamRecord *param = params;
+      const ParamRecord *paramsEnd = params + record->nparams;
+      for (uint32_t l = 0; l < record->nlayers; l++)
+      {
+        for (uint32_t n = 0; n < layerSizes[l]; n++, neuron++)
+        {
+          if (neuron == neuronsEnd
+              or neuron->nparams > static_cast< size_t >(paramsEnd - param))
+          {
+            std::cerr << _path << " is corrupt" << std::endl;
+            return false;
+          }
+          std::map< std::string, double > parameters;
+          for (uint32_t p = 0; p < neuron->nparams; p++, param++)
+          {
+            parameters.emplace_hint(parameters.end(),
+                                    string(param->name),
+                                    param->value);
+          }
+          Neuron newNeuron(
+                  string(neuron->neuron_id),
+                  static_cast< Neuron::Layer >(neuron->layer),
+                  static_cast< Neuron::Ntype >(neuron->type),
+                  parameters);
+          Gene gene(
+                  neuron->innovation,
+                  neuron->enabled not_eq 0,
+                  string(neuron->parent_name),
+                  neuron->parent_index);
+          if (record->layered)
+          {
+            genotype->AddNeuron(newNeuron, gene, l, n == 0);
+          }
+          else
+          {
+            genotype->AddNeuron(newNeuron, gene);
+          }
+        }
+      }
+
+      genotype->connectionGenes_.Write().reserve(record->nconnections);
+      for (uint64_t c = 0; c < record->nconnections; c++)
+      {
+        const ConnectionRecord &connection = connections[c];
+        genotype->AddConnection(ConnectionGene(
+                connection.to,
+                connection.from,
+                connection.weight,
+                connection.innovation,
+                connection.enabled not_eq 0,
+                string(connection.parent_name),
+                connection.parent_index,
+                string(connection.socket)));
+      }
+
+      loaded.push_back(genotype);
+    }
+
+    _genotypes.insert(_genotypes.end(), loaded.begin(), loaded.end());
+    return true;
+  }
+
+  /////////////////////////////////////////////////
+  bool GeneticEncodingFile::SaveYaml(
+          const std::string &_path,
+          const std::vector< GeneticEncodingPtr > &_genotypes)
+  {
+    std::ofstream out(_path, std::ios::trunc);
+    if (not out)
+    {
+      std::cerr << "Could not open " << _path << " for writing" << std::endl;
+      return false;
+    }
+    out.precision(std::numeric_limits< double >::max_digits10);
+
+    // Same layout as NEATLearner::RecordGenome(); every connection is keyed
+    // "con_1", which is what NEATLearner::YamlBrains() reads back.
+    for (size_t g = 0; g < _genotypes.size(); g++)
+    {
+      const GeneticEncodingPtr &genotype = _genotypes[g];
+      out << "- evaluation: " << g << std::endl;
+      out << "  brain:" << std::endl;
+      out << "    connection_genes:" << std::endl;
+      for (const auto &connection : genotype->connectionGenes_)
+      {
+        out << "      - con_1:" << std::endl;
+        out << "            in_no: " << connection.InnovationNumber()
+            << std::endl;
+        out << "            from: " << connection.from_ << std::endl;
+        out << "            to: " << connection.to_ << std::endl;
+        out << "            weight: " << connection.weight_ << std::endl;
+        out << "            parent_name: " << connection.ParentsName()
+            << std::endl;
+        out << "            parent_index: " << connection.ParentsIndex()
+            << std::endl;
+      }
+      out << "    layers:" << std::endl;
+      int nlayer = 1;
+      for (const auto &layer : genotype->Layers())
+      {
+        out << "      - layer_" << nlayer++ << ":" << std::endl;
+        for (const auto index : layer)
+        {
+          const NeuronGene &gene = genotype->neuronGenes_[index];
+          out << "          - nid: " << gene.NeuronId() << std::endl;
+          out << "            ntype: " << gene.neuronType_ << std::endl;
+          out << "            nlayer: " << gene.layer_ << std::endl;
+          out << "            in_no: " << gene.InnovationNumber() << std::endl;
+          out << "            parent_name: " << gene.ParentsName()
+              << std::endl;
+          out << "            parent_index: " << gene.ParentsIndex()
+              << std::endl;
+          out << "            params:" << std::endl;
+          for (const auto &param : genotype->Parameters(gene))
+          {
+            out << "              " << param.first << ": " << param.second
+                << std::endl;
+          }
+        }
+      }
+    }
+
+    return static_cast< bool >(out);
+  }
+
+  /////////////////////////////////////////////////
+  bool GeneticEncodingFile::LoadYaml(
+          const std::string &_path,
+          std::vector< GeneticEncodingPtr > &_genotypes)
+  {
+    YAML::Node policy;
+    try
+    {
+      policy = YAML::LoadFile(_path);
+    }
+    catch (const YAML::Exception &e)
+    {
+      std::cerr << "Could not load " << _path << ": " << e.what() << std::endl;
+      return false;
+    }
+
+    auto text = [](const YAML::Node &_node) -> std::string
+    {
+      return _node.IsDefined() and not _node.IsNull()
+             ? _node.as< std::string >() : std::string();
+    };
+
+    // Policies are always recorded as layered genotypes. Innovation numbers
+    // are kept as they are; use NEATLearner::YamlBrains() to renumber them
+    // into a running population.
+    for (size_t g = 0; g < policy.size(); g++)
+    {
+      YAML::Node brain = policy[g]["brain"];
+
+      GeneticEncodingPtr genotype(new GeneticEncoding(true));
+      YAML::Node layersNode = brain["layers"];
+      for (size_t l = 0; l < layersNode.size(); l++)
+      {
+        YAML::Node layer = layersNode[l]["layer_" + std::to_string(l + 1)];
+        for (size_t n = 0; n < layer.size(); n++)
+        {
+          YAML::Node node = layer[n];
+          std::map< std::string, double > parameters;
+          for (const auto &param : node["params"])
+          {
+            parameters[param.first.as< std::string >()] =
+                    param.second.as< double >();
+          }
+          Neuron neuron(
+                  text(node["nid"]),
+                  static_cast< Neuron::Layer >(node["nlayer"].as< size_t >()),
+                  static_cast< Neuron::Ntype >(node["ntype"].as< size_t >()),
+                  parameters);
+          genotype->AddNeuron(
+                  neuron,
+                  Gene(node["in_no"].as< size_t >(),
+                       true,
+                       text(node["parent_name"]),
+                       node["parent_index"].as< int >()),
+                  l,
+                  n == 0);
+        }
+      }
+
+      YAML::Node connectionsNode = brain["connection_genes"];
+      for (size_t c = 0; c < connectionsNode.size(); c++)
+      {
+        YAML::Node connection = connectionsNode[c]["con_1"];
+        genotype->AddConnection(ConnectionGene(
+                connection["to"].as< size_t >(),
+                connection["from"].as< size_t >(),
+                connection["weight"].as< double >(),
+                connection["in_no"].as< size_t >(),
+                true,
+                text(connection["parent_name"]),
+                connection["parent_index"].as< int >()));
+      }
+
+      _genotypes.push_back(genotype);
+    }
+
+    return true;
+  }
+}
@@ -0,0 +1,72 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Binary and YAML files of genotypes
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENETICENCODINGFILE_H_
+#define REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENETICENCODINGFILE_H_
+
+#include <string>
+#include <vector>
+
+#include "GeneticEncoding.h"
+
+namespace cppneat
+{
+  /// \brief Reads and writes populations of genotypes.
+  ///
+  /// The binary format is versioned and little-endian:
+  ///
+  ///   header      magic "CPPNEATG", version, number of strings and genotypes
+  ///   strings     every neuron id, parameter name, parent name and socket,
+  ///               stored once and referenced by index
+  ///   genotypes   per genotype a record with its counts, followed by
+  ///               fixed-size neuron, parameter and connection records
+  ///
+  /// Files are read through mmap and the records are used in place; the
+  /// only work left is creating the gene objects themselves.
+  ///
+  /// The YAML format is the one written by NEATLearner::RecordGenome(),
+  /// so .policy files can be converted in both directions.
+  class GeneticEncodingFile
+  {
+    public:
+    static const uint32_t VERSION = 1;
+
+    /// \brief Writes _genotypes to _path in the binary format
+    static bool Save(
+            const std::string &_path,
+            const std::vector< GeneticEncodingPtr > &_genotypes);
+
+    /// \brief Appends the genotypes in binary file _path to _genotypes
+    static bool Load(
+            const std::string &_path,
+            std::vector< GeneticEncodingPtr > &_genotypes);
+
+    /// \brief Writes _genotypes to _path in the .policy YAML format
+    static bool SaveYaml(
+            const std::string &_path,
+            const std::vector< GeneticEncodingPtr > &_genotypes);
+
+    /// \brief Appends the genotypes in .policy file _path to _genotypes
+    static bool LoadYaml(
+            const std::string &_path,
+            std::vector< GeneticEncodingPtr > &_genotypes);
+  };
+}
+
+#endif  //  REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENETICENCODINGFILE_H_
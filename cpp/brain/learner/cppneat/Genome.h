@@ -20,70 +20,84 @@
 #ifndef REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENEOME_H_
 #define REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_GENEOME_H_
 
+#include <cstdint>
 #include <string>
 
+#include "util/stringtable.h"
+
 namespace cppneat
 {
+  /// \brief Neuron ids, parent names, sockets and parameter names of the
+  /// genes, which refer to them by id so that they stay trivially copyable
+  inline NEAT::StringTable &GeneStrings()
+  {
+    static NEAT::StringTable strings;
+    return strings;
+  }
+
+  /// \brief Meta information shared by neuron and connection genes. Genes
+  /// are plain values stored in arrays of their GeneticEncoding, so this
+  /// holds no pointers and the parents name is an id in GeneStrings().
   class Gene
   {
     public:
-    enum GeneType
-    {
-      NEURON_GENE,
-      CONNECTION_GENE
-    };
-
     Gene(
             const size_t _innovationNumber = 0,
             bool _enabled = true,
-            std::string _name = "",
+            const std::string &_name = "",
             int _index = -1
     )
             : innovationNumber_(_innovationNumber)
-            , isEnabled_(_enabled)
-            , parentsName_(_name)
             , parentsIndex_(_index)
+            , parentsName_(GeneStrings().intern(_name))
+            , isEnabled_(_enabled)
     {
     }
 
-    virtual inline size_t InnovationNumber()
+    inline size_t InnovationNumber() const
     {
       return this->innovationNumber_;
     }
 
-    virtual inline bool IsEnabled()
+    inline bool IsEnabled() const
     {
       return this->isEnabled_;
     }
 
-    virtual inline void SetEnabled(bool enabled)
+    inline void SetEnabled(bool enabled)
     {
       this->isEnabled_ = enabled;
     }
 
-    virtual inline std::string ParentsName()
+    inline const std::string &ParentsName() const
     {
-      return this->parentsName_;
+      return GeneStrings().lookup(this->parentsName_);
     }
 
-    virtual inline int ParentsIndex()
+    inline int ParentsIndex() const
     {
       return this->parentsIndex_;
     }
 
-    GeneType type_;
+    inline bool operator==(const Gene &_other) const
+    {
+      return this->innovationNumber_ == _other.innovationNumber_
+             and this->parentsIndex_ == _other.parentsIndex_
+             and this->parentsName_ == _other.parentsName_
+             and this->isEnabled_ == _other.isEnabled_;
+    }
 
     private:
     size_t innovationNumber_;
 
     private:
-    bool isEnabled_;
+    int32_t parentsIndex_;
 
     private:
-    std::string parentsName_;
+    NEAT::StringTable::id_t parentsName_;
 
     private:
-    int parentsIndex_;
+    bool isEnabled_;
   };
 }
 
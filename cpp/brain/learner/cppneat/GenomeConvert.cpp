@@ -0,0 +1,59 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Converts .policy files to binary genotype files and back
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "GeneticEncodingFile.h"
+
+using namespace cppneat;
+
+int main(
+        int argc,
+        char *argv[])
+{
+  std::string mode = argc == 4 ? argv[1] : "";
+  if (mode not_eq "to-binary" and mode not_eq "to-yaml")
+  {
+    std::cerr << "usage: " << argv[0] << " to-binary IN.policy OUT"
+              << std::endl
+              << "       " << argv[0] << " to-yaml IN OUT.policy" << std::endl;
+    return 1;
+  }
+
+  std::vector< GeneticEncodingPtr > genotypes;
+  bool ok;
+  if (mode == "to-binary")
+  {
+    ok = GeneticEncodingFile::LoadYaml(argv[2], genotypes)
+         and GeneticEncodingFile::Save(argv[3], genotypes);
+  }
+  else
+  {
+    ok = GeneticEncodingFile::Load(argv[2], genotypes)
+         and GeneticEncodingFile::SaveYaml(argv[3], genotypes);
+  }
+
+  if (ok)
+  {
+    std::cout << "Converted " << genotypes.size() << " genotypes" << std::endl;
+  }
+  return ok ? 0 : 1;
+}
@@ -20,7 +20,9 @@
 #ifndef REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_NEURONGENOME_H_
 #define REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_NEURONGENOME_H_
 
+#include <cstdint>
 #include <string>
+#include <type_traits>
 
 #include "Genome.h"
 #include "CPPNNeuron.h"
@@ -28,37 +30,64 @@
 
 namespace cppneat
 {
+  /// \brief One parameter of a neuron gene, stored in the parameter array of
+  /// the GeneticEncoding
+  struct NeuronParameter
+  {
+    /// \brief GeneStrings() id of the name
+    NEAT::StringTable::id_t name_;
+
+    double value_;
+  };
+
+  /// \brief A neuron gene. Its parameters are the range [paramsBegin_,
+  /// paramsBegin_ + numParams_) of GeneticEncoding::neuronParams_.
   class NeuronGene
           : public Gene
   {
     public:
-    NeuronGene(NeuronPtr _neuron,
-               size_t _innovationNumber = 0,
-               bool _enabled = true,
-               std::string _parentsName = "",
-               int _parentsIndex = -1
-    )
-            : Gene(_innovationNumber,
-                   _enabled,
-                   _parentsName,
-                   _parentsIndex)
-            , neuron_(_neuron)
+    /// \brief Without parameters; GeneticEncoding::AddNeuron() stores them
+    NeuronGene(
+            const Neuron &_neuron,
+            const Gene &_gene)
+            : Gene(_gene)
+            , neuronId_(GeneStrings().intern(_neuron.neuronId_))
+            , layer_(_neuron.layer_)
+            , neuronType_(_neuron.neuronType_)
+            , layerIndex_(0)
+            , paramsBegin_(0)
+            , numParams_(0)
     {
-      this->type_ = Gene::NEURON_GENE;
     }
 
-    NeuronGene(NeuronGene &_copy)
-            : Gene(_copy.InnovationNumber(),
-                   _copy.IsEnabled(),
-                   _copy.ParentsName(),
-                   _copy.ParentsIndex())
-            , neuron_(NeuronPtr(new Neuron(*(_copy.neuron_))))
+    /// \brief
+    inline const std::string &NeuronId() const
     {
-      this->type_ = Gene::NEURON_GENE;
+      return GeneStrings().lookup(this->neuronId_);
     }
 
-    public: NeuronPtr neuron_;
+    /// \brief GeneStrings() id of the neuron id
+    public: NEAT::StringTable::id_t neuronId_;
+
+    /// \brief
+    public: Neuron::Layer layer_;
+
+    /// \brief
+    public: Neuron::Ntype neuronType_;
+
+    /// \brief Layer of a layered genotype the neuron is in, 0 otherwise
+    public: uint32_t layerIndex_;
+
+    /// \brief
+    public: uint32_t paramsBegin_;
+
+    /// \brief
+    public: uint32_t numParams_;
   };
+
+  static_assert(std::is_trivially_copyable< NeuronGene >::value
+                and std::is_trivially_copyable< NeuronParameter >::value,
+                "neuron genes are copied as plain memory");
 }
 
 #endif  //  REVOLVEBRAIN_BRAIN_LEARNER_CPPNNEAT_NEURONGENOME_H_
@@ -25,8 +25,10 @@
 
 #include "SUPGGenomeManager.h"
 
-SUPGGenomeManager::SUPGGenomeManager(const std::string &robot_name)
-        : InnovGenomeManager(robot_name)
+SUPGGenomeManager::SUPGGenomeManager(
+        const std::string &robot_name,
+        const NEAT::NeatEnv *env)
+        : InnovGenomeManager(robot_name, env)
 {
 }
 
@@ -80,7 +82,7 @@ SUPGGenomeManager::create_seed_generation(
   std::vector< std::unique_ptr< NEAT::Genome>> genomes;
   {
     NEAT::rng_t _rng = rng;
-    for (int i = 0; i < NEAT::env->pop_size; i++)
+    for (int i = 0; i < env->pop_size; i++)
     {
       auto *g = new NEAT::InnovGenome(robot_name);
       start_genome.duplicate_into(g);
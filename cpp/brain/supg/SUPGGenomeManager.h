@@ -29,7 +29,9 @@ class SUPGGenomeManager
         : public NEAT::InnovGenomeManager
 {
   public:
-  SUPGGenomeManager(const std::string &robot_name);
+  SUPGGenomeManager(
+          const std::string &robot_name,
+          const NEAT::NeatEnv *env = NEAT::env);
 
   virtual std::vector< std::unique_ptr< NEAT::Genome>>
   create_seed_generation(
@@ -17,32 +17,78 @@
 *
 */
 
+#include <algorithm>
 #include <limits>
 #include <fstream>
 #include <vector>
 
+#include "innovgenome/innovgenomefile.h"
 #include "species/speciesorganism.h"
+#include "util/profiler.h"
 
 #include "AsyncNEAT.h"
 
 #define DEFAULT_RNG_SEED 1
 
+bool AsyncNeat::binary_genome_files = false;
+
+bool AsyncNeat::steady_state = false;
+
+std::mutex AsyncNeat::instances_mutex;
+
+std::vector< AsyncNeat * > AsyncNeat::instances;
+
+void AsyncNeat::CleanUp()
+{
+  {
+    std::lock_guard< std::mutex > lock(instances_mutex);
+    for (AsyncNeat *instance: instances)
+    {
+      instance->wait_for_turnover();
+    }
+  }
+
+  delete NEAT::env->genome_manager;
+  NEAT::env->genome_manager = nullptr;
+}
+
 AsyncNeat::AsyncNeat(
         size_t n_inputs,
         size_t n_outputs,
         int rng_seed,
-        const std::string &robot_name
+        const std::string &robot_name,
+        std::unique_ptr< NEAT::NeatEnv > settings
 )
 //        : n_inputs(n_inputs)
 //        , n_outputs(n_outputs)
-        : generation(1)
+        : steady(steady_state)
+        , own_env(std::move(settings))
+        , env(own_env ? own_env.get() : NEAT::env)
+        , generation(1)
         , best_fitness_counter(0)
 //        , rng_seed(rng_seed)
+        , fitness_cache(env->fitness_cache_size, env->fitness_cache_samples)
         , fittest(nullptr)
         , fittest_fitness(std::numeric_limits< float >().min())
         , robot_name(robot_name)
+        , turnover_requested(false)
+        , turnover_running(false)
+        , stopping(false)
+        , steady_replacements(0)
 {
-  if (NEAT::env->genome_manager == nullptr)
+  if (own_env)
+  {
+    if (env->genome_manager == nullptr)
+    {
+      env->genome_manager = NEAT::GenomeManager::create(robot_name, env);
+    }
+    else if (env->genome_manager->env not_eq env)
+    {
+      throw std::invalid_argument(
+              "the genome manager was created for other settings");
+    }
+  }
+  else if (env->genome_manager == nullptr)
   {
     throw std::invalid_argument(
             "genome manager not initialized, "
@@ -52,11 +98,22 @@ AsyncNeat::AsyncNeat(
                     "AsyncNeat::CleanUp() after finised "
                     "using all AsyncNEAT objects]");
   }
+  if (steady
+      and env->population_type not_eq NEAT::PopulationType::SPECIES)
+  {
+    throw std::invalid_argument(
+            "steady-state evolution needs PopulationType::SPECIES");
+  }
+  if (fitness_cache.enabled() and not (env->fitness_cache_weight_quantum > 0))
+  {
+    throw std::invalid_argument(
+            "the fitness cache needs a positive weight quantum");
+  }
   NEAT::rng_t rng(rng_seed);
   NEAT::rng_t rng_exp(rng.integer());
   std::vector< std::unique_ptr< NEAT::Genome>> genomes =
-          NEAT::env->genome_manager->create_seed_generation(
-                  NEAT::env->pop_size,
+          env->genome_manager->create_seed_generation(
+                  env->pop_size,
                   rng_exp,
                   1,
                   n_inputs,
@@ -64,40 +121,161 @@ AsyncNeat::AsyncNeat(
                   n_inputs,
                   this->robot_name);
   // Spawn the Population
-  population = NEAT::Population::create(rng_exp, genomes);
-  refill_evaluation_queue();
+  population = NEAT::Population::create(rng_exp, genomes, env);
+  if (steady)
+  {
+    steady_slots.resize(population->size(), nullptr);
+    steady_hashes.resize(population->size(), 0);
+    for (size_t i = 0; i < population->size(); i++)
+    {
+      queue_steady_evaluation(i);
+    }
+  }
+  else
+  {
+    refill_evaluation_queue();
+
+    generation_thread = std::thread(&AsyncNeat::generation_loop, this);
+  }
+
+  std::lock_guard< std::mutex > lock(instances_mutex);
+  instances.push_back(this);
 }
 
 AsyncNeat::~AsyncNeat()
 {
+  {
+    std::lock_guard< std::mutex > lock(instances_mutex);
+    instances.erase(std::find(instances.begin(), instances.end(), this));
+  }
+
+  {
+    std::lock_guard< std::mutex > lock(generation_mutex);
+    stopping = true;
+  }
+  generation_cv.notify_all();
+  if (generation_thread.joinable())
+  {
+    generation_thread.join();
+  }
+
   delete population;
+
+  if (own_env)
+  {
+    delete own_env->genome_manager;
+  }
 }
 
 std::shared_ptr< NeatEvaluation > AsyncNeat::Evaluation()
 {
-  if (this->evaluatingQueue.empty())
+  if (steady)
   {
-    std::cerr << "Neat::Evaluation() evaluation queue is empty" << std::endl;
-    return nullptr;
+    for (;;)
+    {
+      std::shared_ptr< NeatEvaluation > evaluation;
+      double fitness;
+      {
+        // Empty only while more evaluations are running than the population
+        // can replace, so there is nothing to wait for.
+        std::lock_guard< std::mutex > lock(steady_mutex);
+        if (steady_queue.empty())
+        {
+          return nullptr;
+        }
+        size_t index = steady_queue.front().first;
+        evaluation = steady_queue.front().second;
+        steady_queue.pop_front();
+        if (not fitness_cache.lookup(steady_hashes[index], fitness))
+        {
+          return evaluation;
+        }
+        steady_hashes[index] = 0;
+      }
+      // Replaces the worst organism, which may queue another known one.
+      evaluation->finish(static_cast< float >(fitness));
+    }
   }
 
-  std::shared_ptr< NeatEvaluation >
-          new_evaluation = this->evaluatingQueue.front();
-  new_evaluation->add_finished_callback(
-          [this, new_evaluation](float fitness)
-          {
-            this->evaluatingList.remove(new_evaluation);
-            this->singleEvaluationFinished(new_evaluation, fitness);
-          });
+  for (;;)
+  {
+    std::shared_ptr< Batch > current = std::atomic_load(&batch);
+
+    size_t index = current->next.fetch_add(1, std::memory_order_relaxed);
+    if (index < current->evaluations.size())
+    {
+      double fitness;
+      if (not fitness_cache.lookup(current->hashes[index], fitness))
+      {
+        return current->evaluations[index];
+      }
+      // Nobody else has this index, and the callback runs on this thread.
+      current->hashes[index] = 0;
+      current->evaluations[index]->finish(static_cast< float >(fitness));
+      continue;
+    }
+
+    // With several workers this is the normal way to learn that the rest of
+    // the generation is still being evaluated, so it isn't reported.
+    if (current->unfinished.load(std::memory_order_acquire) > 0)
+    {
+      return nullptr;
+    }
+
+    // Every evaluation has finished, so the next generation is on its way.
+    std::unique_lock< std::mutex > lock(generation_mutex);
+    generation_cv.wait(lock,
+                       [this, &current]
+                       {
+                         return stopping
+                                or std::atomic_load(&batch) not_eq current;
+                       });
+    if (stopping)
+    {
+      return nullptr;
+    }
+  }
+}
+
+void AsyncNeat::generation_loop()
+{
+  std::unique_lock< std::mutex > lock(generation_mutex);
+  for (;;)
+  {
+    generation_cv.wait(lock,
+                       [this]
+                       {
+                         return turnover_requested or stopping;
+                       });
+    if (stopping)
+    {
+      return;
+    }
+    turnover_requested = false;
+    turnover_running = true;
 
-  this->evaluatingQueue.pop_front();
-  this->evaluatingList.push_back(new_evaluation);
+    lock.unlock();
+    next_generation();
+    lock.lock();
+
+    turnover_running = false;
+    generation_cv.notify_all();
+  }
+}
 
-  return new_evaluation;
+void AsyncNeat::wait_for_turnover()
+{
+  std::unique_lock< std::mutex > lock(generation_mutex);
+  generation_cv.wait(lock,
+                     [this]
+                     {
+                       return not(turnover_requested or turnover_running);
+                     });
 }
 
 void AsyncNeat::next_generation()
 {
+  NEAT_PROFILE("AsyncNeat::next_generation");
   generation++;
   population->next_generation();
   refill_evaluation_queue();
@@ -106,10 +284,124 @@ void AsyncNeat::next_generation()
 void AsyncNeat::refill_evaluation_queue()
 {
   size_t n_organism = population->size();
+  std::shared_ptr< Batch > next(new Batch(n_organism));
+  std::weak_ptr< Batch > weak_next = next;
   for (size_t i = 0; i < n_organism; i++)
   {
-    evaluatingQueue.push_back(
-            std::make_shared< NeatEvaluation >(population->get(i)));
+    std::shared_ptr< NeatEvaluation > evaluation =
+            std::make_shared< NeatEvaluation >(population->get(i));
+    evaluation->add_finished_callback(
+            [this, weak_next, i](float fitness)
+            {
+              std::shared_ptr< Batch > owner = weak_next.lock();
+              if (not owner
+                  or owner->finished[i].exchange(true,
+                                                 std::memory_order_acq_rel))
+              {
+                std::cerr << "NeatEvaluation::finish() called twice"
+                          << std::endl;
+                return;
+              }
+
+              // Read by the generation thread once the count below reaches
+              // zero.
+              population->get(i)->eval.fitness = fitness;
+              fitness_cache.add(owner->hashes[i], fitness);
+
+              this->singleEvaluationFinished(owner->evaluations[i], fitness);
+
+              // need to wait for all generational evaluations to finish
+              // before creating a new generation (because of spieces shared
+              // fitness). Exactly one caller sees the count reach zero.
+              if (owner->unfinished.fetch_sub(1, std::memory_order_acq_rel)
+                  == 1)
+              {
+                {
+                  std::lock_guard< std::mutex > lock(generation_mutex);
+                  turnover_requested = true;
+                }
+                generation_cv.notify_all();
+              }
+            });
+    next->evaluations[i] = evaluation;
+    next->hashes[i] = genome_hash(i);
+  }
+
+  {
+    std::lock_guard< std::mutex > lock(generation_mutex);
+    std::atomic_store(&batch, next);
+  }
+  generation_cv.notify_all();
+}
+
+uint64_t AsyncNeat::genome_hash(size_t index)
+{
+  if (not fitness_cache.enabled())
+  {
+    return 0;
+  }
+  return population->get(index)->genome->get_hash(
+          env->fitness_cache_weight_quantum);
+}
+
+void AsyncNeat::queue_steady_evaluation(size_t index)
+{
+  std::shared_ptr< NeatEvaluation > evaluation =
+          std::make_shared< NeatEvaluation >(population->get(index));
+  NeatEvaluation *raw = evaluation.get();
+  evaluation->add_finished_callback(
+          [this, index, raw](float fitness)
+          {
+            this->steadyEvaluationFinished(index, raw, fitness);
+          });
+
+  steady_slots[index] = raw;
+  steady_hashes[index] = genome_hash(index);
+  steady_queue.emplace_back(index, evaluation);
+}
+
+void AsyncNeat::steadyEvaluationFinished(
+        size_t index,
+        NeatEvaluation *evaluation,
+        float fitness)
+{
+  std::lock_guard< std::mutex > lock(steady_mutex);
+  if (steady_slots[index] not_eq evaluation)
+  {
+    std::cerr << "NeatEvaluation::finish() called twice" << std::endl;
+    return;
+  }
+  steady_slots[index] = nullptr;
+  population->get(index)->eval.fitness = fitness;
+  fitness_cache.add(steady_hashes[index], fitness);
+
+  population->evaluated(index);
+
+  {
+    // The organism is about to be replaced eventually, so keep a copy of it.
+    std::lock_guard< std::mutex > fittest_lock(fittest_mutex);
+    if (fitness > this->fittest_fitness)
+    {
+      this->setFittest(
+              std::make_shared< NeatEvaluation >(population->make_copy(index)),
+              fitness);
+    }
+  }
+
+  // Half of the population has to be evaluated before there is anything
+  // meaningful to select from.
+  int baby;
+  {
+    NEAT_PROFILE("AsyncNeat::replace_worst");
+    baby = population->replace_worst(population->size() / 2);
+  }
+  if (baby >= 0)
+  {
+    queue_steady_evaluation(static_cast< size_t >(baby));
+    if (++steady_replacements % population->size() == 0)
+    {
+      generation++;
+    }
   }
 }
 
@@ -117,17 +409,11 @@ void AsyncNeat::singleEvaluationFinished(
         std::shared_ptr< NeatEvaluation > evaluation,
         float fitness)
 {
+  std::lock_guard< std::mutex > lock(fittest_mutex);
   if (fitness > this->fittest_fitness)
   {
     this->setFittest(evaluation, fitness);
   }
-
-  // need to wait for all generational evaluations to finish before creating a
-  // new generation (because of spieces shared fitness)
-  if (evaluatingQueue.empty() and evaluatingList.empty())
-  {
-    next_generation();
-  }
 }
 
 void AsyncNeat::setFittest(
@@ -138,16 +424,26 @@ void AsyncNeat::setFittest(
   this->fittest_fitness = new_fitness;
   this->best_fitness_counter++;
 
+  NEAT::Genome *genome = fittest->Organism()->genome.get();
+  NEAT::InnovGenome *innov_genome = dynamic_cast<NEAT::InnovGenome *>(genome);
+  bool binary = binary_genome_files and innov_genome;
+
   std::ostringstream filename;
   filename << "/tmp/supg/genome_" << this->best_fitness_counter
-           << "_" << generation << ".yaml";
-  std::fstream genome_save;
-  genome_save.open(filename.str(), std::ios::out);
-
+           << "_" << generation << (binary ? ".genome" : ".yaml");
 
   std::cout << "New best fitness! " << new_fitness
             << " saved at \"" << filename.str()
             << '\"' << std::endl;
 
-  fittest->Organism()->genome->save(genome_save);
+  if (binary)
+  {
+    NEAT::InnovGenomeFile::save(filename.str(), *innov_genome);
+  }
+  else
+  {
+    std::fstream genome_save;
+    genome_save.open(filename.str(), std::ios::out);
+    genome->save(genome_save);
+  }
 }
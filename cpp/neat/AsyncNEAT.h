@@ -20,12 +20,20 @@
 #ifndef REVOLVE_NEAT_NEAT_H_
 #define REVOLVE_NEAT_NEAT_H_
 
-#include <list>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "organism.h"
 #include "population.h"
+#include "util/fitnesscache.h"
 
 #include "NEATEvaluation.h"
 
@@ -40,25 +48,45 @@
  * are finished, the getEvaluation could fail.
  *
  * Multiple evaluation can be tested at the same time, is not a problem.
+ * Evaluation() and NeatEvaluation::finish() may be called from any number of
+ * threads: evaluations are handed out with an atomic counter, and the next
+ * generation is created by a worker thread once the last evaluation of the
+ * current one has finished. Evaluation() only blocks while that is going on.
  *
- * It conflicts with the classical implemeation of accuNEAT since there are some
- * global objects to be used, be carefull.
+ * With SetSteadyState(true) there are no generations to wait for: every
+ * finished evaluation lets the population replace its worst organism with a
+ * new offspring (real-time NEAT), which is queued for evaluation right away.
+ *
+ * By default the settings and the genome manager are the global ones in
+ * NEAT::env, set up with Init() and the static setters, and shared by every
+ * AsyncNeat created that way. An AsyncNeat constructed with its own
+ * NEAT::NeatEnv is independent of all others, so several of them can evolve
+ * in parallel in one process; see DefaultSettings().
+ *
+ * With NEAT::NeatEnv::fitness_cache_size set, an organism whose genome is
+ * identical to one evaluated recently is finished by Evaluation() with the
+ * remembered fitness instead of being handed out.
  */
 class AsyncNeat
 {
   public:
   /// \brief
+  /// \param settings Settings of this search only. If its genome_manager is
+  /// nullptr a standard one is created; either way this object deletes it.
+  /// Without settings, NEAT::env and the genome manager from Init() are used.
   AsyncNeat(
           size_t n_inputs,
           size_t n_outputs,
           int rng_seed,
-          const std::string &robot_name);
+          const std::string &robot_name,
+          std::unique_ptr< NEAT::NeatEnv > settings = nullptr);
 
   /// \brief
   virtual ~AsyncNeat();
 
   /// \brief If it returns nullptr, wait until all evaluations are finished to
-  /// get the next generation
+  /// get the next generation. Waits for the next generation when every
+  /// evaluation has already finished.
   std::shared_ptr< NeatEvaluation > Evaluation();
 
   /// \brief to be called before any AsyncNeat object can be used
@@ -78,12 +106,26 @@ class AsyncNeat
     NEAT::env->genome_manager = genome_manager.release();
   };
 
-  /// \brief to be called after all AsyncNeat object are not in use anymore
-  static void CleanUp()
+  /// \brief A copy of the current global settings without a genome manager,
+  /// to be adjusted and passed to the constructor
+  static std::unique_ptr< NEAT::NeatEnv > DefaultSettings()
   {
-    delete NEAT::env->genome_manager;
-    NEAT::env->genome_manager = nullptr;
-  };
+    std::unique_ptr< NEAT::NeatEnv > settings(new NEAT::NeatEnv(*NEAT::env));
+    settings->genome_manager = nullptr;
+    return settings;
+  }
+
+  /// \brief The settings this object evolves with. Changes only apply to
+  /// offspring created afterwards; pop_size, population_type and
+  /// genome_manager can't be changed.
+  NEAT::NeatEnv &Settings()
+  {
+    return *env;
+  }
+
+  /// \brief to be called after all AsyncNeat object are not in use anymore.
+  /// Waits for generations that are still being created.
+  static void CleanUp();
 
   /// \brief
   static void SetSearchType(NEAT::GeneticSearchType type)
@@ -131,9 +173,32 @@ class AsyncNeat
     NEAT::env->recur_only_prob = prob;
   }
 
+  /// \brief Save each new best genome in the binary InnovGenomeFile
+  /// format instead of YAML. Default is false.
+  static void SetBinaryGenomeFiles(bool binary)
+  {
+    binary_genome_files = binary;
+  }
+
+  /// \brief Steady-state (real-time NEAT) replacement instead of generations,
+  /// for AsyncNeat objects created afterwards. Needs
+  /// NEAT::PopulationType::SPECIES. Default is false.
+  static void SetSteadyState(bool steady)
+  {
+    steady_state = steady;
+  }
+
+  /// \brief Number of evaluations that were skipped because the fitness of
+  /// the genome was known
+  size_t CachedEvaluations()
+  {
+    return fitness_cache.hits();
+  }
+
   /// \brief
   std::shared_ptr< NeatEvaluation > Fittest() const
   {
+    std::lock_guard< std::mutex > lock(fittest_mutex);
     return fittest;
   }
 
@@ -145,13 +210,55 @@ class AsyncNeat
 
   private:
   /// \brief
+  static bool binary_genome_files;
+
+  /// \brief
+  static bool steady_state;
+
+  /// \brief steady_state when this object was created
+  const bool steady;
+
+  /// \brief Settings passed to the constructor, if any
+  std::unique_ptr< NEAT::NeatEnv > own_env;
+
+  /// \brief own_env or NEAT::env
+  NEAT::NeatEnv *env;
+
+  /// \brief
 //  size_t n_inputs;
 
   /// \brief
 //  size_t n_outputs;
 
+  /// \brief Evaluations of one generation, handed out in order
+  struct Batch
+  {
+    explicit Batch(size_t n)
+            : evaluations(n)
+            , hashes(n, 0)
+            , finished(n)
+            , next(0)
+            , unfinished(n)
+    {}
+
+    std::vector< std::shared_ptr< NeatEvaluation > > evaluations;
+
+    /// \brief Genome hash of each evaluation for the fitness cache, 0 once
+    /// its fitness came from the cache
+    std::vector< uint64_t > hashes;
+
+    /// \brief Set by the first finish() of each evaluation
+    std::vector< std::atomic< bool > > finished;
+
+    /// \brief Index of the next evaluation to hand out
+    std::atomic< size_t > next;
+
+    /// \brief Number of evaluations that have not finished yet
+    std::atomic< size_t > unfinished;
+  };
+
   /// \brief
-  size_t generation;
+  std::atomic< size_t > generation;
 
   /// \brief
   size_t best_fitness_counter;
@@ -163,10 +270,11 @@ class AsyncNeat
   NEAT::Population *population;
 
   /// \brief
-  std::list< std::shared_ptr< NeatEvaluation>> evaluatingList;
+  NEAT::FitnessCache fitness_cache;
 
-  /// \brief
-  std::list< std::shared_ptr< NeatEvaluation>> evaluatingQueue;
+  /// \brief The current generation; only replaced by the generation thread,
+  /// while generation_mutex is held. Accessed with std::atomic_load/store.
+  std::shared_ptr< Batch > batch;
 
   /// \brief
   std::shared_ptr< NeatEvaluation > fittest;
@@ -174,18 +282,81 @@ class AsyncNeat
   /// \brief
   float fittest_fitness;
 
+  /// \brief Guards fittest, fittest_fitness and best_fitness_counter
+  mutable std::mutex fittest_mutex;
+
   /// \brief
   const std::string robot_name;
 
+  /// \brief Guards the flags below and the replacement of batch
+  std::mutex generation_mutex;
+
+  /// \brief Signals both a turnover request and a new batch
+  std::condition_variable generation_cv;
+
+  /// \brief Set once the last evaluation of batch has finished
+  bool turnover_requested;
+
+  /// \brief Set while next_generation() runs
+  bool turnover_running;
+
+  /// \brief
+  bool stopping;
+
+  /// \brief Runs next_generation() whenever turnover_requested is set
+  std::thread generation_thread;
+
+  /// \brief Guards population and the members below in steady-state mode
+  std::mutex steady_mutex;
+
+  /// \brief Offspring waiting to be evaluated, with their index, in
+  /// steady-state mode
+  std::deque< std::pair< size_t, std::shared_ptr< NeatEvaluation > > >
+          steady_queue;
+
+  /// \brief The evaluation handed out for each organism, until it finishes
+  std::vector< NeatEvaluation * > steady_slots;
+
+  /// \brief Genome hash of each organism for the fitness cache, 0 once its
+  /// fitness came from the cache
+  std::vector< uint64_t > steady_hashes;
+
+  /// \brief
+  size_t steady_replacements;
+
+  /// \brief Hash of the organism at index for the fitness cache
+  uint64_t genome_hash(size_t index);
+
+  /// \brief Queues an evaluation of the organism at index
+  void queue_steady_evaluation(size_t index);
+
+  /// \brief Replaces the worst organism once the one at index is evaluated
+  void steadyEvaluationFinished(
+          size_t index,
+          NeatEvaluation *evaluation,
+          float fitness);
+
   /// \brief
   void singleEvaluationFinished(
           std::shared_ptr< NeatEvaluation > evaluation,
           float fitness);
 
+  /// \brief Body of generation_thread
+  void generation_loop();
+
+  /// \brief Blocks until no generation is requested or being created
+  void wait_for_turnover();
+
+  /// \brief Live instances, so CleanUp() can wait for them
+  static std::mutex instances_mutex;
+
   /// \brief
-  void next_generation();
+  static std::vector< AsyncNeat * > instances;
 
   /// \brief
+  void next_generation();
+
+  /// \brief Publishes the current population as a new batch
   void refill_evaluation_queue();
 };
 
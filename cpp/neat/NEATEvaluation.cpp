@@ -25,17 +25,24 @@ NeatEvaluation::NeatEvaluation(NEAT::Organism *organism)
         , organism(organism)
 {}
 
+NeatEvaluation::NeatEvaluation(std::unique_ptr< NEAT::Organism > organism)
+        : finished_callback(nullptr)
+        , organism(organism.get())
+        , owned_organism(std::move(organism))
+{}
+
 void NeatEvaluation::finish(float fitness)
 {
-  organism->eval.fitness = fitness;
-
   if (not finished_callback)
   {
+    organism->eval.fitness = fitness;
     std::cerr
             << "NeatEvaluation::finish() error, finish callback not setted!"
             << std::endl;
     return;
   }
 
+  // The callback stores the fitness, unless the evaluation was already
+  // finished or its organism was replaced.
   finished_callback(fitness);
 }
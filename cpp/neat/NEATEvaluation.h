@@ -22,6 +22,7 @@
 
 #include <functional>
 #include <iostream>
+#include <memory>
 
 #include "organism.h"
 
@@ -30,6 +31,9 @@ class NeatEvaluation
   public:
   NeatEvaluation(NEAT::Organism *organism);
 
+  /// \brief An evaluation of a copy of an organism, which it keeps alive
+  NeatEvaluation(std::unique_ptr< NEAT::Organism > organism);
+
   virtual ~NeatEvaluation()
   {}
 
@@ -47,7 +51,8 @@ class NeatEvaluation
   }
 
   /**
-   * Evaluation is finished and fitness is passed to the evaluation
+   * Evaluation is finished and fitness is passed to the evaluation. The
+   * finished callback stores it in the organism if it accepts the call.
    */
   virtual void finish(float fitness);
 
@@ -57,6 +62,8 @@ class NeatEvaluation
 //  float fitness;
 
   NEAT::Organism *organism;
+
+  std::unique_ptr< NEAT::Organism > owned_organism;
 };
 
 #endif  //  REVOLVE_NEAT_NEATEVALUATION_H_
@@ -0,0 +1,353 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Throughput benchmark over the accneat experiments
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <cstdio>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "neat.h"
+#include "experiments/evaluatorexperiment.h"
+#include "util/rng.h"
+#include "util/scheduler.h"
+#include "util/timer.h"
+#include "util/util.h"
+
+using namespace NEAT;
+
+#define DEFAULT_RNG_SEED 1
+#define DEFAULT_MAX_GENS 100
+
+void usage()
+{
+  std::cerr << "usage: accneat-bench [OPTIONS]... [experiment_name]..."
+            << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "Runs every named experiment (default: all of them) for a fixed "
+            << "number of generations and prints one JSON object per run to "
+            << "stdout. Each run happens in its own process, so peak RSS and "
+            << "timers are per run." << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "experiment names: ";
+  auto names = Experiment::get_names();
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    if (i not_eq 0)
+    {
+      std::cerr << ", ";
+    }
+    std::cerr << names[i];
+  }
+  std::cerr << std::endl;
+  std::cerr << std::endl;
+
+  std::cerr << "OPTIONS" << std::endl;
+  std::cerr << "  -c repetitions       (default=1)" << std::endl;
+  std::cerr << "  -r RNG_seed          (default=" << DEFAULT_RNG_SEED << ")"
+            << std::endl;
+  std::cerr << "  -n population_size   (default=" << env->pop_size << ")"
+            << std::endl;
+  std::cerr << "  -x generations       (default=" << DEFAULT_MAX_GENS << ")"
+            << std::endl;
+  std::cerr << "  -s search_type       "
+          "{phased, blended, complexify} (default=phased)" << std::endl;
+  std::cerr << "  -p population_type   "
+          "{species, multinnspecies} (default=species)" << std::endl;
+  std::cerr << "  -v                   Keep the experiments' own output."
+            << std::endl;
+
+  exit(1);
+}
+
+template < typename T >
+T parse_enum(
+        const char *opt,
+        std::string str,
+        std::map< std::string, T > vals)
+{
+  auto it = vals.find(str);
+  if (it == vals.end())
+  {
+    error("Invalid value for " << opt << ": " << str);
+  }
+  return it->second;
+}
+
+int parse_int(
+        const char *opt,
+        const char *str)
+{
+  try
+  {
+    return std::stoi(str);
+  } catch (...)
+  {
+    error("Expecting integer argument for "
+                  << opt << ", found '" << str << "'.");
+  }
+}
+
+/// \brief Peak resident set size of this process in kilobytes
+static long peak_rss_kb()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+struct BenchResult
+{
+  size_t generations = 0;
+  size_t evaluations = 0;
+  double seconds = 0.0;
+  double evaluate_seconds = 0.0;
+  double speciate_seconds = 0.0;
+  double reproduce_seconds = 0.0;
+  int first_success = 0;
+  real_t best_fitness = 0.0;
+  Genome::Stats best_stats = {0, 0};
+};
+
+/// \brief Same loop as EvaluatorExperiment::run(), but always runs the full
+/// number of generations and keeps quiet.
+static BenchResult run_experiment(
+        EvaluatorExperiment *exp,
+        int seed,
+        int gens)
+{
+  BenchResult result;
+
+  std::unique_ptr< NetworkEvaluator > evaluator(exp->create_evaluator());
+
+  rng_t rng(seed);
+  env->genome_manager = GenomeManager::create(exp->get_name());
+  std::vector< std::unique_ptr< Genome > > seeds = exp->create_seeds(rng);
+
+  double start = Timer::now();
+  std::unique_ptr< Population > pop(Population::create(rng, seeds));
+
+  std::vector< Network * > nets;
+  std::vector< OrganismEvaluation > evaluations;
+  for (int gen = 1; gen <= gens; gen++)
+  {
+    if (gen not_eq 1)
+    {
+      pop->next_generation();
+    }
+
+    double evaluate_start = Timer::now();
+    size_t norgs = pop->size();
+    nets.resize(norgs);
+    evaluations.resize(norgs);
+    for (size_t i = 0; i < norgs; i++)
+    {
+      nets[i] = pop->get(i)->net.get();
+    }
+    evaluator->execute(nets.data(), evaluations.data(), norgs);
+
+    for (size_t i = 0; i < norgs; i++)
+    {
+      Organism *org = pop->get(i);
+      org->eval = evaluations[i];
+      if (result.evaluations == 0
+          or org->eval.fitness > result.best_fitness)
+      {
+        result.best_fitness = org->eval.fitness;
+        result.best_stats = org->genome->get_stats();
+      }
+      if (result.first_success == 0 and exp->is_success(org))
+      {
+        result.first_success = gen;
+      }
+      result.evaluations++;
+    }
+    result.evaluate_seconds += Timer::now() - evaluate_start;
+    result.generations++;
+  }
+
+  pop.reset();
+  result.seconds = Timer::now() - start;
+  result.speciate_seconds = Timer::get_total("speciate");
+  result.reproduce_seconds = Timer::get_total("reproduce");
+
+  delete env->genome_manager;
+  env->genome_manager = nullptr;
+
+  return result;
+}
+
+static void print_result(
+        FILE *out,
+        const std::string &name,
+        int rep,
+        int seed,
+        const BenchResult &r)
+{
+  std::fprintf(out,
+               "{\"experiment\":\"%s\",\"rep\":%d,\"seed\":%d,"
+               "\"threads\":%zu,\"pop_size\":%d,"
+               "\"generations\":%zu,\"evaluations\":%zu,"
+               "\"seconds\":%.6f,\"gens_per_s\":%.3f,\"evals_per_s\":%.1f,"
+               "\"evaluate_s\":%.6f,\"speciate_s\":%.6f,\"reproduce_s\":%.6f,"
+               "\"peak_rss_kb\":%ld,"
+               "\"best_fitness\":%.6f,\"best_nnodes\":%zu,\"best_nlinks\":%zu,"
+               "\"first_success\":%d}\n",
+               name.c_str(), rep, seed,
+               Scheduler::nthreads(), env->pop_size,
+               r.generations, r.evaluations,
+               r.seconds, r.generations / r.seconds,
+               r.evaluations / r.seconds,
+               r.evaluate_seconds, r.speciate_seconds, r.reproduce_seconds,
+               peak_rss_kb(),
+               double(r.best_fitness), r.best_stats.nnodes,
+               r.best_stats.nlinks,
+               r.first_success);
+  std::fflush(out);
+}
+
+int main(
+        int argc,
+        char *argv[])
+{
+  int rng_seed = DEFAULT_RNG_SEED;
+  int maxgens = DEFAULT_MAX_GENS;
+  int nreps = 1;
+  bool verbose = false;
+
+  {
+    int opt;
+    while ((opt = getopt(argc, argv, "c:r:n:x:s:p:v")) not_eq -1)
+    {
+      switch (opt)
+      {
+        case 'c':
+          nreps = parse_int("-c", optarg);
+          break;
+        case 'r':
+          rng_seed = parse_int("-r", optarg);
+          break;
+        case 'n':
+          env->pop_size = parse_int("-n", optarg);
+          break;
+        case 'x':
+          maxgens = parse_int("-x", optarg);
+          break;
+        case 's':
+          env->search_type =
+                  parse_enum< GeneticSearchType >(
+                          "-s", optarg,
+                          {
+                                  {"phased",     GeneticSearchType::PHASED},
+                                  {"blended",    GeneticSearchType::BLENDED},
+                                  {"complexify", GeneticSearchType::COMPLEXIFY}
+                          });
+          break;
+        case 'p':
+          env->population_type =
+                  parse_enum< PopulationType >(
+                          "-p", optarg,
+                          {
+                                  {"species",
+                                          PopulationType::SPECIES},
+                                  {"multinnspecies",
+                                          PopulationType::MULTI_NN_SPECIES}
+                          });
+          break;
+        case 'v':
+          verbose = true;
+          break;
+        default:
+          usage();
+      }
+    }
+  }
+
+  if (env->search_type == GeneticSearchType::BLENDED)
+  {
+    env->mutate_delete_node_prob *= 0.1;
+    env->mutate_delete_link_prob *= 0.1;
+  }
+
+  std::vector< std::string > names(argv + optind, argv + argc);
+  if (names.empty())
+  {
+    names = Experiment::get_names();
+  }
+
+  std::vector< EvaluatorExperiment * > experiments;
+  for (const std::string &name: names)
+  {
+    auto exp = dynamic_cast<EvaluatorExperiment *>(
+            Experiment::get(name.c_str()));
+    if (exp == nullptr)
+    {
+      std::cerr << "No such experiment: " << name << std::endl;
+      usage();
+    }
+    experiments.push_back(exp);
+  }
+
+  int status = 0;
+  for (size_t i = 0; i < experiments.size(); i++)
+  {
+    for (int rep = 0; rep < nreps; rep++)
+    {
+      int seed = rng_seed + rep;
+
+      std::fflush(stdout);
+      pid_t pid = fork();
+      if (pid < 0)
+      {
+        error("fork failed");
+      }
+      if (pid == 0)
+      {
+        // The experiments print their test tables and progress to stdout,
+        // which has to stay machine-readable.
+        FILE *out = fdopen(dup(STDOUT_FILENO), "w");
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(verbose ? STDERR_FILENO : devnull, STDOUT_FILENO);
+
+        BenchResult result = run_experiment(experiments[i], seed, maxgens);
+        std::cout.flush();
+        print_result(out, names[i], rep, seed, result);
+        _exit(0);
+      }
+
+      int child_status;
+      waitpid(pid, &child_status, 0);
+      if (not WIFEXITED(child_status) or WEXITSTATUS(child_status) not_eq 0)
+      {
+        std::cerr << names[i] << " (seed " << seed << ") failed" << std::endl;
+        status = 1;
+      }
+    }
+  }
+
+  return status;
+}
@@ -32,6 +32,7 @@
 #include "organism.h"
 #include "population.h"
 #include "network/network.h"
+#include "util/scheduler.h"
 #include "util/stats.h"
 #include "util/timer.h"
 #include "util/util.h"
@@ -50,7 +51,7 @@ namespace NEAT
     std::string get_dir_path(int experiment_num)
     {
       char buf[1024];
-      std::snprintf(buf, "./experiment_%d", experiment_num);
+      std::snprintf(buf, sizeof(buf), "./experiment_%d", experiment_num);
       return buf;
     }
 
@@ -59,7 +60,7 @@ namespace NEAT
             int generation)
     {
       char buf[1024];
-      std::snprintf(buf, "%s/fittest_%d",
+      std::snprintf(buf, sizeof(buf), "%s/fittest_%d",
                     get_dir_path(experiment_num).c_str(), generation);
       return buf;
     }
@@ -151,6 +152,7 @@ namespace NEAT
 
           timer.stop();
           Timer::report();
+          Scheduler::report();
         }
 
         if (success)
@@ -45,14 +45,14 @@ namespace NEAT
             class rng_t &rng,
             int gens) = 0;
 
-    protected:
-    Experiment(const char *name);
-
-    const char *const get_name() const
+    const char *get_name() const
     {
       return name;
     }
 
+    protected:
+    Experiment(const char *name);
+
     private:
     Experiment()
     {}
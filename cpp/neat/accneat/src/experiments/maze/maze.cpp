@@ -33,6 +33,8 @@ static struct MazeInit
 
     auto create_seeds = [](rng_t rng_exp)
     {
+      // Genomes keep a pointer to their robot name.
+      static const std::string robot_name = "maze_experiment";
       return env->genome_manager->create_seed_generation(
               env->pop_size,
               rng_exp,
@@ -40,7 +42,7 @@ static struct MazeInit
               __sensor_N,
               __output_N,
               __sensor_N,
-              "maze_experiment");
+              robot_name);
     };
 
     // TODO: Should maybe make an explicit static registry func?
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "staticevaluator.h"
@@ -42,6 +43,8 @@ namespace NEAT
 
     auto create_seeds = [get_tests](rng_t rng_exp)
     {
+      // Genomes keep a pointer to their robot name.
+      static const std::string robot_name = "static_experiment";
       Step s = get_tests().front().steps.front();
 
       return env->genome_manager->create_seed_generation(env->pop_size,
@@ -50,7 +53,7 @@ namespace NEAT
                                                          s.input.size(),
                                                          s.output.size(),
                                                          s.input.size(),
-                                                         "static_experiment");
+                                                         robot_name);
     };
 
     // TODO: This is wonky. Should maybe make an explicit static registry func?
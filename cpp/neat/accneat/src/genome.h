@@ -38,6 +38,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "util/rng.h"
@@ -76,6 +77,23 @@ namespace NEAT
     /// \brief
     virtual void init_phenotype(class Network &net) = 0;
 
+    /// \brief The Network::layout_id that init_phenotype() will give a
+    /// network, or 0 if it doesn't know yet. A network that already has this
+    /// layout only needs its weights updated.
+    virtual uint64_t get_layout_id() const
+    {
+      return 0;
+    }
+
+    /// \brief A hash of everything that init_phenotype() turns into a
+    /// network, with the weights rounded to a multiple of weight_quantum, so
+    /// that genomes with the same hash give the same network. 0 if the genome
+    /// can't be hashed.
+    virtual uint64_t get_hash(real_t /*weight_quantum*/) const
+    {
+      return 0;
+    }
+
     /// \brief
     virtual void verify() = 0;
 
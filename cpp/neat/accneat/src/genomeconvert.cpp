@@ -0,0 +1,130 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Converts InnovGenome files between YAML and binary
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "innovgenome/innovgenome.h"
+#include "innovgenome/innovgenomefile.h"
+
+using namespace NEAT;
+
+void usage()
+{
+  std::cerr << "usage: accneat-genomeconvert to-binary IN.yaml OUT" << std::endl;
+  std::cerr << "       accneat-genomeconvert to-yaml IN OUT.yaml" << std::endl;
+  std::cerr << std::endl;
+  std::cerr << "A YAML file holds one genome per document, as written by "
+            << "InnovGenome::save(); a population is a stream of documents "
+            << "separated by \"---\"." << std::endl;
+  exit(1);
+}
+
+static const std::string robot_name = "genomeconvert";
+
+int to_binary(
+        const std::string &in_path,
+        const std::string &out_path)
+{
+  std::vector< YAML::Node > docs = YAML::LoadAllFromFile(in_path);
+
+  std::vector< std::unique_ptr< InnovGenome > > genomes;
+  std::vector< const InnovGenome * > ptrs;
+  for (size_t i = 0; i < docs.size(); i++)
+  {
+    genomes.emplace_back(new InnovGenome(robot_name));
+    if (not genomes.back()->load(docs[i]))
+    {
+      std::cerr << in_path << ": genome " << i << " is invalid" << std::endl;
+      return 1;
+    }
+    genomes.back()->genome_id = i;
+    ptrs.push_back(genomes.back().get());
+  }
+
+  if (not InnovGenomeFile::save(out_path, ptrs))
+  {
+    std::cerr << "failed writing " << out_path << std::endl;
+    return 1;
+  }
+  std::cout << "wrote " << ptrs.size() << " genomes to " << out_path
+            << std::endl;
+  return 0;
+}
+
+int to_yaml(
+        const std::string &in_path,
+        const std::string &out_path)
+{
+  InnovGenomeFile file;
+  if (not file.open(in_path))
+  {
+    return 1;
+  }
+
+  std::ofstream out(out_path);
+  InnovGenome genome(robot_name);
+  for (size_t i = 0; i < file.size(); i++)
+  {
+    file.load(i, genome);
+    if (i > 0)
+    {
+      out << std::endl << "---" << std::endl;
+    }
+    genome.save(out);
+  }
+  out << std::endl;
+
+  if (not out.good())
+  {
+    std::cerr << "failed writing " << out_path << std::endl;
+    return 1;
+  }
+  std::cout << "wrote " << file.size() << " genomes to " << out_path
+            << std::endl;
+  return 0;
+}
+
+int main(
+        int argc,
+        char *argv[])
+{
+  if (argc not_eq 4)
+  {
+    usage();
+  }
+
+  std::string command = argv[1];
+  if (command == "to-binary")
+  {
+    return to_binary(argv[2], argv[3]);
+  }
+  else if (command == "to-yaml")
+  {
+    return to_yaml(argv[2], argv[3]);
+  }
+
+  usage();
+  return 1;
+}
@@ -25,13 +25,30 @@
 
 using namespace NEAT;
 
-GenomeManager *GenomeManager::create(const std::string &robot_name)
+GenomeManager *GenomeManager::create(
+        const std::string &robot_name,
+        const NeatEnv *env)
 {
   switch (env->genome_type)
   {
     case GenomeType::INNOV:
-      return new InnovGenomeManager(robot_name);
+      return new InnovGenomeManager(robot_name, env);
     default:
     panic();
   }
 }
+
+std::unique_ptr< GenomeManager::Representative >
+GenomeManager::make_representative(Genome &genome)
+{
+  std::unique_ptr< Representative > rep(new Representative());
+  rep->genome = &genome;
+  return rep;
+}
+
+bool GenomeManager::is_compatible(
+        Genome &genome,
+        Representative &rep)
+{
+  return are_compatible(genome, *rep.genome);
+}
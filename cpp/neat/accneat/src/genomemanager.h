@@ -37,11 +37,18 @@ namespace NEAT
   class GenomeManager
   {
     public:
-    static GenomeManager *create(const std::string &robot_name);
+    /// \brief Creates the manager for env's genome_type. It reads its
+    /// settings from env, which must outlive it.
+    static GenomeManager *create(
+            const std::string &robot_name,
+            const NeatEnv *env = NEAT::env);
 
     virtual ~GenomeManager()
     {}
 
+    /// \brief The settings of the search this manager belongs to
+    const NeatEnv *env;
+
     virtual std::unique_ptr< Genome > make_default() = 0;
 
     virtual std::vector< std::unique_ptr< Genome>>
@@ -58,6 +65,26 @@ namespace NEAT
             Genome &genome1,
             Genome &genome2) = 0;
 
+    /// \brief A genome that many others are tested against for
+    /// compatibility, such as a species representative during speciation.
+    /// Managers can subclass it to keep a form that is cheaper to compare.
+    struct Representative
+    {
+      Genome *genome;
+
+      virtual ~Representative()
+      {}
+    };
+
+    /// \brief The returned object refers to genome, which must outlive it.
+    virtual std::unique_ptr< Representative > make_representative(
+            Genome &genome);
+
+    /// \brief Same result as are_compatible(genome, *rep.genome)
+    virtual bool is_compatible(
+            Genome &genome,
+            Representative &rep);
+
     virtual void clone(
             Genome &orig,
             Genome &clone) = 0;
@@ -81,6 +108,18 @@ namespace NEAT
             MutationOperation op = MUTATE_OP_ANY) = 0;
 
     virtual void finalize_generation(bool new_fittest) = 0;
+
+    /// \brief Settles the innovations made since the last call, for when
+    /// offspring are created one at a time rather than per generation.
+    /// finalize_generation() does this too.
+    virtual void apply_innovations()
+    {}
+
+    protected:
+    /// \brief
+    GenomeManager(const NeatEnv *env)
+            : env(env)
+    {}
   };
 }
 
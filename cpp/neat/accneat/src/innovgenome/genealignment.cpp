@@ -0,0 +1,39 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Alignment of two gene lists by innovation number
+* Author: TODO <Add proper author>
+*
+*/
+
+#include "genealignment.h"
+
+using namespace NEAT;
+
+void GeneAlignment::reset(
+        size_t n1,
+        size_t n2)
+{
+  _nspans = 0;
+  _nmatching = 0;
+  _ndisjoint = 0;
+  _nexcess = 0;
+
+  // There are never more spans than genes, plus the sentinel.
+  if (_spans.size() < n1 + n2 + 1)
+  {
+    _spans.resize(n1 + n2 + 1);
+  }
+}
+
@@ -0,0 +1,343 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Alignment of two gene lists by innovation number
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_INNOVGENOME_GENEALIGNMENT_H_
+#define CPP_NEAT_ACCNEAT_SRC_INNOVGENOME_GENEALIGNMENT_H_
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace NEAT
+{
+  ///
+  /// CLASS GeneAlignment
+  ///
+  /// Lines up two gene lists sorted by innovation number, which is the
+  /// shared first step of compatibility() and the mating operators. The
+  /// result is a list of spans in merge order: runs of matching genes, runs
+  /// of disjoint genes from either parent, and the excess tail of the longer
+  /// one. Innovation numbers are compared as integers.
+  ///
+  /// Genes are read in place through walk().
+  ///
+  /// The object keeps its buffers between calls; reuse one per thread.
+  ///
+  class GeneAlignment
+  {
+    public:
+    enum SpanType
+    {
+      MATCHING = 0,
+      DISJOINT1 = 1,
+      DISJOINT2 = 2,
+      EXCESS1,
+      EXCESS2
+    };
+
+    /// \brief len consecutive genes starting at start1 in the first list
+    /// and/or start2 in the second, depending on type.
+    struct Span
+    {
+      SpanType type;
+      size_t start1;
+      size_t start2;
+      size_t len;
+    };
+
+    /// \brief A single gene (or pair of matching genes) in merge order.
+    /// i1 is only meaningful for MATCHING, DISJOINT1 and EXCESS1; i2 for
+    /// MATCHING, DISJOINT2 and EXCESS2.
+    struct Step
+    {
+      SpanType type;
+      size_t i1;
+      size_t i2;
+    };
+
+    class iterator
+    {
+      const Span *span;
+      size_t k;
+
+      public:
+      iterator(
+              const Span *span_,
+              size_t k_)
+              : span(span_)
+              , k(k_)
+      {}
+
+      Step operator*() const
+      {
+        Step step;
+        step.type = span->type;
+        step.i1 = span->start1 + (span->type == MATCHING
+                                  or span->type == DISJOINT1
+                                  or span->type == EXCESS1 ? k : 0);
+        step.i2 = span->start2 + (span->type == MATCHING
+                                  or span->type == DISJOINT2
+                                  or span->type == EXCESS2 ? k : 0);
+        return step;
+      }
+
+      iterator &operator++()
+      {
+        if (++k == span->len)
+        {
+          ++span;
+          k = 0;
+        }
+        return *this;
+      }
+
+      bool operator!=(const iterator &other) const
+      {
+        return (span not_eq other.span) or (k not_eq other.k);
+      }
+    };
+
+    /// \brief Aligns two gene lists sorted by innovation number. Genes are
+    /// read in place, so large gene structs are only walked once.
+    template < typename Gene >
+    bool align(
+            const std::vector< Gene > &genes1,
+            const std::vector< Gene > &genes2,
+            size_t max_disjoint = std::numeric_limits< size_t >::max())
+    {
+      reset(genes1.size(), genes2.size());
+      return walk(Innovations< Gene >{genes1.data()},
+                  genes1.size(),
+                  Innovations< Gene >{genes2.data()},
+                  genes2.size(),
+                  0,
+                  max_disjoint,
+                  *this);
+    }
+
+    /// \brief Walks two lists of innovation numbers in merge order without
+    /// storing the alignment. visitor(type, i1, i2, len) is called for
+    /// every single matching or disjoint gene (len = 1) and once for the
+    /// excess tail. innov1 and innov2 are indexable with [], and must
+    /// match up to position i. Returns false as soon as max_disjoint
+    /// disjoint genes have been visited.
+    ///
+    /// This is the cheapest way to get at quantities that are summed over
+    /// the alignment, like the compatibility distance.
+    template < typename Innov1, typename Innov2, typename Visitor >
+    static bool walk(
+            Innov1 innov1,
+            size_t n1,
+            Innov2 innov2,
+            size_t n2,
+            size_t i,
+            size_t max_disjoint,
+            Visitor &visitor);
+
+    /// \brief Reads innovation numbers straight out of a gene array
+    template < typename Gene >
+    struct Innovations
+    {
+      const Gene *genes;
+
+      int32_t operator[](size_t i) const
+      {
+        return genes[i].innovation_num;
+      }
+    };
+
+    /// \brief Span recording visitor used by align()
+    void operator()(
+            SpanType type,
+            size_t i1,
+            size_t i2,
+            size_t len);
+
+    /// \brief Range over the spans, for use in range-based for loops
+    struct SpanRange
+    {
+      const Span *first;
+      const Span *last;
+
+      const Span *begin() const
+      {
+        return first;
+      }
+
+      const Span *end() const
+      {
+        return last;
+      }
+    };
+
+    SpanRange spans() const
+    {
+      return SpanRange{_spans.data() + 1, _spans.data() + 1 + _nspans};
+    }
+
+    iterator begin() const
+    {
+      return iterator(_spans.data() + 1, 0);
+    }
+
+    iterator end() const
+    {
+      return iterator(_spans.data() + 1 + _nspans, 0);
+    }
+
+    size_t nmatching() const
+    {
+      return _nmatching;
+    }
+
+    size_t ndisjoint() const
+    {
+      return _ndisjoint;
+    }
+
+    size_t nexcess() const
+    {
+      return _nexcess;
+    }
+
+    private:
+    void reset(
+            size_t n1,
+            size_t n2);
+
+    void add_span(
+            SpanType type,
+            size_t start1,
+            size_t start2,
+            size_t len);
+
+    // Grows as needed and is never shrunk; _spans[0] is a sentinel
+    std::vector< Span > _spans = std::vector< Span >(1);
+
+    size_t _nspans = 0;
+
+    size_t _nmatching;
+
+    size_t _ndisjoint;
+
+    size_t _nexcess;
+  };
+
+  template < typename Innov1, typename Innov2, typename Visitor >
+  bool GeneAlignment::walk(
+          Innov1 innov1,
+          size_t n1,
+          Innov2 innov2,
+          size_t n2,
+          size_t i,
+          size_t max_disjoint,
+          Visitor &visitor)
+  {
+    size_t i1 = i, i2 = i;
+    size_t ndisjoint = 0;
+    while ((i1 < n1) and (i2 < n2))
+    {
+      int32_t a = innov1[i1];
+      int32_t b = innov2[i2];
+      if (a == b)
+      {
+        visitor(MATCHING, i1++, i2++, 1);
+      }
+      else
+      {
+        if (a < b)
+        {
+          visitor(DISJOINT1, i1++, i2, 1);
+        }
+        else
+        {
+          visitor(DISJOINT2, i1, i2++, 1);
+        }
+        if (++ndisjoint >= max_disjoint)
+        {
+          return false;
+        }
+      }
+    }
+
+    // Whatever is left of the longer list is excess.
+    if (i1 < n1)
+    {
+      visitor(EXCESS1, i1, i2, n1 - i1);
+    }
+    else if (i2 < n2)
+    {
+      visitor(EXCESS2, i1, i2, n2 - i2);
+    }
+
+    return true;
+  }
+
+  inline void GeneAlignment::add_span(
+          SpanType type,
+          size_t start1,
+          size_t start2,
+          size_t len)
+  {
+    Span &span = _spans[++_nspans];
+    span.type = type;
+    span.start1 = start1;
+    span.start2 = start2;
+    span.len = len;
+  }
+
+  inline void GeneAlignment::operator()(
+          SpanType type,
+          size_t i1,
+          size_t i2,
+          size_t len)
+  {
+    switch (type)
+    {
+      case MATCHING:
+        _nmatching += len;
+        break;
+      case DISJOINT1:
+      case DISJOINT2:
+        _ndisjoint += len;
+        break;
+      default:
+        _nexcess += len;
+        break;
+    }
+
+    // Consecutive steps of the same type grow the last span; the sentinel in
+    // slot 0 never matches, since its length is 0.
+    Span &last = _spans[_nspans];
+    if ((last.type == type) and (last.len > 0))
+    {
+      last.len += len;
+    }
+    else
+    {
+      add_span(type, i1, i2, len);
+    }
+  }
+}
+
+#endif
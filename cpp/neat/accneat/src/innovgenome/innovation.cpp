@@ -33,13 +33,11 @@ limitations under the License.
 */
 
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 
-#ifdef WITH_OPENMP
-#include <omp.h>
-#endif
-
 #include "innovation.h"
+#include "util/scheduler.h"
 #include "util/util.h"
 
 using namespace NEAT;
@@ -105,6 +103,25 @@ bool InnovationId::operator==(const InnovationId &other) const
   return ::cmp(*this, other) == 0;
 }
 
+size_t InnovationIdHash::operator()(const InnovationId &id) const
+{
+  // Only the fields compared by cmp() for this type take part.
+  uint64_t h = static_cast<uint32_t>(id.node_in_id);
+  h = (h << 32) | static_cast<uint32_t>(id.node_out_id);
+  h ^= (id.innovation_type == NEWNODE)
+       ? static_cast<uint64_t>(static_cast<uint32_t>(id.old_innov_num)) << 1
+       : static_cast<uint64_t>(id.recur_flag) << 1 | 1;
+
+  // Finalizer of MurmurHash3, so that both the shard (high bits) and the
+  // bucket (low bits) are well mixed.
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return static_cast<size_t>(h);
+}
+
 InnovationParms::InnovationParms()
         : new_weight(-1)
         , new_trait_id(-1)
@@ -160,95 +177,147 @@ Innovation::Innovation(
 {
 }
 
-static bool cmp_ind(
-        const IndividualInnovation &x,
-        const IndividualInnovation &y)
-{
-  return x.population_index < y.population_index;
-}
-
 void PopulationInnovations::init(
         int node_id,
         int innov_num)
 {
   cur_node_id = node_id;
   cur_innov_num = innov_num;
-
-#ifdef WITH_OPENMP
-  innovations.resize( omp_get_max_threads() );
-#else
-  innovations.resize(1);
-#endif
 }
 
 void PopulationInnovations::add(const IndividualInnovation &innov)
 {
-#ifdef WITH_OPENMP
-  innovations[omp_get_thread_num()].push_back(innov);
-#else
-  innovations[0].push_back(innov);
-#endif
+  Shard &shard = shards[(InnovationIdHash()(innov.id) >> 32) % NSHARDS];
+  std::lock_guard< std::mutex > lock(shard.mutex);
+
+  Group &group = shard.groups[innov.id];
+  if (group.inds.empty()
+      or (innov.population_index < group.inds[group.master].population_index))
+  {
+    group.master = group.inds.size();
+  }
+  group.inds.push_back(innov);
 }
 
 void PopulationInnovations::apply()
 {
-  id2inds.clear();
-  for (std::vector< IndividualInnovation > &inds: innovations)
+  std::vector< Group * > groups;
+  for (Shard &shard: shards)
   {
-    for (auto &ind: inds)
+    for (auto &kv: shard.groups)
     {
-      id2inds[ind.id].push_back(ind);
+      groups.push_back(&kv.second);
     }
-    inds.clear();
   }
-
-  std::vector< IndividualInnovation > masters;
-  for (auto &kv: id2inds)
+  if (groups.empty())
   {
-    auto &inds = kv.second;
-
-    std::sort(inds.begin(), inds.end(), cmp_ind);
-
-    auto &master = inds.front();
-    masters.push_back(master);
+    return;
   }
 
-  std::sort(masters.begin(), masters.end(), cmp_ind);
-
-  for (auto &master: masters)
+  // Number in order of the first individual to make each innovation, so
+  // the numbers don't depend on which thread got there first. An individual
+  // making more than one innovation is ordered by id.
+  std::sort(groups.begin(),
+            groups.end(),
+            [](const Group *x, const Group *y)
+            {
+              int xmaster = x->inds[x->master].population_index;
+              int ymaster = y->inds[y->master].population_index;
+              if (xmaster not_eq ymaster)
+              {
+                return xmaster < ymaster;
+              }
+              return x->inds.front().id < y->inds.front().id;
+            });
+
+  std::vector< Innovation > innovs;
+  innovs.reserve(groups.size());
+  for (size_t rank = 0; rank < groups.size(); rank++)
   {
-    auto &inds = id2inds[master.id];
-
-    Innovation *innov;
+    Group &group = *groups[rank];
+    const IndividualInnovation &master = group.inds[group.master];
+    group.rank = rank;
 
     switch (master.id.innovation_type)
     {
       case NEWNODE:
       {
-        innov = new Innovation(master.id,
-                               master.parms,
-                               cur_innov_num,
-                               cur_innov_num + 1,
-                               cur_node_id);
+        innovs.emplace_back(master.id,
+                            master.parms,
+                            cur_innov_num,
+                            cur_innov_num + 1,
+                            cur_node_id);
         cur_innov_num += 2;
         cur_node_id += 1;
       }
         break;
       case NEWLINK:
       {
-        innov = new Innovation(master.id, master.parms, cur_innov_num);
+        innovs.emplace_back(master.id, master.parms, cur_innov_num);
         cur_innov_num += 1;
       }
         break;
       default:
       trap("here");
     }
+  }
 
-    for (IndividualInnovation &ind: inds)
+  // Each individual only changes its own genome, so individuals can be
+  // handled in parallel, as long as one individual's innovations are
+  // applied in numbering order.
+  struct Application
+  {
+    int population_index;
+    size_t rank;
+    IndividualInnovation *ind;
+  };
+  std::vector< Application > applications;
+  for (Group *group: groups)
+  {
+    for (IndividualInnovation &ind: group->inds)
     {
-      ind.apply(innov);
+      applications.push_back({ind.population_index, group->rank, &ind});
     }
-
-    delete innov;
+  }
+  std::sort(applications.begin(),
+            applications.end(),
+            [](const Application &x, const Application &y)
+            {
+              if (x.population_index not_eq y.population_index)
+              {
+                return x.population_index < y.population_index;
+              }
+              return x.rank < y.rank;
+            });
+
+  std::vector< size_t > starts;
+  for (size_t i = 0; i < applications.size(); i++)
+  {
+    if ((i == 0) or (applications[i].population_index
+                     not_eq applications[i - 1].population_index))
+    {
+      starts.push_back(i);
+    }
+  }
+  starts.push_back(applications.size());
+
+  static Scheduler scheduler("innovations");
+  scheduler.run(starts.size() - 1,
+                [&starts](size_t i)
+                {
+                  return starts[i + 1] - starts[i];
+                },
+                [&](size_t i)
+                {
+                  for (size_t j = starts[i]; j < starts[i + 1]; j++)
+                  {
+                    Application &app = applications[j];
+                    app.ind->apply(&innovs[app.rank]);
+                  }
+                });
+
+  for (Shard &shard: shards)
+  {
+    shard.groups.clear();
   }
 }
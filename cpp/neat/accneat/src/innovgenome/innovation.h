@@ -36,8 +36,9 @@
 #ifndef _INNOVATION_H_
 #define _INNOVATION_H_
 
-#include <map>
 #include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "neat.h"
@@ -85,6 +86,11 @@ namespace NEAT
     bool operator==(const InnovationId &other) const;
   };
 
+  struct InnovationIdHash
+  {
+    size_t operator()(const InnovationId &id) const;
+  };
+
   class InnovationParms
   {
     public:
@@ -165,13 +171,40 @@ namespace NEAT
             int newnode_id_);
   };
 
+  ///
+  /// CLASS PopulationInnovations
+  ///
+  /// Collects the genetic innovations of the newest generation. Individuals
+  /// are grouped by InnovationId as they are added, in a hash table split
+  /// into shards with a lock each, so reproduction threads rarely wait for
+  /// one another. apply() then only has to number the distinct innovations
+  /// and hand them to the individuals, which it does in parallel.
+  ///
   class PopulationInnovations
   {
-    /// \brief For holding the genetic innovations of the newest generation
-    std::vector< std::vector< IndividualInnovation>> innovations;
+    /// \brief Every individual that made the same innovation
+    struct Group
+    {
+      std::vector< IndividualInnovation > inds;
 
-    /// \brief
-    std::map< InnovationId, std::vector< IndividualInnovation>> id2inds;
+      /// \brief Index in inds of the lowest population index
+      size_t master;
+
+      /// \brief Position in numbering order, assigned by apply()
+      size_t rank;
+    };
+
+    struct Shard
+    {
+      std::mutex mutex;
+
+      std::unordered_map< InnovationId, Group, InnovationIdHash > groups;
+    };
+
+    static const size_t NSHARDS = 64;
+
+    /// \brief For holding the genetic innovations of the newest generation
+    Shard shards[NSHARDS];
 
     /// \brief
     int cur_node_id;
@@ -184,8 +217,11 @@ namespace NEAT
             int node_id,
             int innov_num);
 
+    /// \brief Records an innovation; may be called from several threads
     void add(const IndividualInnovation &innov);
 
+    /// \brief Numbers the innovations added since the last call, in order
+    /// of the lowest population index that made each one, and applies them
     void apply();
   };
 }  // namespace NEAT
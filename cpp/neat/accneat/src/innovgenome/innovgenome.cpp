@@ -32,26 +32,40 @@
   limitations under the License.
 */
 
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <cmath>
 #include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <vector>
 
 #include <yaml-cpp/yaml.h>
 
+#include "genealignment.h"
 #include "innovgenome.h"
 #include "protoinnovlinkgene.h"
-#include "recurrencychecker.h"
+#include "util/fitnesscache.h"
 #include "util/util.h"
 
 using namespace NEAT;
 using namespace std;
 
+// Scratch space for compatibility() and the mating operators.
+static GeneAlignment &get_alignment()
+{
+  static thread_local GeneAlignment alignment;
+  return alignment;
+}
+
 void InnovGenome::reset()
 {
   traits.clear();
   nodes.clear();
   links.clear();
+  structure_changed();
 }
 
 InnovGenome::InnovGenome(const std::string *robot_name)
@@ -263,8 +277,11 @@ void NEAT::InnovGenome::save(std::ostream &out) const
 
 bool NEAT::InnovGenome::load(std::istream &in)
 {
-  YAML::Node config = YAML::Load(in);
+  return load(YAML::Load(in));
+}
 
+bool NEAT::InnovGenome::load(const YAML::Node &config)
+{
   // read and validate header
   YAML::Node header = config["header"];
   if (header["type"].as< std::string >() not_eq YAML_HEADER_TYPE
@@ -304,6 +321,7 @@ bool NEAT::InnovGenome::load(std::istream &in)
     this->links.push_back(
             link_gene);
   }
+  structure_changed();
 
   return true;
 }
@@ -323,6 +341,8 @@ void InnovGenome::duplicate_into(InnovGenome *offspring) const
   offspring->traits = traits;
   offspring->links = links;
   offspring->nodes = nodes;
+  offspring->phenotype = phenotype;
+  offspring->reachability = reachability;
 }
 
 InnovGenome &InnovGenome::operator=(const InnovGenome &other)
@@ -332,13 +352,15 @@ InnovGenome &InnovGenome::operator=(const InnovGenome &other)
   traits = other.traits;
   nodes = other.nodes;
   links = other.links;
+  phenotype = other.phenotype;
+  reachability = other.reachability;
   robot_name = other.robot_name;
   return *this;
 }
 
-void InnovGenome::mutate_random_trait()
+void InnovGenome::mutate_random_trait(const NeatEnv &env)
 {
-  rng.element(traits).mutate(rng);
+  rng.element(traits).mutate(rng, env);
 }
 
 void InnovGenome::mutate_link_trait(int times)
@@ -372,6 +394,20 @@ void InnovGenome::mutate_node_trait(int times)
   // mutation number
 }
 
+// Scratch space for mutate_link_weights(); every thread reuses its own.
+struct WeightScratch
+{
+  std::vector< real_t > weights;
+  std::vector< real_t > tail;
+  std::vector< real_t > rand;
+};
+
+static WeightScratch &get_weight_scratch()
+{
+  static thread_local WeightScratch scratch;
+  return scratch;
+}
+
 void InnovGenome::mutate_link_weights(
         real_t power,
         real_t rate,
@@ -379,88 +415,91 @@ void InnovGenome::mutate_link_weights(
 {
   // Go through all the InnovLinkGenes and perturb their link's weights
 
-  real_t num = 0.0;  // counts gene placement
-  real_t gene_total = (real_t)links.size();
+  const size_t n = links.size();
+  real_t gene_total = (real_t)n;
   real_t endpart = gene_total * 0.8;  // Signifies the last part of the genome
-  real_t powermod = 1.0;  // Modified power by gene number
-  // The power of mutation will rise farther into the genome
-  // on the theory that the older genes are more fit since
-  // they have stood the test of time
 
   bool severe = rng.prob() > 0.5;  // Once in a while really shake things up
 
-  // Loop on all links  (ORIGINAL METHOD)
-  for (InnovLinkGene &gene: links)
+  WeightScratch &scratch = get_weight_scratch();
+  scratch.weights.resize(n);
+  scratch.tail.resize(n);
+  scratch.rand.resize(3 * n);
+  real_t *weights = scratch.weights.data();
+  real_t *tail = scratch.tail.data();
+
+  // Every gene gets the same three draws, so they can be made in one go:
+  // whether to skip cold mutations, the perturbation, and the choice
+  // between perturbing and replacing the weight.
+  real_t *nocold = scratch.rand.data();
+  real_t *perturbation = nocold + n;
+  real_t *choice = perturbation + n;
+  rng.fill_prob(nocold, 3 * n);
+
+  // Frozen links don't count towards the position in the genome.
+  real_t num = 0.0;  // counts gene placement
+  for (size_t i = 0; i < n; i++)
   {
-    // The following if determines the probabilities of doing cold gaussian
-    // mutation, meaning the probability of replacing a link weight with
-    // another, entirely random weight.  It is meant to bias such mutations
-    // to the tail of a genome, because that is where less time-tested links
-    // reside.  The gausspoint and coldgausspoint represent values above
-    // which a random float will signify that kind of mutation.
-
-    // Don't mutate weights of frozen links
-    if (not(gene.frozen))
+    weights[i] = links[i].weight();
+    tail[i] = ((gene_total >= 10.0) and (num > endpart)) ? 1.0 : 0.0;
+    if (not links[i].frozen)
     {
-      real_t gausspoint;
-      real_t coldgausspoint;
-
-      if (severe)
-      {
-        gausspoint = 0.3;
-        coldgausspoint = 0.1;
-      }
-      else if ((gene_total >= 10.0) and (num > endpart))
-      {
-        gausspoint = 0.5;  // Mutate by modification % of connections
-        coldgausspoint = 0.3;  // Mutate the rest by replacement % of the time
-      }
-      else
-      {
-        // Half the time don't do any cold mutations
-        if (rng.prob() > 0.5)
-        {
-          gausspoint = 1.0 - rate;
-          coldgausspoint = 1.0 - rate - 0.1;
-        }
-        else
-        {
-          gausspoint = 1.0 - rate;
-          coldgausspoint = 1.0 - rate;
-        }
-      }
+      num += 1.0;
+    }
+  }
 
-      // Possible methods of setting the perturbation:
-      real_t randnum = rng.posneg() * rng.prob() * power * powermod;
-      if (mut_type == GAUSSIAN)
-      {
-        real_t randchoice = rng.prob();
-        if (randchoice > gausspoint)
-        {
-          gene.weight() += randnum;
-        }
-        else if (randchoice > coldgausspoint)
-        {
-          gene.weight() = randnum;
-        }
-      }
-      else if (mut_type == COLDGAUSSIAN)
-      {
-        gene.weight() = randnum;
-      }
+  // The following determines the probabilities of doing cold gaussian
+  // mutation, meaning the probability of replacing a link weight with
+  // another, entirely random weight.  It is meant to bias such mutations
+  // to the tail of a genome, because that is where less time-tested links
+  // reside.  The gausspoint and coldgausspoint represent values above
+  // which a random float will signify that kind of mutation.
+  //
+  // Half the time the head of the genome gets no cold mutations.
+  const real_t gauss_tail = severe ? 0.3 : 0.5;
+  const real_t gauss_head = severe ? 0.3 : 1.0 - rate;
+  const real_t cold_tail = severe ? 0.1 : 0.3;
+  const real_t cold_head = severe ? 0.1 : 1.0 - rate - 0.1;
+  const real_t cold_head_none = severe ? 0.1 : 1.0 - rate;
+  const real_t half = 0.5;
+  const real_t cap = 8.0;
+
+  // The loop is branch free, so it compiles to masked vector code.
+  const bool gaussian = (mut_type == GAUSSIAN);
+  for (size_t i = 0; i < n; i++)
+  {
+    bool in_tail = tail[i] > 0;
+    real_t gausspoint = in_tail ? gauss_tail : gauss_head;
+    real_t coldgausspoint =
+            in_tail ? cold_tail
+                    : (nocold[i] > half ? cold_head : cold_head_none);
+
+    // Uniform in [-power, power], like posneg() * prob() * power
+    real_t randnum = (perturbation[i] - half) * (power + power);
+    real_t w = weights[i];
+    real_t perturbed = choice[i] > gausspoint
+                       ? w + randnum
+                       : (choice[i] > coldgausspoint ? randnum : w);
+    w = gaussian ? perturbed : randnum;
+
+    // Cap the weights at 8.0 (experimental)
+    w = w > cap ? cap : w;
+    w = w < -cap ? -cap : w;
+    weights[i] = w;
+  }
 
-      // Cap the weights at 8.0 (experimental)
-      if (gene.weight() > 8.0)
-      { gene.weight() = 8.0; }
-      else if (gene.weight() < -8.0)
-      { gene.weight() = -8.0; }
+  // Don't mutate weights of frozen links
+  for (size_t i = 0; i < n; i++)
+  {
+    InnovLinkGene &gene = links[i];
+    if (not gene.frozen)
+    {
+      gene.weight() = weights[i];
 
       // Record the innovation
-      gene.mutation_num = gene.weight();
-
-      num += 1.0;
+      gene.mutation_num = weights[i];
     }
-  }  // end for loop
+  }
 }
 
 void InnovGenome::mutate_toggle_enable(int times)
@@ -472,6 +511,7 @@ void InnovGenome::mutate_toggle_enable(int times)
     if (not gene.enable)
     {
       gene.enable = true;
+      link_enabled(gene);
     }
     else
     {
@@ -493,6 +533,7 @@ void InnovGenome::mutate_toggle_enable(int times)
       if (found)
       {
         gene.enable = false;
+        structure_changed();
       }
     }
   }
@@ -506,6 +547,7 @@ void InnovGenome::mutate_gene_reenable()
     if (not g.enable)
     {
       g.enable = true;
+      link_enabled(g);
       break;
     }
   }
@@ -569,12 +611,20 @@ bool InnovGenome::mutate_add_node(
             }
             else
             {
+              // The new node takes over the connection of the split link,
+              // so nothing else changes in what reaches what.
               splitlink->enable = false;
+              if (Reachability *reach = own_reachability())
+              {
+                reach->add_node(innov->newnode_id);
+              }
             }
 
             add_link(this->links, newlink1);
             add_link(this->links, newlink2);
             add_node(this->nodes, newnode);
+            link_enabled(newlink1);
+            link_enabled(newlink2);
           };
 
   create_innov(innov_id, innov_parms, innov_apply);
@@ -616,6 +666,7 @@ void InnovGenome::mutate_delete_node()
                          });
 
   links.resize(it_end - links.begin());
+  structure_changed();
 }
 
 void InnovGenome::mutate_delete_link()
@@ -628,24 +679,30 @@ void InnovGenome::mutate_delete_link()
   size_t link_index = rng.index(links);
   InnovLinkGene link = links[link_index];
   links.erase(links.begin() + link_index);
+  structure_changed();
 
   delete_if_orphaned_hidden_node(link.in_node_id());
   delete_if_orphaned_hidden_node(link.out_node_id());
 }
 
 bool InnovGenome::mutate_add_link(
+        const NeatEnv &env,
         CreateInnovationFunc create_innov,
         int tries)
 {
-  InnovLinkGene *recur_checker_buf[links.size()];
-  RecurrencyChecker recur_checker(nodes.size(), links, recur_checker_buf);
+  if (not reachability)
+  {
+    reachability = std::make_shared< Reachability >(nodes, links);
+  }
+  const Reachability &reach = *reachability;
+
   // Pointers to the nodes
   InnovNodeGene *in_node = nullptr;
   // Pointers to the nodes
   InnovNodeGene *out_node = nullptr;
 
   // Decide whether to make this recurrent
-  bool do_recur = rng.prob() < env->recur_only_prob;
+  bool do_recur = rng.prob() < env.recur_only_prob;
 
   // Try to find nodes for link.
   {
@@ -688,14 +745,15 @@ bool InnovGenome::mutate_add_link(
               find_link(in_node->node_id, out_node->node_id, do_recur);
       if (existing_link not_eq nullptr)
       {
-        if (env->mutate_add_link_reenables)
+        if (env.mutate_add_link_reenables)
         {
           existing_link->enable = true;
+          link_enabled(*existing_link);
           return true;
         }
       }
-      else if (do_recur == recur_checker.is_recur(in_node->node_id,
-                                                  out_node->node_id))
+      else if (do_recur == reach.is_recur(in_node->node_id,
+                                          out_node->node_id))
       {
         found_nodes = true;
       }
@@ -735,6 +793,7 @@ bool InnovGenome::mutate_add_link(
                             -1);
 
       add_link(this->links, newlink);
+      link_enabled(newlink);
     };
 
     create_innov(innov_id, innov_parms, innov_apply);
@@ -743,6 +802,33 @@ bool InnovGenome::mutate_add_link(
   return true;
 }
 
+Reachability *InnovGenome::own_reachability()
+{
+  if (reachability and (reachability.use_count() > 1))
+  {
+    reachability = std::make_shared< Reachability >(*reachability);
+  }
+  else
+  {
+    // The last other owner may have let go on another thread; its reads
+    // happen before the writes that follow.
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return reachability.get();
+}
+
+void InnovGenome::link_enabled(const InnovLinkGene &link)
+{
+  phenotype.reset();
+  if (not link.is_recurrent())
+  {
+    if (Reachability *reach = own_reachability())
+    {
+      reach->add_link(link.in_node_id(), link.out_node_id());
+    }
+  }
+}
+
 void InnovGenome::add_link(
         std::vector< InnovLinkGene > &llist,
         const InnovLinkGene &l)
@@ -760,6 +846,7 @@ void InnovGenome::add_node(
 }
 
 void InnovGenome::mate(
+        const NeatEnv &env,
         InnovGenome *genome1,
         InnovGenome *genome2,
         InnovGenome *offspring,
@@ -767,7 +854,7 @@ void InnovGenome::mate(
         real_t fitness2)
 {
   // Perform mating based on probabilities of differrent mating types
-  if (offspring->rng.prob() < env->mate_multipoint_prob)
+  if (offspring->rng.prob() < env.mate_multipoint_prob)
   {
     InnovGenome::mate_multipoint(genome1,
                                  genome2,
@@ -783,6 +870,46 @@ void InnovGenome::mate(
                                      fitness1,
                                      fitness2);
   }
+
+  // Parents from one species often share their topology, and then so does
+  // the offspring.
+  for (InnovGenome *parent: {genome1, genome2})
+  {
+    if (parent->phenotype and offspring->same_structure(*parent))
+    {
+      offspring->phenotype = parent->phenotype;
+      break;
+    }
+  }
+}
+
+bool InnovGenome::same_structure(const InnovGenome &other) const
+{
+  if ((nodes.size() not_eq other.nodes.size())
+      or (links.size() not_eq other.links.size()))
+  {
+    return false;
+  }
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    if ((nodes[i].node_id not_eq other.nodes[i].node_id)
+        or (nodes[i].type not_eq other.nodes[i].type))
+    {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < links.size(); i++)
+  {
+    const InnovLinkGene &a = links[i];
+    const InnovLinkGene &b = other.links[i];
+    if ((a.in_node_id() not_eq b.in_node_id())
+        or (a.out_node_id() not_eq b.out_node_id())
+        or (a.enable not_eq b.enable))
+    {
+      return false;
+    }
+  }
+  return true;
 }
 
 // TODO: use NodeLookup for newnodes instead of linear search!
@@ -810,12 +937,6 @@ void InnovGenome::mate_multipoint(
   std::vector< Trait * >::iterator p1trait;
   std::vector< Trait * >::iterator p2trait;
 
-  // iterators for moving through the two parents' links
-  std::vector< InnovLinkGene >::iterator p1gene;
-  std::vector< InnovLinkGene >::iterator p2gene;
-  // Innovation numbers for links inside parents' InnovGenomes
-  real_t p1innov;
-  real_t p2innov;
   // For checking if InnovNodeGenes exist already
   std::vector< InnovNodeGene >::iterator curnode;
   //  Set to true if we want to disabled a chosen gene
@@ -874,45 +995,26 @@ void InnovGenome::mate_multipoint(
   }
 
   // Now move through the InnovLinkGenes of each parent until both genomes end
-  p1gene = links1.begin();
-  p2gene = links2.begin();
-  while (!((p1gene == links1.end()) and (p2gene == (links2).end())))
+  GeneAlignment &alignment = get_alignment();
+  alignment.align(links1, links2);
+  for (GeneAlignment::Step step: alignment)
   {
     ProtoInnovLinkGene protogene;
+    InnovLinkGene *p1gene = links1.data() + step.i1;
+    InnovLinkGene *p2gene = links2.data() + step.i2;
 
     skip = false;  // Default to not skipping a chosen gene
 
-    if (p1gene == links1.end())
-    {
-      protogene.set_gene(genome2, &*p2gene);
-      ++p2gene;
-      // Skip excess from the worse genome
-      if (p1better)
-      { skip = true; }
-    }
-    else if (p2gene == (links2).end())
+    switch (step.type)
     {
-      protogene.set_gene(genome1, &*p1gene);
-      ++p1gene;
-      // Skip excess from the worse genome
-      if (not p1better)
-      { skip = true; }
-    }
-    else
-    {
-      // Extract current innovation numbers
-      p1innov = p1gene->innovation_num;
-      p2innov = p2gene->innovation_num;
-
-      if (std::fabs(p1innov - p2innov) < epsilon)
-      {
+      case GeneAlignment::MATCHING:
         if (rng.prob() < 0.5)
         {
-          protogene.set_gene(genome1, &*p1gene);
+          protogene.set_gene(genome1, p1gene);
         }
         else
         {
-          protogene.set_gene(genome2, &*p2gene);
+          protogene.set_gene(genome2, p2gene);
         }
 
         // If one is disabled, the corresponding gene in the offspring
@@ -922,30 +1024,20 @@ void InnovGenome::mate_multipoint(
           if (rng.prob() < 0.75)
           { disable = true; }
         }
-
-        ++p1gene;
-        ++p2gene;
-      }
-      else if (p2innov - p1innov > epsilon)
-      {
-        protogene.set_gene(genome1, &*p1gene);
-        ++p1gene;
-
+        break;
+      case GeneAlignment::DISJOINT1:
+      case GeneAlignment::EXCESS1:
+        protogene.set_gene(genome1, p1gene);
+        // Skip disjoint and excess from the worse genome
         if (not p1better)
-        {
-          skip = true;
-        }
-      }
-      else if (p1innov - p2innov > epsilon)
-      {
-        protogene.set_gene(genome2, &*p2gene);
-        ++p2gene;
-
+        { skip = true; }
+        break;
+      case GeneAlignment::DISJOINT2:
+      case GeneAlignment::EXCESS2:
+        protogene.set_gene(genome2, p2gene);
         if (p1better)
-        {
-          skip = true;
-        }
-      }
+        { skip = true; }
+        break;
     }
 
     // Check to see if the protogene conflicts with an already chosen gene
@@ -1100,12 +1192,6 @@ void InnovGenome::mate_multipoint_avg(
   // Checking for link duplication
   std::vector< InnovLinkGene >::iterator curgene2;
 
-  // iterators for moving through the two parents' links
-  std::vector< InnovLinkGene >::iterator p1gene;
-  std::vector< InnovLinkGene >::iterator p2gene;
-  // Innovation numbers for links inside parents' InnovGenomes
-  real_t p1innov;
-  real_t p2innov;
   // For checking if InnovNodeGenes exist already
   std::vector< InnovNodeGene >::iterator curnode;
 
@@ -1170,41 +1256,21 @@ void InnovGenome::mate_multipoint_avg(
   }
 
   // Now move through the InnovLinkGenes of each parent until both genomes end
-  p1gene = links1.begin();
-  p2gene = links2.begin();
-  while (!((p1gene == links1.end()) and (p2gene == (links2).end())))
+  GeneAlignment &alignment = get_alignment();
+  alignment.align(links1, links2);
+  for (GeneAlignment::Step step: alignment)
   {
     ProtoInnovLinkGene protogene;
+    InnovLinkGene *p1gene = links1.data() + step.i1;
+    InnovLinkGene *p2gene = links2.data() + step.i2;
 
     avgene.enable = true;  // Default to enabled
 
     skip = false;
 
-    if (p1gene == links1.end())
+    switch (step.type)
     {
-      protogene.set_gene(genome2, &*p2gene);
-      ++p2gene;
-
-      if (p1better)
-      { skip = true; }
-    }
-    else if (p2gene == (links2).end())
-    {
-      protogene.set_gene(genome1, &*p1gene);
-      ++p1gene;
-
-      if (not p1better)
-      { skip = true; }
-    }
-    else
-    {
-      // Extract current innovation numbers
-      p1innov = p1gene->innovation_num;
-      p2innov = p2gene->innovation_num;
-
-      real_t epsilon = 0.0000001;
-      if (std::fabs(p1innov - p2innov) < epsilon)
-      {
+      case GeneAlignment::MATCHING:
         protogene.set_gene(nullptr, &avgene);
 
         // Average them into the avgene
@@ -1252,26 +1318,19 @@ void InnovGenome::mate_multipoint_avg(
           if (rng.prob() < 0.75)
           { avgene.enable = false; }
         }
-
-        ++p1gene;
-        ++p2gene;
-      }
-      else if (p1innov < p2innov)
-      {
-        protogene.set_gene(genome1, &*p1gene);
-        ++p1gene;
-
+        break;
+      case GeneAlignment::DISJOINT1:
+      case GeneAlignment::EXCESS1:
+        protogene.set_gene(genome1, p1gene);
         if (not p1better)
         { skip = true; }
-      }
-      else if (p2innov < p1innov)
-      {
-        protogene.set_gene(genome2, &*p2gene);
-        ++p2gene;
-
+        break;
+      case GeneAlignment::DISJOINT2:
+      case GeneAlignment::EXCESS2:
+        protogene.set_gene(genome2, p2gene);
         if (p1better)
         { skip = true; }
-      }
+        break;
     }
 
     // Check to see if the chosengene conflicts with an already chosen gene
@@ -1400,87 +1459,211 @@ void InnovGenome::mate_multipoint_avg(
   }
 }
 
-real_t InnovGenome::compatibility(InnovGenome *g)
+// The first step of a bounded compatibility test, before any alignment.
+// Returns true with the result in lower if the difference in length alone
+// reaches the bound. Otherwise max_disjoint is set to the smallest number
+// of disjoint genes that does; the mutational difference term is never
+// negative, so the alignment can stop there.
+static bool compat_lower_bound(
+        const NeatEnv &env,
+        size_t n1,
+        size_t n2,
+        real_t bound,
+        real_t &lower,
+        size_t &max_disjoint)
 {
-  std::vector< InnovLinkGene > &links1 = this->links;
-  std::vector< InnovLinkGene > &links2 = g->links;
+  const real_t disjoint_coeff = env.disjoint_coeff;
 
-  // Innovation numbers
-  real_t p1innov;
-  real_t p2innov;
+  // At least the difference in length is disjoint or excess.
+  size_t ndiff = n1 > n2 ? n1 - n2 : n2 - n1;
+  lower = std::min(disjoint_coeff, env.excess_coeff) * ndiff;
+  if (lower >= bound)
+  {
+    return true;
+  }
 
-  // Intermediate value
-  real_t mut_diff;
+  max_disjoint = std::numeric_limits< size_t >::max();
+  if ((disjoint_coeff > 0.0) and (bound / disjoint_coeff <= n1 + n2))
+  {
+    max_disjoint = std::max< real_t >(1.0, std::ceil(bound / disjoint_coeff));
+    while ((max_disjoint > 1)
+           and (disjoint_coeff * (max_disjoint - 1) >= bound))
+    {
+      max_disjoint--;
+    }
+    while (disjoint_coeff * max_disjoint < bound)
+    {
+      max_disjoint++;
+    }
+  }
+  return false;
+}
 
-  // Set up the counters
-  real_t num_disjoint = 0.0;
-  real_t num_excess = 0.0;
-  real_t mut_diff_total = 0.0;
-  real_t num_matching = 0.0;  // Used to normalize mutation_num differences
+// Reads mutation numbers straight out of the link genes
+struct LinkMutations
+{
+  const InnovLinkGene *links;
 
-  // Now move through the InnovLinkGenes of each potential parent
-  // until both InnovGenomes end
-  std::vector< InnovLinkGene >::iterator p1gene = links1.begin();
-  std::vector< InnovLinkGene >::iterator p2gene = links2.begin();
+  real_t operator[](size_t i) const
+  {
+    return links[i].mutation_num;
+  }
+};
 
-  real_t epsilon = 0.0000001;
-  while (!((p1gene == links1.end()) and (p2gene == links2.end())))
+// Sums up the terms of the compatibility formula while the genes are
+// aligned, so the link genes are only read once.
+template < typename Mut1, typename Mut2 >
+struct CompatVisitor
+{
+  Mut1 mut1;
+  Mut2 mut2;
+  real_t num_disjoint;
+  real_t num_excess;
+  real_t num_matching;
+  real_t mut_diff_total;
+
+  CompatVisitor(
+          Mut1 mut1_,
+          Mut2 mut2_)
+          : mut1(mut1_)
+          , mut2(mut2_)
+          , num_disjoint(0.0)
+          , num_excess(0.0)
+          , num_matching(0.0)
+          , mut_diff_total(0.0)
+  {}
+
+  void operator()(
+          GeneAlignment::SpanType type,
+          size_t i1,
+          size_t i2,
+          size_t len)
   {
-    if (p1gene == links1.end())
+    switch (type)
     {
-      ++p2gene;
-      num_excess += 1.0;
+      case GeneAlignment::MATCHING:
+        for (size_t k = 0; k < len; k++)
+        {
+          mut_diff_total += std::fabs(mut1[i1 + k] - mut2[i2 + k]);
+        }
+        num_matching += len;
+        break;
+      case GeneAlignment::DISJOINT1:
+      case GeneAlignment::DISJOINT2:
+        num_disjoint += len;
+        break;
+      default:
+        num_excess += len;
+        break;
     }
-    else if (p2gene == links2.end())
+  }
+
+  // If the alignment gave up early, only the disjoint genes found so far
+  // are counted.
+  real_t score(
+          const NeatEnv &env,
+          bool complete) const
+  {
+    if (not complete)
     {
-      ++p1gene;
-      num_excess += 1.0;
+      return env.disjoint_coeff * num_disjoint;
     }
-    else
-    {
-      // Extract current innovation numbers
-      p1innov = p1gene->innovation_num;
-      p2innov = p2gene->innovation_num;
 
-      if (std::fabs(p1innov - p2innov) < epsilon)
-      {
-        num_matching += 1.0;
-        mut_diff = p1gene->mutation_num - p2gene->mutation_num;
-        if (mut_diff < 0.0)
-        { mut_diff = 0.0 - mut_diff; }
-        mut_diff_total += mut_diff;
-
-        ++p1gene;
-        ++p2gene;
-      }
-      else if (p1innov < p2innov)
-      {
-        ++p1gene;
-        num_disjoint += 1.0;
-      }
-      else if (p2innov < p1innov)
-      {
-        ++p2gene;
-        num_disjoint += 1.0;
-      }
-    }
-  }  // End while
+    // Return the compatibility number using compatibility formula
+    // Note that mut_diff_total/num_matching gives the AVERAGE
+    // difference between mutation_nums for any two matching InnovLinkGenes
+    // in the InnovGenome
+
+    // Normalizing for genome size
+    // return (disjoint_coeff*(num_disjoint/max_genome_size)+
+    // excess_coeff*(num_excess/max_genome_size)+
+    // mutdiff_coeff*(mut_diff_total/num_matching));
 
-  // Return the compatibility number using compatibility formula
-  // Note that mut_diff_total/num_matching gives the AVERAGE
-  // difference between mutation_nums for any two matching InnovLinkGenes
-  // in the InnovGenome
+    // Look at disjointedness and excess in the absolute (ignoring size)
+    return (env.disjoint_coeff * (num_disjoint / 1.0) +
+            env.excess_coeff * (num_excess / 1.0) +
+            env.mutdiff_coeff * (mut_diff_total / num_matching));
+  }
+};
+
+real_t InnovGenome::compatibility(
+        const NeatEnv &env,
+        InnovGenome *g)
+{
+  return compatibility(env, g, std::numeric_limits< real_t >::infinity());
+}
 
-  // Normalizing for genome size
-  // return (disjoint_coeff*(num_disjoint/max_genome_size)+
-  // excess_coeff*(num_excess/max_genome_size)+
-  // mutdiff_coeff*(mut_diff_total/num_matching));
+void InnovGenome::get_compat_links(CompatLinks &result) const
+{
+  result.innovation_num.resize(links.size());
+  result.mutation_num.resize(links.size());
+  for (size_t i = 0; i < links.size(); i++)
+  {
+    result.innovation_num[i] = links[i].innovation_num;
+    result.mutation_num[i] = links[i].mutation_num;
+  }
+}
 
-  // Look at disjointedness and excess in the absolute (ignoring size)
+real_t InnovGenome::compatibility(
+        const NeatEnv &env,
+        InnovGenome *g,
+        real_t bound)
+{
+  real_t lower;
+  size_t max_disjoint;
+  if (compat_lower_bound(env,
+                         links.size(),
+                         g->links.size(),
+                         bound,
+                         lower,
+                         max_disjoint))
+  {
+    return lower;
+  }
+
+  CompatVisitor< LinkMutations, LinkMutations > visitor(
+          LinkMutations{links.data()},
+          LinkMutations{g->links.data()});
+  bool complete = GeneAlignment::walk(
+          GeneAlignment::Innovations< InnovLinkGene >{links.data()},
+          links.size(),
+          GeneAlignment::Innovations< InnovLinkGene >{g->links.data()},
+          g->links.size(),
+          0,
+          max_disjoint,
+          visitor);
+  return visitor.score(env, complete);
+}
+
+real_t InnovGenome::compatibility(
+        const NeatEnv &env,
+        const CompatLinks &links_,
+        real_t bound)
+{
+  real_t lower;
+  size_t max_disjoint;
+  if (compat_lower_bound(env,
+                         links.size(),
+                         links_.innovation_num.size(),
+                         bound,
+                         lower,
+                         max_disjoint))
+  {
+    return lower;
+  }
 
-  return (env->disjoint_coeff * (num_disjoint / 1.0) +
-          env->excess_coeff * (num_excess / 1.0) +
-          env->mutdiff_coeff * (mut_diff_total / num_matching));
+  CompatVisitor< LinkMutations, const real_t * > visitor(
+          LinkMutations{links.data()},
+          links_.mutation_num.data());
+  bool complete = GeneAlignment::walk(
+          GeneAlignment::Innovations< InnovLinkGene >{links.data()},
+          links.size(),
+          links_.innovation_num.data(),
+          links_.innovation_num.size(),
+          0,
+          max_disjoint,
+          visitor);
+  return visitor.score(env, complete);
 }
 
 real_t InnovGenome::trait_compare(
@@ -1551,15 +1734,42 @@ Trait &InnovGenome::get_trait(const InnovLinkGene &gene)
   return ::get_trait(traits, gene.trait_id());
 }
 
-void InnovGenome::init_phenotype(Network &net)
+const link_size_t InnovGenome::NO_NETLINK;
+
+// Scratch space for init_phenotype(); every thread reuses its own buffers.
+namespace
+{
+  struct PhenotypeScratch
+  {
+    std::vector< NetLink > netlinks;
+    std::vector< link_size_t > netlink_gene;
+    std::vector< link_size_t > node_nlinks;
+    std::vector< node_size_t > node_index;
+    std::vector< NetNode > netnodes;
+    std::vector< real_t > weights;
+  };
+}
+
+static PhenotypeScratch &get_phenotype_scratch()
 {
+  static thread_local PhenotypeScratch scratch;
+  return scratch;
+}
+
+void InnovGenome::build_phenotype(Network &net)
+{
+  PhenotypeScratch &scratch = get_phenotype_scratch();
   size_t nnodes = nodes.size();
   assert(nnodes <= NODES_MAX);
 
+  std::shared_ptr< Phenotype > result = std::make_shared< Phenotype >();
+  static std::atomic< uint64_t > last_id(0);
+  result->id = ++last_id;
+
   ///
   /// Count how many of each type of node.
   ///
-  NetDims dims;
+  NetDims &dims = result->dims;
   std::memset(&dims, 0, sizeof(dims));
 
   for (size_t i = 0; i < nnodes; i++)
@@ -1588,23 +1798,44 @@ void InnovGenome::init_phenotype(Network &net)
   dims.nnodes.input = dims.nnodes.bias + dims.nnodes.sensor;
   dims.nnodes.noninput = dims.nnodes.output + dims.nnodes.hidden;
 
+  // Direct map from node ID to index. Links only refer to nodes of this
+  // genome, so the slots of other IDs are never read and needn't be cleared.
+  std::vector< node_size_t > &node_index = scratch.node_index;
+  if (node_index.size() <= size_t(nodes.back().node_id))
+  {
+    node_index.resize(nodes.back().node_id + 1);
+  }
+  for (size_t i = 0; i < nnodes; i++)
+  {
+    node_index[nodes[i].node_id] = i;
+  }
+
   ///
   /// Create unsorted array of links, converting node ID to index in process.
   ///
-  auto netlinks = new NetLink[links.size()];
+  std::vector< NetLink > &netlinks = scratch.netlinks;
+  std::vector< link_size_t > &netlink_gene = scratch.netlink_gene;
+  std::vector< link_size_t > &node_nlinks = scratch.node_nlinks;
+  netlinks.resize(links.size());
+  netlink_gene.resize(links.size());
+  node_nlinks.assign(nnodes, 0);
   size_t nlinks = 0;
-  auto node_nlinks = new size_t[nnodes];
-  memset(node_nlinks, 0, sizeof(size_t) * nnodes);
 
-  for (InnovLinkGene &link: links)
+  result->gene_netlink.resize(links.size());
+  for (size_t i = 0; i < links.size(); i++)
   {
+    InnovLinkGene &link = links[i];
+    result->gene_netlink[i] = NO_NETLINK;
     if (link.enable)
     {
+      netlink_gene[nlinks] = i;
       NetLink &netlink = netlinks[nlinks++];
 
       netlink.weight = link.weight();
-      netlink.in_node_index = get_node_index(link.in_node_id());
-      netlink.out_node_index = get_node_index(link.out_node_id());
+      netlink.in_node_index = node_index[link.in_node_id()];
+      netlink.out_node_index = node_index[link.out_node_id()];
+      assert(netlink.in_node_index == get_node_index(link.in_node_id()));
+      assert(netlink.out_node_index == get_node_index(link.out_node_id()));
 
       node_nlinks[netlink.out_node_index]++;
     }
@@ -1616,7 +1847,8 @@ void InnovGenome::init_phenotype(Network &net)
   ///
   /// Determine layout of links for each node in sorted array
   ///
-  auto netnodes = new NetNode[nnodes];
+  std::vector< NetNode > &netnodes = result->netnodes;
+  netnodes.resize(nnodes);
   netnodes[0].incoming_start = 0;
   netnodes[0].incoming_end = node_nlinks[0];
   for (size_t i = 1; i < nnodes; i++)
@@ -1630,27 +1862,109 @@ void InnovGenome::init_phenotype(Network &net)
   assert(netnodes[nnodes - 1].incoming_end == nlinks);
 
   ///
-  /// Create sorted links
+  /// Create sorted links, remembering where each gene went
   ///
-  memset(node_nlinks, 0, sizeof(size_t) * nnodes);
-  auto *netlinks_sorted = new NetLink[nlinks];
+  std::fill(node_nlinks.begin(), node_nlinks.end(), 0);
+  result->netlinks.resize(nlinks);
   for (size_t i = 0; i < nlinks; i++)
   {
     NetLink &netlink = netlinks[i];
     size_t inode = netlink.out_node_index;
     size_t isorted = netnodes[inode].incoming_start + node_nlinks[inode]++;
-    netlinks_sorted[isorted] = netlink;
+    result->netlinks[isorted] = netlink;
+    result->gene_netlink[netlink_gene[i]] = isorted;
   }
 
   ///
   /// Configure the net
   ///
-  net.configure(dims, netnodes, netlinks_sorted);
+  net.configure(dims, netnodes.data(), result->netlinks.data());
+  net.layout_id = result->id;
+
+  phenotype = result;
+}
+
+void InnovGenome::init_phenotype(Network &net)
+{
+  // Genomes that went through a structural mutation since they were
+  // duplicated have lost their layout; anything else only needs weights.
+  if (not phenotype
+      or (phenotype->gene_netlink.size() not_eq links.size())
+      or (phenotype->dims.nnodes.all not_eq nodes.size()))
+  {
+    build_phenotype(net);
+    return;
+  }
+  const Phenotype &pheno = *phenotype;
+
+#ifndef NDEBUG
+  for (size_t i = 0; i < links.size(); i++)
+  {
+    link_size_t k = pheno.gene_netlink[i];
+    assert(links[i].enable == (k not_eq NO_NETLINK));
+    assert((k == NO_NETLINK)
+           or ((pheno.netlinks[k].in_node_index
+                == get_node_index(links[i].in_node_id()))
+               and (pheno.netlinks[k].out_node_index
+                    == get_node_index(links[i].out_node_id()))));
+  }
+#endif
+
+  PhenotypeScratch &scratch = get_phenotype_scratch();
+  std::vector< real_t > &weights = scratch.weights;
+  weights.resize(pheno.dims.nlinks);
+  for (size_t i = 0; i < links.size(); i++)
+  {
+    link_size_t k = pheno.gene_netlink[i];
+    if (k not_eq NO_NETLINK)
+    {
+      weights[k] = links[i].weight();
+    }
+  }
+
+  if ((net.layout_id == pheno.id) and net.update_weights(weights.data()))
+  {
+    return;
+  }
+
+  scratch.netnodes.assign(pheno.netnodes.begin(), pheno.netnodes.end());
+  scratch.netlinks.assign(pheno.netlinks.begin(), pheno.netlinks.end());
+  for (size_t k = 0; k < pheno.dims.nlinks; k++)
+  {
+    scratch.netlinks[k].weight = weights[k];
+  }
+  net.configure(pheno.dims, scratch.netnodes.data(), scratch.netlinks.data());
+  net.layout_id = pheno.id;
+}
+
+uint64_t InnovGenome::get_layout_id() const
+{
+  return phenotype ? phenotype->id : 0;
+}
 
-  delete[]netlinks;
-  delete[]node_nlinks;
-  delete[]netnodes;
-  delete[]netlinks_sorted;
+uint64_t InnovGenome::get_hash(real_t weight_quantum) const
+{
+  // Only what build_phenotype() reads: disabled links, traits and the
+  // innovation numbers don't change the network.
+  uint64_t h = FitnessCache::combine(nodes.size(), links.size());
+  for (const InnovNodeGene &node: nodes)
+  {
+    h = FitnessCache::combine(h, static_cast< uint32_t >(node.node_id));
+    h = FitnessCache::combine(h, node.type);
+  }
+  for (const InnovLinkGene &link: links)
+  {
+    if (link.enable)
+    {
+      h = FitnessCache::combine(h, static_cast< uint32_t >(link.in_node_id()));
+      h = FitnessCache::combine(h,
+                                static_cast< uint32_t >(link.out_node_id()));
+      h = FitnessCache::combine(h,
+                                FitnessCache::quantize(link.weight(),
+                                                       weight_quantum));
+    }
+  }
+  return h == 0 ? 1 : h;
 }
 
 InnovLinkGene *InnovGenome::find_link(
@@ -1706,6 +2020,7 @@ void InnovGenome::delete_if_orphaned_hidden_node(int node_id)
     auto iterator = nodes.begin() + (node - nodes.data());
     assert(iterator->node_id == node_id);
     nodes.erase(iterator);
+    structure_changed();
   }
 }
 
@@ -1719,23 +2034,12 @@ void InnovGenome::delete_link(InnovLinkGene *link)
                           });
   assert(iterator not_eq links.end());
   links.erase(iterator);
-}
-
-InnovNodeGene &InnovNodeGene::operator=(const NEAT::InnovNodeGene &other)
-{
-  creator_name = other.creator_name;
-  creator_index = other.creator_index;
-  type = other.type;
-  node_id = other.node_id;
-  frozen = other.frozen;
-  trait_id = other.trait_id;
-
-  return *this;
+  structure_changed();
 }
 
 void InnovNodeGene::set_creator_name(const std::string &creator_name)
 {
-  InnovNodeGene::creator_name = creator_name;
+  creator_id = StringTable::creators().intern(creator_name);
 }
 
 void InnovNodeGene::set_creator_index(int creator_index)
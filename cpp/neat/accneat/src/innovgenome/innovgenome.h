@@ -38,14 +38,18 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "genome.h"
+#include "network/network.h"
 #include "innovlinkgene.h"
 #include "innovnodegene.h"
 #include "innovnodelookup.h"
 #include "innovation.h"
+#include "reachability.h"
 
 namespace NEAT
 {
@@ -101,6 +105,9 @@ namespace NEAT
     /// \brief Load genome from specified file
     virtual bool load(std::istream &in) override;
 
+    /// \brief Load genome from a parsed YAML document
+    bool load(const YAML::Node &config);
+
     void duplicate_into(InnovGenome *offspring) const;
 
     InnovGenome &operator=(const InnovGenome &other);
@@ -117,7 +124,7 @@ namespace NEAT
     // ******* MUTATORS *******
 
     /// \brief Perturb params in one trait
-    void mutate_random_trait();
+    void mutate_random_trait(const NeatEnv &env);
 
     /// \brief Change random link's trait. Repeat times times
     void mutate_link_trait(int times);
@@ -157,11 +164,13 @@ namespace NEAT
     /// \brief Mutate the genome by adding a new link between 2
     /// random InnovNodeGenes
     bool mutate_add_link(
+            const NeatEnv &env,
             CreateInnovationFunc create_innov,
             int tries);
 
     // ****** MATING METHODS *****
     static void mate(
+            const NeatEnv &env,
             InnovGenome *genome1,
             InnovGenome *genome2,
             InnovGenome *offspring,
@@ -201,7 +210,34 @@ namespace NEAT
     ///   MATCHING GENES.  So the formula for compatibility
     ///   is:  disjoint_coeff*pdg+excess_coeff*peg+mutdiff_coeff*mdmg.
     ///   The 3 coefficients are global system parameters
-    real_t compatibility(InnovGenome *g);
+    real_t compatibility(
+            const NeatEnv &env,
+            InnovGenome *g);
+
+    /// \brief The part of the link genes that compatibility() looks at
+    struct CompatLinks
+    {
+      std::vector< int32_t > innovation_num;
+      std::vector< real_t > mutation_num;
+    };
+
+    /// \brief Copies the links into the compact form used for repeatedly
+    /// testing other genomes against this one.
+    void get_compat_links(CompatLinks &result) const;
+
+    /// \brief Like compatibility(g), but gives up as soon as the result is
+    ///   known to be at least bound. Results below bound are exact; otherwise
+    ///   some value >= bound is returned.
+    real_t compatibility(
+            const NeatEnv &env,
+            InnovGenome *g,
+            real_t bound);
+
+    /// \brief Bounded compatibility against links from get_compat_links()
+    real_t compatibility(
+            const NeatEnv &env,
+            const CompatLinks &links,
+            real_t bound);
 
     /// \brief
     real_t trait_compare(
@@ -223,12 +259,30 @@ namespace NEAT
     /// \brief
     node_size_t get_node_index(int id);
 
-    /// \brief
+    /// \brief Configures net from this genome. Genomes that only differ in
+    /// their weights share the node and link layout, so the net is only
+    /// rebuilt after a structural change; a net that already has the layout
+    /// just gets its weights replaced.
     virtual void init_phenotype(class Network &net) override;
 
+    /// \brief
+    virtual uint64_t get_layout_id() const override;
+
+    /// \brief Hashes the nodes and the enabled links, in gene order
+    virtual uint64_t get_hash(real_t weight_quantum) const override;
+
     public:
     void reset();
 
+    /// \brief Must be called whenever nodes, links or link enable flags are
+    /// changed from outside the mutators. Weight and trait changes don't
+    /// matter.
+    void structure_changed()
+    {
+      phenotype.reset();
+      reachability.reset();
+    }
+
     static bool linklist_cmp(
             const InnovLinkGene &a,
             const InnovLinkGene &b)
@@ -263,6 +317,52 @@ namespace NEAT
 
     /// \brief
     InnovNodeLookup node_lookup;
+
+    /// \brief Network layout built from nodes and links
+    struct Phenotype
+    {
+      /// \brief Unique for the lifetime of the process, never 0
+      uint64_t id;
+
+      NetDims dims;
+
+      std::vector< NetNode > netnodes;
+
+      /// \brief Links sorted by output node. The weights are those of the
+      /// genome that built the layout; they are replaced on every use.
+      std::vector< NetLink > netlinks;
+
+      /// \brief Index in netlinks of every link gene, or NO_NETLINK for
+      /// disabled links.
+      std::vector< link_size_t > gene_netlink;
+    };
+
+    static const link_size_t NO_NETLINK = LINKS_MAX;
+
+    /// \brief True if other has the same nodes and enabled links, in the
+    /// same order, and so the same phenotype layout
+    bool same_structure(const InnovGenome &other) const;
+
+    /// \brief Builds phenotype from the current nodes and links, and
+    /// configures net with it
+    void build_phenotype(class Network &net);
+
+    /// \brief Layout shared by the genomes duplicated from this one, or
+    /// null when the structure has changed since it was built.
+    std::shared_ptr< const Phenotype > phenotype;
+
+    /// \brief Index of the forward links, built by mutate_add_link() and
+    /// shared by the genomes duplicated from this one until one of them
+    /// changes it. Null when it has to be rebuilt.
+    std::shared_ptr< Reachability > reachability;
+
+    /// \brief The reachability index, if there is one, made private to this
+    /// genome so it can be updated
+    Reachability *own_reachability();
+
+    /// \brief Notes that link was enabled or added. Unlike
+    /// structure_changed(), this keeps the reachability index.
+    void link_enabled(const InnovLinkGene &link);
   };
 }
 
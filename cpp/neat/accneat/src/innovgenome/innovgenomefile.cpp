@@ -0,0 +1,322 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Binary file of one or more InnovGenomes
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include "innovgenomefile.h"
+
+using namespace NEAT;
+using namespace std;
+
+namespace
+{
+  const char MAGIC[8] = {'A', 'C', 'C', 'N', 'E', 'A', 'T', 'G'};
+
+  struct FileHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t ncreators;
+    uint64_t ngenomes;
+  };
+
+  struct GenomeHeader
+  {
+    int32_t genome_id;
+    uint32_t reserved;
+    uint64_t ntraits;
+    uint64_t nnodes;
+    uint64_t nlinks;
+  };
+
+  static_assert(sizeof(InnovGenomeFile::TraitRecord) == 72
+                and sizeof(InnovGenomeFile::NodeRecord) == 24
+                and sizeof(InnovGenomeFile::LinkRecord) == 48,
+                "records must keep their layout; bump VERSION if they change");
+
+  static_assert(alignof(InnovGenomeFile::TraitRecord) == 8
+                and alignof(InnovGenomeFile::NodeRecord) == 4
+                and alignof(InnovGenomeFile::LinkRecord) == 8,
+                "records must keep their alignment");
+}
+
+bool InnovGenomeFile::save(
+        const string &path,
+        const vector< const InnovGenome * > &genomes)
+{
+  if (not is_little_endian())
+  {
+    clog << "binary genome files are only supported on little-endian hosts"
+         << endl;
+    return false;
+  }
+
+  ofstream out(path, ios::out | ios::binary | ios::trunc);
+  BinaryWriter writer(out);
+
+  // The file stores only the creator names its genes use. Their file-local
+  // ids follow the order of the process-wide ids.
+  StringTable &creators = StringTable::creators();
+  map< StringTable::id_t, StringTable::id_t > file_ids;
+  for (const InnovGenome *genome: genomes)
+  {
+    for (const InnovNodeGene &node: genome->nodes)
+    {
+      file_ids[node.creator_id] = 0;
+    }
+    for (const InnovLinkGene &link: genome->links)
+    {
+      file_ids[link.creator_id] = 0;
+    }
+  }
+  file_ids.erase(file_ids.begin(), file_ids.lower_bound(0));
+  StringTable::id_t nfile_ids = 0;
+  for (auto &ids: file_ids)
+  {
+    ids.second = nfile_ids++;
+  }
+  auto file_id = [&file_ids](StringTable::id_t id)
+  {
+    auto it = file_ids.find(id);
+    return it == file_ids.end() ? StringTable::id_t(-1) : it->second;
+  };
+
+  FileHeader header;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.ncreators = file_ids.size();
+  header.ngenomes = genomes.size();
+  writer.write(header);
+
+  for (const auto &ids: file_ids)
+  {
+    writer.write_string(creators.lookup(ids.first));
+  }
+
+  vector< TraitRecord > traits;
+  vector< NodeRecord > nodes;
+  vector< LinkRecord > links;
+  for (const InnovGenome *genome: genomes)
+  {
+    GenomeHeader genome_header;
+    genome_header.genome_id = genome->genome_id;
+    genome_header.reserved = 0;
+    genome_header.ntraits = genome->traits.size();
+    genome_header.nnodes = genome->nodes.size();
+    genome_header.nlinks = genome->links.size();
+    writer.align(alignof(GenomeHeader));
+    writer.write(genome_header);
+
+    traits.resize(genome->traits.size());
+    for (size_t i = 0; i < traits.size(); i++)
+    {
+      const Trait &trait = genome->traits[i];
+      TraitRecord &record = traits[i];
+      memset(&record, 0, sizeof(record));
+      record.trait_id = trait.trait_id;
+      for (int j = 0; j < NUM_TRAIT_PARAMS; j++)
+      {
+        record.params[j] = trait.params[j];
+      }
+    }
+
+    nodes.resize(genome->nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+      const InnovNodeGene &node = genome->nodes[i];
+      NodeRecord &record = nodes[i];
+      memset(&record, 0, sizeof(record));
+      record.node_id = node.node_id;
+      record.trait_id = node.trait_id;
+      record.creator_id = file_id(node.creator_id);
+      record.creator_index = node.creator_index;
+      record.type = node.type;
+      record.frozen = node.frozen;
+    }
+
+    links.resize(genome->links.size());
+    for (size_t i = 0; i < links.size(); i++)
+    {
+      const InnovLinkGene &link = genome->links[i];
+      LinkRecord &record = links[i];
+      memset(&record, 0, sizeof(record));
+      record.weight = link._weight;
+      record.mutation_num = link.mutation_num;
+      record.innovation_num = link.innovation_num;
+      record.in_node_id = link._in_node_id;
+      record.out_node_id = link._out_node_id;
+      record.trait_id = link._trait_id;
+      record.creator_id = file_id(link.creator_id);
+      record.creator_index = link.creator_index;
+      record.is_recurrent = link._is_recurrent;
+      record.enable = link.enable;
+      record.frozen = link.frozen;
+    }
+
+    writer.write_array(traits.data(), traits.size());
+    writer.write_array(nodes.data(), nodes.size());
+    writer.write_array(links.data(), links.size());
+  }
+
+  out.flush();
+  return writer.good();
+}
+
+bool InnovGenomeFile::open(const string &path)
+{
+  _views.clear();
+  _creators.clear();
+  _creator_ids.clear();
+
+  if (not is_little_endian())
+  {
+    clog << "binary genome files are only supported on little-endian hosts"
+         << endl;
+    return false;
+  }
+
+  if (not _file.open(path))
+  {
+    clog << "impossible to open genome file \"" << path << "\"" << endl;
+    return false;
+  }
+
+  BinaryReader reader(_file.data(), _file.size());
+  FileHeader header = reader.read< FileHeader >();
+  if (not reader.good() or memcmp(header.magic, MAGIC, sizeof(MAGIC)) not_eq 0)
+  {
+    clog << "\"" << path << "\" is not a binary genome file" << endl;
+    return false;
+  }
+  if (header.version not_eq VERSION)
+  {
+    clog << "\"" << path << "\" has unsupported version " << header.version
+         << endl;
+    return false;
+  }
+
+  // Every creator name takes at least its length and every genome at least
+  // its header, so larger counts can't be right and mustn't be reserved.
+  if ((header.ncreators > reader.remaining() / sizeof(uint32_t))
+      or (header.ngenomes > reader.remaining() / sizeof(GenomeHeader)))
+  {
+    clog << "\"" << path << "\" is truncated or corrupt" << endl;
+    return false;
+  }
+
+  _creators.reserve(header.ncreators);
+  _creator_ids.reserve(header.ncreators);
+  for (uint32_t i = 0; i < header.ncreators and reader.good(); i++)
+  {
+    _creators.push_back(reader.read_string());
+    _creator_ids.push_back(StringTable::creators().intern(_creators.back()));
+  }
+
+  _views.reserve(header.ngenomes);
+  for (uint64_t i = 0; i < header.ngenomes and reader.good(); i++)
+  {
+    reader.align(alignof(GenomeHeader));
+    GenomeHeader genome_header = reader.read< GenomeHeader >();
+
+    View view;
+    view.genome_id = genome_header.genome_id;
+    view.ntraits = genome_header.ntraits;
+    view.traits = reader.read_array< TraitRecord >(view.ntraits);
+    view.nnodes = genome_header.nnodes;
+    view.nodes = reader.read_array< NodeRecord >(view.nnodes);
+    view.nlinks = genome_header.nlinks;
+    view.links = reader.read_array< LinkRecord >(view.nlinks);
+    _views.push_back(view);
+  }
+
+  if (not reader.good())
+  {
+    clog << "\"" << path << "\" is truncated" << endl;
+    _views.clear();
+    return false;
+  }
+
+  return true;
+}
+
+StringTable::id_t InnovGenomeFile::creator_id(StringTable::id_t file_id) const
+{
+  if ((file_id < 0) or (size_t(file_id) >= _creator_ids.size()))
+  {
+    return StringTable::EMPTY;
+  }
+  return _creator_ids[file_id];
+}
+
+void InnovGenomeFile::load(
+        size_t i,
+        InnovGenome &genome) const
+{
+  const View &view = _views[i];
+
+  genome.genome_id = view.genome_id;
+
+  genome.traits.resize(view.ntraits);
+  for (size_t i = 0; i < view.ntraits; i++)
+  {
+    const TraitRecord &record = view.traits[i];
+    Trait &trait = genome.traits[i];
+    trait.trait_id = record.trait_id;
+    for (int j = 0; j < NUM_TRAIT_PARAMS; j++)
+    {
+      trait.params[j] = real_t(record.params[j]);
+    }
+  }
+
+  genome.nodes.resize(view.nnodes);
+  for (size_t i = 0; i < view.nnodes; i++)
+  {
+    const NodeRecord &record = view.nodes[i];
+    InnovNodeGene &node = genome.nodes[i];
+    node.node_id = record.node_id;
+    node.trait_id = record.trait_id;
+    node.creator_id = creator_id(record.creator_id);
+    node.creator_index = record.creator_index;
+    node.type = nodetype(record.type);
+    node.frozen = record.frozen not_eq 0;
+  }
+
+  genome.links.resize(view.nlinks);
+  for (size_t i = 0; i < view.nlinks; i++)
+  {
+    const LinkRecord &record = view.links[i];
+    InnovLinkGene &link = genome.links[i];
+    link._weight = real_t(record.weight);
+    link.mutation_num = real_t(record.mutation_num);
+    link.innovation_num = record.innovation_num;
+    link._in_node_id = record.in_node_id;
+    link._out_node_id = record.out_node_id;
+    link._trait_id = record.trait_id;
+    link.creator_id = creator_id(record.creator_id);
+    link.creator_index = record.creator_index;
+    link._is_recurrent = record.is_recurrent not_eq 0;
+    link.enable = record.enable not_eq 0;
+    link.frozen = record.frozen not_eq 0;
+  }
+
+  genome.structure_changed();
+}
@@ -0,0 +1,162 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Binary file of one or more InnovGenomes
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_INNOVGENOME_INNOVGENOMEFILE_H_
+#define CPP_NEAT_ACCNEAT_SRC_INNOVGENOME_INNOVGENOMEFILE_H_
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "innovgenome.h"
+#include "util/binaryio.h"
+#include "util/stringtable.h"
+
+namespace NEAT
+{
+  ///
+  /// CLASS InnovGenomeFile
+  ///
+  /// Binary counterpart of InnovGenome::save()/load(), for a single genome
+  /// or a whole population. The file is versioned and little-endian:
+  ///
+  ///   header   magic "ACCNEATG", version, number of creator names and of
+  ///            genomes
+  ///   creators the creator names referenced by the genes
+  ///   genomes  per genome its id and the number of traits, nodes and
+  ///            links, followed by the three arrays of records
+  ///
+  /// The records below have a fixed layout of fixed-width fields,
+  /// independent of real_t and of the in-memory genes. An opened file is
+  /// used in place: get() returns pointers into the mapping and load()
+  /// converts the records to genes. Any change to a record needs a new
+  /// VERSION.
+  ///
+  class InnovGenomeFile
+  {
+    public:
+    static const uint32_t VERSION = 2;
+
+    /// \brief A Trait
+    struct TraitRecord
+    {
+      int32_t trait_id;
+      uint32_t pad;
+      double params[NUM_TRAIT_PARAMS];
+    };
+
+    /// \brief An InnovNodeGene
+    struct NodeRecord
+    {
+      int32_t node_id;
+      int32_t trait_id;
+      int32_t creator_id;
+      int32_t creator_index;
+      uint32_t type;
+      uint8_t frozen;
+      uint8_t pad[3];
+    };
+
+    /// \brief An InnovLinkGene
+    struct LinkRecord
+    {
+      double weight;
+      double mutation_num;
+      int32_t innovation_num;
+      int32_t in_node_id;
+      int32_t out_node_id;
+      int32_t trait_id;
+      int32_t creator_id;
+      int32_t creator_index;
+      uint8_t is_recurrent;
+      uint8_t enable;
+      uint8_t frozen;
+      uint8_t pad[5];
+    };
+
+    /// \brief A genome inside the mapped file. Creator ids in the records
+    /// are local to the file; see creator_name().
+    struct View
+    {
+      int genome_id;
+
+      const TraitRecord *traits;
+      size_t ntraits;
+
+      const NodeRecord *nodes;
+      size_t nnodes;
+
+      const LinkRecord *links;
+      size_t nlinks;
+    };
+
+    /// \brief Writes genomes to path. Returns false on I/O errors.
+    static bool save(
+            const std::string &path,
+            const std::vector< const InnovGenome * > &genomes);
+
+    static bool save(
+            const std::string &path,
+            const InnovGenome &genome)
+    {
+      return save(path, std::vector< const InnovGenome * >{&genome});
+    }
+
+    /// \brief Maps path into memory and indexes its genomes. Returns false,
+    /// with a message on std::clog, if the file can't be used.
+    bool open(const std::string &path);
+
+    /// \brief Number of genomes in the file
+    size_t size() const
+    {
+      return _views.size();
+    }
+
+    const View &get(size_t i) const
+    {
+      return _views[i];
+    }
+
+    const std::string &creator_name(StringTable::id_t file_id) const
+    {
+      return _creators[file_id];
+    }
+
+    /// \brief Replaces the genes of genome with those of genome i
+    void load(
+            size_t i,
+            InnovGenome &genome) const;
+
+    private:
+    StringTable::id_t creator_id(StringTable::id_t file_id) const;
+
+    MappedFile _file;
+
+    std::vector< View > _views;
+
+    std::vector< std::string > _creators;
+
+    // StringTable::creators() id of each file-local creator id
+    std::vector< StringTable::id_t > _creator_ids;
+  };
+}
+
+#endif
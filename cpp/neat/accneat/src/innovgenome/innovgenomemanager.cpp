@@ -33,8 +33,11 @@ using namespace NEAT;
 #define MAX_COMPLEXIFY_PHASE_DURATION 40
 #define PRUNE_PHASE_FACTOR 0.5
 
-InnovGenomeManager::InnovGenomeManager(const std::string &robot_name)
-        : robot_name(robot_name)
+InnovGenomeManager::InnovGenomeManager(
+        const std::string &robot_name,
+        const NeatEnv *env)
+        : GenomeManager(env)
+        , robot_name(robot_name)
 {
   if (env->search_type == GeneticSearchType::PHASED)
   {
@@ -114,7 +117,36 @@ bool InnovGenomeManager::are_compatible(
         Genome &genome2)
 {
   return to_innov(genome1)->compatibility(
-          to_innov(genome2)) < env->compat_threshold;
+          *env,
+          to_innov(genome2),
+          env->compat_threshold) < env->compat_threshold;
+}
+
+// Only the (innovation, mutation) pairs of the representative's links are
+// kept, so testing a genome against it walks a dense array.
+struct InnovRepresentative
+        : public GenomeManager::Representative
+{
+  InnovGenome::CompatLinks links;
+};
+
+std::unique_ptr< GenomeManager::Representative >
+InnovGenomeManager::make_representative(Genome &genome)
+{
+  InnovRepresentative *rep = new InnovRepresentative();
+  rep->genome = &genome;
+  to_innov(genome)->get_compat_links(rep->links);
+  return std::unique_ptr< Representative >(rep);
+}
+
+bool InnovGenomeManager::is_compatible(
+        Genome &genome,
+        Representative &rep)
+{
+  return to_innov(genome)->compatibility(
+          *env,
+          static_cast<InnovRepresentative &>(rep).links,
+          env->compat_threshold) < env->compat_threshold;
 }
 
 void InnovGenomeManager::clone(
@@ -145,7 +177,8 @@ void InnovGenomeManager::mate(
   }
   else
   {
-    InnovGenome::mate(to_innov(genome1),
+    InnovGenome::mate(*env,
+                      to_innov(genome1),
                       to_innov(genome2),
                       to_innov(offspring),
                       fitness1,
@@ -155,7 +188,7 @@ void InnovGenomeManager::mate(
     // This is done randomly or if the genome1 and genome2 are the same organism
     if (not offspring.rng.under(env->mate_only_prob)
         or (genome2.genome_id == genome1.genome_id)
-        or (to_innov(genome2)->compatibility(to_innov(genome1)) == 0.0))
+        or (to_innov(genome2)->compatibility(*env, to_innov(genome1)) == 0.0))
     {
       mutate(offspring, MUTATE_OP_ANY);
     }
@@ -185,7 +218,8 @@ void InnovGenomeManager::mutate(
       {
         if (not allow_del or genome_.rng.boolean())
         {
-          genome->mutate_add_link(create_innov_func(genome_),
+          genome->mutate_add_link(*env,
+                                  create_innov_func(genome_),
                                   env->newlink_tries);
         }
         else
@@ -209,7 +243,8 @@ void InnovGenomeManager::mutate(
       }
       else if (allow_add and op.prob_case(env->mutate_add_link_prob))
       {
-        genome->mutate_add_link(create_innov_func(genome_),
+        genome->mutate_add_link(*env,
+                                create_innov_func(genome_),
                                 env->newlink_tries);
       }
       else if (allow_del and op.prob_case(env->mutate_delete_link_prob))
@@ -225,7 +260,7 @@ void InnovGenomeManager::mutate(
         // Only do other mutations when not doing sturctural mutations
         if (rng.under(env->mutate_random_trait_prob))
         {
-          genome->mutate_random_trait();
+          genome->mutate_random_trait(*env);
         }
         if (rng.under(env->mutate_link_trait_prob))
         {
@@ -260,13 +295,20 @@ void InnovGenomeManager::mutate(
 
   if (genome->links.size() == 0)
   {
-    genome->mutate_add_link(create_innov_func(genome_), env->newlink_tries);
+    genome->mutate_add_link(*env,
+                            create_innov_func(genome_),
+                            env->newlink_tries);
   }
 }
 
-void InnovGenomeManager::finalize_generation(bool new_fittest)
+void InnovGenomeManager::apply_innovations()
 {
   innovations.apply();
+}
+
+void InnovGenomeManager::finalize_generation(bool new_fittest)
+{
+  apply_innovations();
 
   generation++;
   if (env->search_type == GeneticSearchType::PHASED)
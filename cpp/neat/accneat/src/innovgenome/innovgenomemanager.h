@@ -36,7 +36,9 @@ namespace NEAT
     friend class GenomeManager;
 
     protected:
-    InnovGenomeManager(const std::string &robot_name);
+    InnovGenomeManager(
+            const std::string &robot_name,
+            const NeatEnv *env = NEAT::env);
 
     public:
     virtual ~InnovGenomeManager();
@@ -60,6 +62,13 @@ namespace NEAT
             Genome &genome1,
             Genome &genome2) override;
 
+    virtual std::unique_ptr< Representative > make_representative(
+            Genome &genome) override;
+
+    virtual bool is_compatible(
+            Genome &genome,
+            Representative &rep) override;
+
     virtual void clone(
             Genome &orig,
             Genome &clone) override;
@@ -77,6 +86,9 @@ namespace NEAT
 
     virtual void finalize_generation(bool new_fittest) override;
 
+    /// \brief
+    virtual void apply_innovations() override;
+
     protected:
     CreateInnovationFunc
 
@@ -54,7 +54,7 @@ InnovLinkGene::InnovLinkGene(
         , _out_node_id(onode_id)
         , _is_recurrent(recur)
         , _trait_id(1)
-        , creator_name(creator_name)
+        , creator_id(StringTable::creators().intern(creator_name))
         , creator_index(creator_index)
         , innovation_num(innov)
         , mutation_num(mnum)
@@ -97,7 +97,7 @@ InnovLinkGene::InnovLinkGene(
         , _out_node_id(onode_id)
         , _is_recurrent(g->_is_recurrent)
         , _trait_id(trait_id)
-        , creator_name(g->creator_name)
+        , creator_id(g->creator_id)
         , creator_index(g->creator_index)
         , innovation_num(g->innovation_num)
         , mutation_num(g->mutation_num)
@@ -106,24 +106,6 @@ InnovLinkGene::InnovLinkGene(
 {
 }
 
-InnovLinkGene::InnovLinkGene(const InnovLinkGene &gene)
-{
-  innovation_num = gene.innovation_num;
-  mutation_num = gene.mutation_num;
-  enable = gene.enable;
-  frozen = gene.frozen;
-
-  _weight = gene._weight;
-  _in_node_id = gene._in_node_id;
-  _out_node_id = gene._out_node_id;
-  _is_recurrent = gene._is_recurrent;
-  _trait_id = gene._trait_id;
-}
-
-InnovLinkGene::~InnovLinkGene()
-{
-}
-
 bool NEAT::InnovLinkGene::operator==(const NEAT::InnovLinkGene &rhs) const
 {
   real_t epsilon = 0.00000001;
@@ -151,7 +133,8 @@ bool YAML::convert< NEAT::InnovLinkGene >::decode(
   rhs.mutation_num = node["mutation_num"].as< real_t >();
   rhs.enable = node["enable"].as< bool >();
   rhs.frozen = node["frozen"].as< bool >();
-  rhs.creator_name = node["creator_name"].as< std::string >();
+  rhs.creator_id = NEAT::StringTable::creators().intern(
+          node["creator_name"].as< std::string >());
   rhs.creator_index = node["creator_index"].as< int >();
 
   return true;
@@ -171,7 +154,7 @@ YAML::Node YAML::convert< NEAT::InnovLinkGene >::encode(
   node["mutation_num"] = rhs.mutation_num;
   node["enable"] = rhs.enable;
   node["frozen"] = rhs.frozen;
-  node["creator_name"] = rhs.creator_name;
+  node["creator_name"] = rhs.get_creator_name();
   node["creator_index"] = rhs.creator_index;
 
   return node;
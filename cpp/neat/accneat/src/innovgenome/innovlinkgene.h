@@ -37,12 +37,14 @@
 #define _GENE_H_
 
 #include <string>
+#include <type_traits>
 
 #include <yaml-cpp/yaml.h>
 
 #include "neat.h"
 #include "trait.h"
 #include "network/network.h"
+#include "util/stringtable.h"
 
 namespace NEAT
 {
@@ -63,8 +65,9 @@ namespace NEAT
     /// \brief identify the trait derived by this link
     int _trait_id;
 
-    /// \brief
-    std::string creator_name;
+    /// \brief Interned in StringTable::creators(), so that the gene stays
+    /// trivially copyable
+    StringTable::id_t creator_id;
 
     /// \brief
     int creator_index;
@@ -93,6 +96,11 @@ namespace NEAT
       return _weight;
     }
 
+    inline real_t weight() const
+    {
+      return _weight;
+    }
+
     inline int trait_id() const
     {
       return _trait_id;
@@ -113,9 +121,9 @@ namespace NEAT
       _is_recurrent = r;
     }
 
-    inline const std::string &get_creator_name()
+    inline const std::string &get_creator_name() const
     {
-      return creator_name;
+      return StringTable::creators().lookup(creator_id);
     }
 
     inline int get_creator_index()
@@ -135,8 +143,11 @@ namespace NEAT
     /// \brief When frozen, the linkweight cannot be mutated
     bool frozen;
 
-    /// \brief Construct a gene in an invalid default state.
+    /// \brief Construct a gene in an invalid default state, without a
+    /// creator (StringTable::EMPTY).
     InnovLinkGene()
+            : creator_id(StringTable::EMPTY)
+            , creator_index(-1)
     {}
 
     /// \brief Construct a gene with no trait
@@ -169,18 +180,17 @@ namespace NEAT
             int inode_id,
             int onode_id);
 
-    /// \brief Copy Constructor
-    InnovLinkGene(const InnovLinkGene &gene);
-
-    /// \brief
-    ~InnovLinkGene();
-
     /// \brief
     bool operator==(const InnovLinkGene &rhs) const;
 
     /// \brief
     friend struct YAML::convert< NEAT::InnovLinkGene >;
+
+    friend class InnovGenomeFile;
   };
+
+  static_assert(std::is_trivially_copyable< InnovLinkGene >::value,
+                "Link genes are copied with memcpy");
 }  // namespace NEAT
 
 namespace YAML
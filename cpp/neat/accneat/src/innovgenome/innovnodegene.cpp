@@ -40,7 +40,7 @@
 using namespace NEAT;
 
 InnovNodeGene::InnovNodeGene(const std::string &robot_name)
-        : creator_name(robot_name)
+        : creator_id(StringTable::creators().intern(robot_name))
         , creator_index(-1)
 {
 }
@@ -53,7 +53,7 @@ InnovNodeGene::InnovNodeGene(
         const int creator_index
 )
         : trait_id(1)
-        , creator_name(creator_name)
+        , creator_id(StringTable::creators().intern(creator_name))
         , creator_index(creator_index)
         , frozen(false)
         , type(ntype)
@@ -61,21 +61,6 @@ InnovNodeGene::InnovNodeGene(
 {
 }
 
-InnovNodeGene::InnovNodeGene(const InnovNodeGene &other)
-        : InnovNodeGene(other.type,
-                        other.node_id,
-                        other.creator_name,
-                        other.creator_name,
-                        other.creator_index)
-{
-  frozen = other.frozen;
-  trait_id = other.trait_id;
-}
-
-InnovNodeGene::~InnovNodeGene()
-{
-}
-
 bool YAML::convert< NEAT::InnovNodeGene >::decode(
         const YAML::Node &node,
         InnovNodeGene &rhs)
@@ -84,7 +69,7 @@ bool YAML::convert< NEAT::InnovNodeGene >::decode(
   rhs.set_trait_id(node["trait_id"].as< int >());
   rhs.set_type(node["type"].as< nodetype >());
   rhs.frozen = node["frozen"].as< bool >();
-  rhs.creator_name = node["creator_name"].as< std::string >();
+  rhs.set_creator_name(node["creator_name"].as< std::string >());
   rhs.creator_index = node["creator_index"].as< int >();
 
   return true;
@@ -98,7 +83,7 @@ YAML::convert< NEAT::InnovNodeGene >::encode(const InnovNodeGene &rhs)
   node["trait_id"] = rhs.get_trait_id();
   node["type"] = rhs.get_type();
   node["frozen"] = rhs.frozen;
-  node["creator_name"] = rhs.creator_name;
+  node["creator_name"] = rhs.get_creator_name();
   node["creator_index"] = rhs.creator_index;
 
   return node;
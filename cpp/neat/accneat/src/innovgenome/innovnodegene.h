@@ -42,10 +42,12 @@
 #include <assert.h>
 #include <iostream>
 #include <string>
+#include <type_traits>
 
 #include <yaml-cpp/yaml.h>
 
 #include "neat.h"
+#include "util/stringtable.h"
 
 namespace NEAT
 {
@@ -54,8 +56,9 @@ namespace NEAT
     /// \brief identify the trait derived by this node
     int trait_id;
 
-    /// \brief
-    std::string creator_name;
+    /// \brief Interned in StringTable::creators(), so that the gene stays
+    /// trivially copyable
+    StringTable::id_t creator_id;
 
     /// \brief
     int creator_index;
@@ -71,12 +74,13 @@ namespace NEAT
     /// \brief A node can be given an identification number for saving in files
     int node_id;
 
+    /// \brief Construct a gene in an invalid default state, without a
+    /// creator (StringTable::EMPTY).
     InnovNodeGene()
-            : InnovNodeGene("ERROR")
+            : creator_id(StringTable::EMPTY)
+            , creator_index(-1)
     {}
 
-    InnovNodeGene(const InnovNodeGene &other);
-
     // Construct InnovNodeGene with invalid state.
     InnovNodeGene(const std::string &robot_name);
 
@@ -94,10 +98,6 @@ namespace NEAT
             : InnovNodeGene(ntype, nodeid, robot_name, robot_name, -1)
     {}
 
-    ~InnovNodeGene();
-
-    InnovNodeGene &operator=(const InnovNodeGene &other);
-
     inline void set_trait_id(int id)
     {
       assert(id > 0);
@@ -119,9 +119,9 @@ namespace NEAT
       type = t;
     }
 
-    inline const std::string &get_creator_name()
+    inline const std::string &get_creator_name() const
     {
-      return creator_name;
+      return StringTable::creators().lookup(creator_id);
     }
 
     inline int get_creator_index()
@@ -134,7 +134,12 @@ namespace NEAT
     void set_creator_index(int creator_index);
 
     friend struct YAML::convert< NEAT::InnovNodeGene >;
+
+    friend class InnovGenomeFile;
   };
+
+  static_assert(std::is_trivially_copyable< InnovNodeGene >::value,
+                "Node genes are copied with memcpy");
 }  // namespace NEAT
 
 namespace YAML
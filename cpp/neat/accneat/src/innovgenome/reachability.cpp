@@ -0,0 +1,170 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Reachability between the nodes of a genome
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <algorithm>
+#include <cassert>
+
+#include "reachability.h"
+
+using namespace NEAT;
+using namespace std;
+
+// Room for a few new nodes before the rows have to be laid out again.
+static size_t words_for(size_t nnodes)
+{
+  return (nnodes + 8) / 64 + 1;
+}
+
+Reachability::Reachability(
+        const vector< InnovNodeGene > &nodes,
+        const vector< InnovLinkGene > &links)
+        : _words(words_for(nodes.size()))
+        , _nnodes(nodes.size())
+{
+  _bits.assign(_nnodes * _words, 0);
+  _rows.resize(_nnodes);
+  for (size_t i = 0; i < _nnodes; i++)
+  {
+    _rows[i] = make_pair(nodes[i].node_id, static_cast<uint32_t>(i));
+  }
+
+  // Only nodes with links both in and out can be on a path between two
+  // others, which usually leaves out the sensors and outputs.
+  vector< char > has_in(_nnodes, 0), has_out(_nnodes, 0);
+
+  // Direct map from node id to row, as in build_phenotype(). Links only
+  // refer to nodes of the genome, so other slots are never read.
+  static thread_local vector< uint32_t > row_of;
+  if (_nnodes and (row_of.size() <= size_t(nodes.back().node_id)))
+  {
+    row_of.resize(nodes.back().node_id + 1);
+  }
+  for (size_t i = 0; i < _nnodes; i++)
+  {
+    row_of[nodes[i].node_id] = i;
+  }
+
+  for (const InnovLinkGene &link: links)
+  {
+    if (link.enable and not link.is_recurrent())
+    {
+      size_t in = row_of[link.in_node_id()];
+      size_t out = row_of[link.out_node_id()];
+      assert((in == index(link.in_node_id()))
+             and (out == index(link.out_node_id())));
+      set(in, out);
+      has_out[in] = 1;
+      has_in[out] = 1;
+    }
+  }
+
+  // Warshall: after step k, paths through nodes 0..k are accounted for.
+  for (size_t k = 0; k < _nnodes; k++)
+  {
+    if (not (has_in[k] and has_out[k]))
+    {
+      continue;
+    }
+    const uint64_t *row_k = &_bits[k * _words];
+    for (size_t i = 0; i < _nnodes; i++)
+    {
+      if (test(i, k))
+      {
+        uint64_t *row_i = &_bits[i * _words];
+        for (size_t w = 0; w < _words; w++)
+        {
+          row_i[w] |= row_k[w];
+        }
+      }
+    }
+  }
+}
+
+size_t Reachability::index(int node_id) const
+{
+  auto it = lower_bound(_rows.begin(),
+                        _rows.end(),
+                        node_id,
+                        [](const pair< int, uint32_t > &row, int id)
+                        {
+                          return row.first < id;
+                        });
+  assert((it not_eq _rows.end()) and (it->first == node_id));
+  return it->second;
+}
+
+bool Reachability::is_recur(
+        int in_node_id,
+        int out_node_id) const
+{
+  if (in_node_id == out_node_id)
+  {
+    return true;
+  }
+  return test(index(out_node_id), index(in_node_id));
+}
+
+void Reachability::add_node(int node_id)
+{
+  if (_nnodes == _words * 64)
+  {
+    size_t words = words_for(_nnodes + 1);
+    vector< uint64_t > bits(_nnodes * words, 0);
+    for (size_t i = 0; i < _nnodes; i++)
+    {
+      copy(&_bits[i * _words], &_bits[(i + 1) * _words], &bits[i * words]);
+    }
+    _bits.swap(bits);
+    _words = words;
+  }
+
+  _bits.resize((_nnodes + 1) * _words, 0);
+  auto row = make_pair(node_id, static_cast<uint32_t>(_nnodes));
+  _rows.insert(upper_bound(_rows.begin(), _rows.end(), row), row);
+  _nnodes++;
+}
+
+void Reachability::add_link(
+        int in_node_id,
+        int out_node_id)
+{
+  size_t in = index(in_node_id);
+  size_t out = index(out_node_id);
+  if (test(in, out))
+  {
+    return;
+  }
+
+  // Everything reaching in, and in itself, now also reaches out and all
+  // that out reaches.
+  vector< uint64_t > reach(&_bits[out * _words], &_bits[(out + 1) * _words]);
+  reach[out / 64] |= uint64_t(1) << (out % 64);
+
+  for (size_t i = 0; i < _nnodes; i++)
+  {
+    if ((i == in) or test(i, in))
+    {
+      uint64_t *row_i = &_bits[i * _words];
+      for (size_t w = 0; w < _words; w++)
+      {
+        row_i[w] |= reach[w];
+      }
+    }
+  }
+}
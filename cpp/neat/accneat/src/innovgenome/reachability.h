@@ -0,0 +1,100 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Reachability between the nodes of a genome
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_INNOVGENOME_REACHABILITY_H_
+#define CPP_NEAT_ACCNEAT_SRC_INNOVGENOME_REACHABILITY_H_
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "innovlinkgene.h"
+#include "innovnodegene.h"
+
+namespace NEAT
+{
+  ///
+  /// CLASS Reachability
+  ///
+  /// Transitive closure of the forward links of a genome, that is the
+  /// enabled links that aren't recurrent, stored as one bit row per node.
+  /// It answers whether a new link would be recurrent with two lookups, and
+  /// is kept up to date as nodes and forward links are added. Removing a
+  /// link can't be done incrementally; the index is rebuilt instead.
+  ///
+  /// Mating and enabling links can close loops of forward links, so the
+  /// graph isn't necessarily acyclic.
+  ///
+  class Reachability
+  {
+    public:
+    /// \brief Builds the index for nodes, which must be sorted by node id,
+    /// and the forward links among links
+    Reachability(
+            const std::vector< InnovNodeGene > &nodes,
+            const std::vector< InnovLinkGene > &links);
+
+    /// \brief True if a link from in_node_id to out_node_id would close a
+    /// loop, i.e. the nodes are the same or out already reaches in
+    bool is_recur(
+            int in_node_id,
+            int out_node_id) const;
+
+    /// \brief Adds a node without links
+    void add_node(int node_id);
+
+    /// \brief Adds a forward link between nodes already in the index
+    void add_link(
+            int in_node_id,
+            int out_node_id);
+
+    private:
+    size_t index(int node_id) const;
+
+    bool test(
+            size_t from,
+            size_t to) const
+    {
+      return (_bits[from * _words + to / 64] >> (to % 64)) & 1;
+    }
+
+    void set(
+            size_t from,
+            size_t to)
+    {
+      _bits[from * _words + to / 64] |= uint64_t(1) << (to % 64);
+    }
+
+    /// \brief Row i holds the nodes reachable from node i through one or
+    /// more forward links; a node reaches itself only through a loop.
+    std::vector< uint64_t > _bits;
+
+    /// \brief Words per row
+    size_t _words;
+
+    size_t _nnodes;
+
+    /// \brief (node id, row) sorted by node id
+    std::vector< std::pair< int, uint32_t > > _rows;
+  };
+}
+
+#endif
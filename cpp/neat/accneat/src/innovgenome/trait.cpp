@@ -70,16 +70,6 @@ Trait::Trait(int id,
   params[7] = 0;
 }
 
-Trait::Trait(const Trait &t)
-{
-  for (int count = 0; count < NUM_TRAIT_PARAMS; count++)
-  {
-    params[count] = (t.params)[count];
-  }
-
-  trait_id = t.trait_id;
-}
-
 
 Trait::Trait(Trait *t)
 {
@@ -137,13 +127,15 @@ void Trait::print_to_file(std::ostream &outFile) const
   outFile << std::endl;
 }
 
-void Trait::mutate(rng_t &rng)
+void Trait::mutate(
+        rng_t &rng,
+        const NeatEnv &env)
 {
   for (int count = 0; count < NUM_TRAIT_PARAMS; count++)
   {
-    if (rng.prob() > env->trait_param_mut_prob)
+    if (rng.prob() > env.trait_param_mut_prob)
     {
-      params[count] += (rng.posneg() * rng.prob()) * env->trait_mutation_power;
+      params[count] += (rng.posneg() * rng.prob()) * env.trait_mutation_power;
       if (params[count] < 0)
       { params[count] = 0; }
       if (params[count] > 1.0)
@@ -36,6 +36,8 @@
 #ifndef _TRAIT_H_
 #define _TRAIT_H_
 
+#include <type_traits>
+
 #include <yaml-cpp/yaml.h>
 
 #include "neat.h"
@@ -70,9 +72,6 @@ namespace NEAT {
     Trait(int id, real_t p1, real_t p2, real_t p3, real_t p4, real_t p5,
           real_t p6, real_t p7, real_t p8, real_t p9);
 
-    /// \brief Copy Constructor
-    Trait(const Trait &t);
-
     /// \brief Create a trait exactly like another trait
     Trait(Trait *t);
 
@@ -88,8 +87,13 @@ namespace NEAT {
     void print_to_file(std::ostream &outFile) const;
 
     /// \brief Perturb the trait parameters slightly
-    void mutate(rng_t &rng);
+    void mutate(
+            rng_t &rng,
+            const NeatEnv &env);
   };
+
+  static_assert(std::is_trivially_copyable< Trait >::value,
+                "Traits are copied with memcpy");
 }  // namespace NEAT
 
 namespace YAML {
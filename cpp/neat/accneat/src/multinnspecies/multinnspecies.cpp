@@ -43,7 +43,10 @@
 using namespace NEAT;
 using std::vector;
 
-MultiNNSpecies::MultiNNSpecies(int i)
+MultiNNSpecies::MultiNNSpecies(
+        int i,
+        const NeatEnv *env)
+        : env(env)
 {
   id = i;
   age = 1;
@@ -56,11 +59,14 @@ MultiNNSpecies::MultiNNSpecies(int i)
   obliterate = false;
 
   average_est = 0;
+  last_matched = 0;
 }
 
 MultiNNSpecies::MultiNNSpecies(
         int i,
-        bool n)
+        bool n,
+        const NeatEnv *env)
+        : env(env)
 {
   id = i;
   age = 1;
@@ -73,6 +79,7 @@ MultiNNSpecies::MultiNNSpecies(
   obliterate = false;
 
   average_est = 0;
+  last_matched = 0;
 }
 
 MultiNNSpecies::~MultiNNSpecies()
@@ -35,8 +35,10 @@
 #ifndef _SPECIES_H_
 #define _SPECIES_H_
 
+#include <memory>
 #include <vector>
 
+#include "genomemanager.h"
 #include "neat.h"
 #include "multinnspeciesorganism.h"
 #include "population.h"
@@ -56,6 +58,9 @@ namespace NEAT
     /// \brief
     int id;
 
+    /// \brief The settings of the population this species belongs to
+    const NeatEnv *env;
+
     /// \briefThe age of the Species
     int age;
 
@@ -89,6 +94,13 @@ namespace NEAT
     /// \brief When playing real-time allows estimating average fitness
     real_t average_est;
 
+    /// \brief Compact copy of first()'s genome, only valid while speciating
+    std::unique_ptr< GenomeManager::Representative > representative;
+
+    /// \brief Generation in which an organism from elsewhere last joined.
+    /// Species are searched in most-recently-matched order.
+    int last_matched;
+
     /// \brief
     bool add_Organism(MultiNNSpeciesOrganism *o);
 
@@ -143,13 +155,16 @@ namespace NEAT
     // *** Real-time methods ***
 
     /// \brief
-    MultiNNSpecies(int i);
+    MultiNNSpecies(
+            int i,
+            const NeatEnv *env);
 
     /// \brief Allows the creation of a Species that won't age (a novel one)
     /// This protects new Species from aging inside their first generation
     MultiNNSpecies(
             int i,
-            bool n);
+            bool n,
+            const NeatEnv *env);
 
     /// \brief
     ~MultiNNSpecies();
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 
+#include "genomemanager.h"
 #include "network/network.h"
 #include "multinnspeciesorganism.h"
 #include "multinnspecies.h"
@@ -27,16 +28,19 @@ using namespace NEAT;
 using namespace std;
 
 MultiNNSpeciesOrganism::MultiNNSpeciesOrganism(
-        const MultiNNSpeciesOrganism &other)
+        const MultiNNSpeciesOrganism &other,
+        GenomeManager *genome_manager)
 {
-  this->genome = env->genome_manager->make_default();
+  this->genome = genome_manager->make_default();
   this->net = unique_ptr< Network >(Network::create());
   other.copy_into(*this);
 }
 
-MultiNNSpeciesOrganism::MultiNNSpeciesOrganism(const Genome &genome)
+MultiNNSpeciesOrganism::MultiNNSpeciesOrganism(
+        const Genome &genome,
+        GenomeManager *genome_manager)
 {
-  this->genome = env->genome_manager->make_default();
+  this->genome = genome_manager->make_default();
   *this->genome = genome;
   this->net = unique_ptr< Network >(Network::create());
   init(0);
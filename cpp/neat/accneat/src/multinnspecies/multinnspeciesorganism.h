@@ -51,10 +51,17 @@ namespace NEAT
     int super_champ_offspring;
 
     /// \brief
-    MultiNNSpeciesOrganism(const MultiNNSpeciesOrganism &other);
+    MultiNNSpeciesOrganism(
+            const MultiNNSpeciesOrganism &other,
+            class GenomeManager *genome_manager);
 
     /// \brief
-    MultiNNSpeciesOrganism(const Genome &genome);
+    MultiNNSpeciesOrganism(
+            const Genome &genome,
+            class GenomeManager *genome_manager);
+
+    /// \brief
+    MultiNNSpeciesOrganism(MultiNNSpeciesOrganism &&other) = default;
 
     /// \brief
     virtual ~MultiNNSpeciesOrganism();
@@ -44,6 +44,7 @@
 #include "organism.h"
 #include "multinnspecies.h"
 #include "multinnspeciespopulation.h"
+#include "util/scheduler.h"
 #include "util/timer.h"
 #include "util/util.h"
 
@@ -52,11 +53,13 @@ using namespace std;
 
 MultiNNSpeciesPopulation::MultiNNSpeciesPopulation(
         rng_t rng,
-        vector< unique_ptr< Genome>> &seeds
+        vector< unique_ptr< Genome>> &seeds,
+        const NeatEnv *env
 )
-        : norgs(seeds.size())
+        : Population(env)
+        , norgs(seeds.size())
         , generation(0)
-        , orgs(rng, seeds, seeds.size())
+        , orgs(rng, seeds, env->genome_manager, seeds.size())
         , highest_fitness(0.0)
         , highest_last_changed(0)
 {
@@ -90,7 +93,8 @@ Organism *MultiNNSpeciesPopulation::get(size_t index)
 unique_ptr< Organism > MultiNNSpeciesPopulation::make_copy(size_t index)
 {
   auto copy =
-          new MultiNNSpeciesOrganism((MultiNNSpeciesOrganism &)*get(index));
+          new MultiNNSpeciesOrganism((MultiNNSpeciesOrganism &)*get(index),
+                                     env->genome_manager);
   return unique_ptr< Organism >(copy);
 }
 
@@ -112,26 +116,42 @@ void MultiNNSpeciesPopulation::spawn()
 
 void MultiNNSpeciesPopulation::speciate()
 {
+  GenomeManager *genome_manager = env->genome_manager;
+
+  // Most recently matched species first.
+  std::vector< MultiNNSpecies * > search_order;
+
   last_species = 0;
   for (MultiNNSpeciesOrganism &org: orgs.curr())
   {
     assert(org.species == nullptr);
-    for (MultiNNSpecies *s: species)
+    for (size_t i = 0; i < search_order.size(); i++)
     {
-      if (env->genome_manager->are_compatible(*org.genome, *s->first()->genome))
+      MultiNNSpecies *s = search_order[i];
+      if (genome_manager->is_compatible(*org.genome, *s->representative))
       {
         org.species = s;
+        std::rotate(search_order.begin(),
+                    search_order.begin() + i,
+                    search_order.begin() + i + 1);
         break;
       }
     }
     if (not org.species)
     {
-      auto s = new MultiNNSpecies(++last_species);
+      auto s = new MultiNNSpecies(++last_species, env);
+      s->representative = genome_manager->make_representative(*org.genome);
       species.push_back(s);
+      search_order.insert(search_order.begin(), s);
       org.species = s;
     }
     org.species->add_Organism(&org);
   }
+
+  for (MultiNNSpecies *s: species)
+  {
+    s->representative.reset();
+  }
 }
 
 // void
@@ -159,9 +179,9 @@ void MultiNNSpeciesPopulation::next_generation()
   // Used only when they accumulate above 1 for the purposes of counting
   // Offspring
   real_t skim;
-  int total_expected;  // precision checking
+  size_t total_expected;  // precision checking
   size_t total_organisms = norgs;  // TODO: get rid of this variable
-  assert(total_organisms == env->pop_size);
+  assert(total_organisms == size_t(env->pop_size));
   MultiNNSpecies *best_species = nullptr;
 
   /// \brief Species sorted by max fit org in Species
@@ -251,7 +271,7 @@ void MultiNNSpeciesPopulation::next_generation()
   {
     // Find the Species expecting the most
     int max_expected = 0;
-    int final_expected = 0;
+    size_t final_expected = 0;
     for (MultiNNSpecies *s: species)
     {
       if (s->expected_offspring >= max_expected)
@@ -353,7 +373,7 @@ void MultiNNSpeciesPopulation::next_generation()
     s->remove_eliminated();
   }
 
-  if (total_expected > static_cast<int>(norgs))
+  if (total_expected > norgs)
   {
     warn("total_expected (" << total_expected << ") > size (" << norgs << ")");
   }
@@ -367,7 +387,7 @@ void MultiNNSpeciesPopulation::next_generation()
     int ioffspring;
   };
 
-  auto *reproduce_parms = new reproduce_parms_t[norgs];
+  std::vector< reproduce_parms_t > reproduce_parms(norgs);
 
   {
     size_t iorg = 0;
@@ -388,21 +408,29 @@ void MultiNNSpeciesPopulation::next_generation()
     static Timer timer("reproduce");
     timer.start();
 
-#ifdef WITH_OPENMP
-#pragma omp parallel for
-#endif
-    for (size_t iorg = 0; iorg < norgs; iorg++)
-    {
-      MultiNNSpeciesOrganism &baby = orgs.curr()[iorg];
-      reproduce_parms_t &parms = reproduce_parms[iorg];
-
-      assert(baby.population_index == iorg);
-
-      parms.species->reproduce(parms.ioffspring,
-                               baby,
-                               env->genome_manager,
-                               sorted_species);
-    }
+    // Offspring size is unknown until mating, so the size of the species'
+    // champion stands in for it. Every baby has its own rng and innovations
+    // are applied in population order, so the schedule doesn't affect results.
+    static Scheduler scheduler("reproduce");
+    scheduler.run(norgs,
+                  [&reproduce_parms](size_t iorg)
+                  {
+                    Genome::Stats stats =
+                            reproduce_parms[iorg].species->first()->genome->get_stats();
+                    return stats.nnodes + stats.nlinks;
+                  },
+                  [&](size_t iorg)
+                  {
+                    MultiNNSpeciesOrganism &baby = orgs.curr()[iorg];
+                    reproduce_parms_t &parms = reproduce_parms[iorg];
+
+                    assert(baby.population_index == iorg);
+
+                    parms.species->reproduce(parms.ioffspring,
+                                             baby,
+                                             env->genome_manager,
+                                             sorted_species);
+                  });
 
     env->genome_manager->finalize_generation(new_highest_fitness);
 
@@ -413,6 +441,28 @@ void MultiNNSpeciesPopulation::next_generation()
     static Timer timer("speciate");
     timer.start();
 
+    GenomeManager *genome_manager = env->genome_manager;
+
+    // Take a compact copy of every representative up front, and search the
+    // species that most recently picked up outsiders first. The order is
+    // fixed for the whole loop, so the result doesn't depend on threads.
+    std::vector< MultiNNSpecies * > search_order;
+    for (MultiNNSpecies *s: species)
+    {
+      if (s->size())
+      {
+        s->representative = genome_manager->make_representative(
+                *s->first()->genome);
+        search_order.push_back(s);
+      }
+    }
+    std::stable_sort(search_order.begin(),
+                     search_order.end(),
+                     [](MultiNNSpecies *x, MultiNNSpecies *y)
+                     {
+                       return x->last_matched > y->last_matched;
+                     });
+
     {
 #ifdef WITH_OPENMP
 #pragma omp parallel for
@@ -422,8 +472,8 @@ void MultiNNSpeciesPopulation::next_generation()
         MultiNNSpeciesOrganism &org = orgs.curr()[i];
         MultiNNSpecies *origin_species = reproduce_parms[i].species;
 
-        if (env->genome_manager->are_compatible(
-                *org.genome, *origin_species->first()->genome))
+        if (genome_manager->is_compatible(*org.genome,
+                                          *origin_species->representative))
         {
           org.species = origin_species;
         }
@@ -431,12 +481,12 @@ void MultiNNSpeciesPopulation::next_generation()
         {
           org.species = nullptr;
 
-          for (MultiNNSpecies *s: species)
+          for (MultiNNSpecies *s: search_order)
           {
-            if (s->size() and (s not_eq origin_species))
+            if (s not_eq origin_species)
             {
-              if (env->genome_manager->are_compatible(*org.genome,
-                                                      *s->first()->genome))
+              if (genome_manager->is_compatible(*org.genome,
+                                                *s->representative))
               {
                 org.species = s;
                 break;
@@ -449,17 +499,22 @@ void MultiNNSpeciesPopulation::next_generation()
 
     size_t index_new_species = species.size();
 
-    for (MultiNNSpeciesOrganism &org: orgs.curr())
+    for (size_t i = 0; i < norgs; i++)
     {
-      if (not org.species)
+      MultiNNSpeciesOrganism &org = orgs.curr()[i];
+      if (org.species and (org.species not_eq reproduce_parms[i].species))
+      {
+        org.species->last_matched = generation;
+      }
+      else if (not org.species)
       {
         // It didn't fit into any of the existing species. Check if it fits
         // into one we've just created.
-        for (size_t i = index_new_species, n = species.size(); i < n; i++)
+        for (size_t j = index_new_species, n = species.size(); j < n; j++)
         {
-          MultiNNSpecies *s = species[i];
-          if (env->genome_manager->are_compatible(*org.genome,
-                                                  *s->first()->genome))
+          MultiNNSpecies *s = species[j];
+          if (genome_manager->is_compatible(*org.genome,
+                                            *s->representative))
           {
             org.species = s;
             break;
@@ -468,13 +523,20 @@ void MultiNNSpeciesPopulation::next_generation()
         // It didn't fit into a newly created species, so make one for it.
         if (not org.species)
         {
-          org.species = new MultiNNSpecies(++last_species, true);
+          org.species = new MultiNNSpecies(++last_species, true, env);
+          org.species->representative =
+                  genome_manager->make_representative(*org.genome);
           species.push_back(org.species);
         }
       }
       org.species->add_Organism(&org);
     }
 
+    for (MultiNNSpecies *s: species)
+    {
+      s->representative.reset();
+    }
+
     timer.stop();
   }
 
@@ -523,7 +585,4 @@ void MultiNNSpeciesPopulation::next_generation()
     assert(org.generation == generation);
   }
 #endif
-
-  delete[]reproduce_parms;
-
 }
@@ -53,7 +53,8 @@ namespace NEAT
     /// \brief Construct off of a single spawning Genome
     MultiNNSpeciesPopulation(
             rng_t rng,
-            std::vector< std::unique_ptr< Genome>> &seeds);
+            std::vector< std::unique_ptr< Genome>> &seeds,
+            const NeatEnv *env);
 
     /// \brief
     virtual ~MultiNNSpeciesPopulation();
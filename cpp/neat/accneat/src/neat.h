@@ -167,10 +167,27 @@ namespace NEAT
     /// \brief Tells to print population to file every n generations
     int print_every = 1000;
 
+    /// \brief Number of genomes whose fitness AsyncNeat remembers, so that
+    /// offspring identical to one of them aren't evaluated again. 0 (the
+    /// default) evaluates every organism.
+    size_t fitness_cache_size = 0;
+
+    /// \brief Evaluations of a genome that are averaged before the fitness
+    /// cache reuses the average
+    size_t fitness_cache_samples = 1;
+
+    /// \brief Link weights are compared by the fitness cache after rounding
+    /// them to a multiple of this. Has to be positive if the cache is used.
+    real_t fitness_cache_weight_quantum = 1e-6;
+
     /// \brief
     size_t num_runs = 1;
   };
 
+  /// \brief Default settings. Every population and genome manager reads the
+  /// NeatEnv it was created with, so independent searches with their own
+  /// NeatEnv can run side by side; this one is what the command-line tools
+  /// and AsyncNeat's static setters use.
   extern NeatEnv *env;
 
   // Random number generator; can pass seed value as argument
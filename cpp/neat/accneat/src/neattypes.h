@@ -31,7 +31,11 @@
 // CUDA compiler (C++11 features not currently supported).
 namespace NEAT
 {
+#ifdef ACCNEAT_REAL_DOUBLE
+  typedef double real_t;
+#else
   typedef float real_t;
+#endif
 
   typedef unsigned char uchar;
 
@@ -81,13 +85,13 @@ namespace YAML
         case NEAT::nodetype::NT_BIAS:
           text = "BIAS";
           break;
-        case NEAT::nodetype::NT_HIDDEN:
+        case NEAT::nodetype::NT_SENSOR:
           text = "SENSOR";
           break;
         case NEAT::nodetype::NT_OUTPUT:
           text = "OUTPUT";
           break;
-        case NEAT::nodetype::NT_SENSOR:
+        case NEAT::nodetype::NT_HIDDEN:
           text = "HIDDEN";
           break;
         default:
@@ -40,6 +40,7 @@
 #include <vector>
 
 #include "cpunetwork.h"
+#include "cpunetworkkernel.h"
 #include "neat.h"
 #include "util/util.h"
 
@@ -57,19 +58,61 @@ void CpuNetwork::configure(
         NetLink *links_)
 {
   dims = dims_;
+  layout_id = 0;
+
+  ///
+  /// Split links into padded rows, one per non-input node.
+  ///
+  row_start.resize(dims.nnodes.noninput + 1);
+  uint32_t nlinks_padded = 0;
+  for (size_t i = 0; i < dims.nnodes.noninput; i++)
+  {
+    NetNode &node = nodes_[dims.nnodes.input + i];
+    uint32_t n = node.incoming_end - node.incoming_start;
+
+    row_start[i] = nlinks_padded;
+    nlinks_padded += (n + CPU_LINK_ROW_PAD - 1)
+                     / CPU_LINK_ROW_PAD * CPU_LINK_ROW_PAD;
+  }
+  row_start[dims.nnodes.noninput] = nlinks_padded;
 
-  nodes.resize(dims.nnodes.all);
-  for (size_t i = 0; i < dims.nnodes.all; i++)
+  weights.assign(nlinks_padded, 0.0);
+  in_index.assign(nlinks_padded, 0);
+
+  // Links into input nodes have no effect; they sort before all others.
+  link_base = dims.nnodes.noninput > 0
+              ? nodes_[dims.nnodes.input].incoming_start
+              : dims.nlinks;
+  link_slot.resize(dims.nlinks - link_base);
+  for (size_t i = 0; i < dims.nnodes.noninput; i++)
   {
-    nodes[i] = nodes_[i];
+    NetNode &node = nodes_[dims.nnodes.input + i];
+    uint32_t j = row_start[i];
+    for (link_size_t k = node.incoming_start; k < node.incoming_end; k++, j++)
+    {
+      weights[j] = links_[k].weight;
+      in_index[j] = links_[k].in_node_index;
+      link_slot[k - link_base] = j;
+    }
   }
 
-  links.resize(dims.nlinks);
-  for (size_t i = 0; i < dims.nlinks; i++)
+  reset_activations();
+}
+
+bool CpuNetwork::update_weights(const real_t *weights_)
+{
+  const real_t *w = weights_ + link_base;
+  for (size_t k = 0; k < link_slot.size(); k++)
   {
-    links[i] = links_[i];
+    weights[link_slot[k]] = w[k];
   }
 
+  reset_activations();
+  return true;
+}
+
+void CpuNetwork::reset_activations()
+{
   activations.resize(dims.nnodes.all);
   for (size_t i = 0; i < dims.nnodes.bias; i++)
   {
@@ -79,6 +122,7 @@ void CpuNetwork::configure(
   {
     activations[i] = 0.0;
   }
+  activations_next.resize(dims.nnodes.all);
 }
 
 void CpuNetwork::clear_noninput()
@@ -102,44 +146,13 @@ real_t *CpuNetwork::Outputs()
 
 void CpuNetwork::activate(size_t ncycles)
 {
-  auto act_other = new real_t[dims.nnodes.all];
-
-  // Copy only input activation state.
-  std::memcpy(act_other,
-              activations.data(),
-              sizeof(real_t) * dims.nnodes.input);
-
-  real_t *act_curr = activations.data(), *act_new = act_other;
-
-  for (size_t icycle = 0; icycle < ncycles; icycle++)
-  {
-    for (size_t i = dims.nnodes.input; i < dims.nnodes.all; i++)
-    {
-      NetNode &node = nodes[i];
-
-      real_t sum = 0.0;
-      for (size_t j = node.incoming_start; j < node.incoming_end; j++)
-      {
-        NetLink &link = links[j];
-        sum += link.weight * act_curr[link.in_node_index];
-      }
-      // Sigmoidal activation- see comments under fsigmoid
-      act_new[i] = NEAT::fsigmoid(sum, 4.924273);
-    }
-
-    std::swap(act_curr, act_new);
-  }
-
-  if (act_curr not_eq activations.data())
-  {
-    // If an odd number of cycles, we have to copy non-input data
-    // of act_other back into activations.
-    std::memcpy(activations.data() + dims.nnodes.input,
-                act_other + dims.nnodes.input,
-                sizeof(real_t) * (dims.nnodes.all - dims.nnodes.input));
-  }
-
-  delete[]act_other;
+  cpu_activate(dims,
+               row_start.data(),
+               weights.data(),
+               in_index.data(),
+               activations.data(),
+               activations_next.data(),
+               ncycles);
 }
 
 std::vector< real_t > &CpuNetwork::get_activations(
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "network/network.h"
@@ -36,12 +37,33 @@ namespace NEAT
   {
     private:
     NetDims dims;
-    std::vector< NetNode > nodes;
-    std::vector< NetLink > links;
+
+    /// \brief Offsets of each non-input node's incoming links, padded to
+    /// CPU_LINK_ROW_PAD (noninput + 1 entries, CSR layout).
+    std::vector< uint32_t > row_start;
+
+    /// \brief Link weights, structure-of-arrays with in_index
+    std::vector< real_t > weights;
+
+    /// \brief Index of the node feeding each link
+    std::vector< int32_t > in_index;
+
+    /// \brief Position in weights of each link passed to configure(),
+    /// starting with link link_base
+    std::vector< uint32_t > link_slot;
+
+    link_size_t link_base;
+
+    void reset_activations();
+
     std::vector< real_t > activations;
 
+    /// \brief Second activation buffer, so activate() doesn't allocate
+    std::vector< real_t > activations_next;
+
     public:
     CpuNetwork()
+            : link_base(0)
     {}
 
     virtual ~CpuNetwork()
@@ -68,6 +90,8 @@ namespace NEAT
             NetNode *nodes,
             NetLink *links);
 
+    virtual bool update_weights(const real_t *weights);
+
     virtual NetDims get_dims()
     {
       return dims;
@@ -27,6 +27,7 @@
 
 #include "cpunetwork.h"
 #include "network/networkexecutor.h"
+#include "util/scheduler.h"
 
 namespace NEAT
 {
@@ -67,31 +68,45 @@ namespace NEAT
             OrganismEvaluation *results,
             size_t nnets)
     {
+      if (nnets == 0)
+      {
+        return;
+      }
+
       CpuNetwork **nets = reinterpret_cast<CpuNetwork **>(nets_);
       node_size_t nsensors = nets[0]->get_dims().nnodes.sensor;
 
-#pragma omp parallel for
-      for (size_t inet = 0; inet < nnets; inet++)
-      {
-        CpuNetwork *net = nets[inet];
-        Evaluator eval(config);
-
-        while (eval.next_step())
-        {
-          if (eval.clear_noninput())
-          {
-            net->clear_noninput();
-          }
-          for (node_size_t isensor = 0; isensor < nsensors; isensor++)
-          {
-            net->load_sensor(isensor, eval.get_sensor(isensor));
-          }
-          net->activate(NACTIVATES_PER_INPUT);
-          eval.evaluate(net->get_outputs());
-        }
-
-        results[inet] = eval.result();
-      }
+      // Every evaluator runs the same number of steps, so a network's cost
+      // is proportional to its number of links.
+      static Scheduler scheduler("execute");
+      scheduler.run(nnets,
+                    [nets](size_t inet)
+                    {
+                      const NetDims &dims = nets[inet]->get_dims();
+                      return dims.nlinks + dims.nnodes.all;
+                    },
+                    [&](size_t inet)
+                    {
+                      CpuNetwork *net = nets[inet];
+                      Evaluator eval(config);
+
+                      while (eval.next_step())
+                      {
+                        if (eval.clear_noninput())
+                        {
+                          net->clear_noninput();
+                        }
+                        for (node_size_t isensor = 0; isensor < nsensors;
+                             isensor++)
+                        {
+                          net->load_sensor(isensor, eval.get_sensor(isensor));
+                        }
+                        net->activate(NACTIVATES_PER_INPUT);
+                        eval.evaluate(net->Outputs());
+                      }
+
+                      results[inet] = eval.result();
+                    });
     }
   };
 
@@ -0,0 +1,241 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Dot-product kernels used by CpuNetwork::activate()
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "cpunetworkkernel.h"
+#include "neat.h"
+
+#if (defined(__x86_64__) or defined(__i386__)) \
+    and (defined(__GNUC__) or defined(__clang__))
+#define ACCNEAT_KERNEL_AVX2
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define ACCNEAT_KERNEL_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace NEAT;
+
+static void sums_scalar(
+        size_t nrows,
+        const uint32_t *row_start,
+        const real_t *weights,
+        const int32_t *in_index,
+        const real_t *act,
+        real_t *sums)
+{
+  for (size_t r = 0; r < nrows; r++)
+  {
+    real_t sum = 0.0;
+    for (uint32_t j = row_start[r]; j < row_start[r + 1]; j++)
+    {
+      sum += weights[j] * act[in_index[j]];
+    }
+    sums[r] = sum;
+  }
+}
+
+#ifdef ACCNEAT_KERNEL_AVX2
+
+// Compiled for AVX2 regardless of the global -m flags; only called after
+// the CPU has been checked for support in CpuKernel::get().
+__attribute__((target("avx2,fma")))
+static void sums_avx2(
+        size_t nrows,
+        const uint32_t *row_start,
+        const real_t *weights,
+        const int32_t *in_index,
+        const real_t *act,
+        real_t *sums)
+{
+  for (size_t r = 0; r < nrows; r++)
+  {
+#ifdef ACCNEAT_REAL_DOUBLE
+    __m256d acc = _mm256_setzero_pd();
+    for (uint32_t j = row_start[r]; j < row_start[r + 1]; j += 4)
+    {
+      __m128i idx = _mm_loadu_si128(
+              reinterpret_cast<const __m128i *>(in_index + j));
+      __m256d a = _mm256_i32gather_pd(act, idx, sizeof(real_t));
+      __m256d w = _mm256_loadu_pd(weights + j);
+      acc = _mm256_fmadd_pd(w, a, acc);
+    }
+    __m128d lo = _mm256_castpd256_pd128(acc);
+    __m128d hi = _mm256_extractf128_pd(acc, 1);
+    lo = _mm_add_pd(lo, hi);
+    lo = _mm_add_sd(lo, _mm_unpackhi_pd(lo, lo));
+    sums[r] = _mm_cvtsd_f64(lo);
+#else
+    const uint32_t end = row_start[r + 1];
+    uint32_t j = row_start[r];
+    __m256 acc = _mm256_setzero_ps();
+    for (; j + 8 <= end; j += 8)
+    {
+      __m256i idx = _mm256_loadu_si256(
+              reinterpret_cast<const __m256i *>(in_index + j));
+      __m256 a = _mm256_i32gather_ps(act, idx, sizeof(real_t));
+      __m256 w = _mm256_loadu_ps(weights + j);
+      acc = _mm256_fmadd_ps(w, a, acc);
+    }
+    __m128 lo = _mm256_castps256_ps128(acc);
+    __m128 hi = _mm256_extractf128_ps(acc, 1);
+    lo = _mm_add_ps(lo, hi);
+    if (j < end)
+    {
+      // Rows are padded to 4, so at most one half-width step remains.
+      __m128i idx = _mm_loadu_si128(
+              reinterpret_cast<const __m128i *>(in_index + j));
+      __m128 a = _mm_i32gather_ps(act, idx, sizeof(real_t));
+      lo = _mm_fmadd_ps(_mm_loadu_ps(weights + j), a, lo);
+    }
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x1));
+    sums[r] = _mm_cvtss_f32(lo);
+#endif
+  }
+}
+
+#endif  // ACCNEAT_KERNEL_AVX2
+
+#ifdef ACCNEAT_KERNEL_NEON
+
+// NEON has no gather instruction, so activations are loaded lane by lane and
+// only the multiply-accumulate is vectorized.
+static void sums_neon(
+        size_t nrows,
+        const uint32_t *row_start,
+        const real_t *weights,
+        const int32_t *in_index,
+        const real_t *act,
+        real_t *sums)
+{
+  for (size_t r = 0; r < nrows; r++)
+  {
+#ifdef ACCNEAT_REAL_DOUBLE
+    float64x2_t acc0 = vdupq_n_f64(0.0);
+    float64x2_t acc1 = vdupq_n_f64(0.0);
+    for (uint32_t j = row_start[r]; j < row_start[r + 1]; j += 4)
+    {
+      float64x2_t a0 = vdupq_n_f64(act[in_index[j]]);
+      a0 = vsetq_lane_f64(act[in_index[j + 1]], a0, 1);
+      float64x2_t a1 = vdupq_n_f64(act[in_index[j + 2]]);
+      a1 = vsetq_lane_f64(act[in_index[j + 3]], a1, 1);
+      acc0 = vfmaq_f64(acc0, vld1q_f64(weights + j), a0);
+      acc1 = vfmaq_f64(acc1, vld1q_f64(weights + j + 2), a1);
+    }
+    sums[r] = vaddvq_f64(vaddq_f64(acc0, acc1));
+#else
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (uint32_t j = row_start[r]; j < row_start[r + 1]; j += 4)
+    {
+      float32x4_t a = vdupq_n_f32(act[in_index[j]]);
+      a = vsetq_lane_f32(act[in_index[j + 1]], a, 1);
+      a = vsetq_lane_f32(act[in_index[j + 2]], a, 2);
+      a = vsetq_lane_f32(act[in_index[j + 3]], a, 3);
+      acc = vfmaq_f32(acc, vld1q_f32(weights + j), a);
+    }
+    sums[r] = vaddvq_f32(acc);
+#endif
+  }
+}
+
+#endif  // ACCNEAT_KERNEL_NEON
+
+const CpuKernel &CpuKernel::scalar()
+{
+  static const CpuKernel kernel = {"scalar", sums_scalar};
+  return kernel;
+}
+
+static const CpuKernel &select_kernel()
+{
+#if defined(ACCNEAT_KERNEL_AVX2)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma"))
+  {
+    static const CpuKernel kernel = {"avx2", sums_avx2};
+    return kernel;
+  }
+#elif defined(ACCNEAT_KERNEL_NEON)
+  // Advanced SIMD is mandatory on AArch64.
+  static const CpuKernel kernel = {"neon", sums_neon};
+  return kernel;
+#endif
+
+  return CpuKernel::scalar();
+}
+
+const CpuKernel &CpuKernel::simd()
+{
+  static const CpuKernel &kernel = select_kernel();
+  return kernel;
+}
+
+const CpuKernel &CpuKernel::get(size_t row_length)
+{
+  static const bool no_simd = std::getenv("ACCNEAT_NO_SIMD") not_eq nullptr;
+  if (no_simd or (row_length < CPU_SIMD_MIN_ROW_LENGTH))
+  {
+    return scalar();
+  }
+  return simd();
+}
+
+void NEAT::cpu_activate(
+        const NetDims &dims,
+        const uint32_t *row_start,
+        const real_t *weights,
+        const int32_t *in_index,
+        real_t *act,
+        real_t *act_other,
+        size_t ncycles)
+{
+  const size_t input = dims.nnodes.input;
+  const size_t noninput = dims.nnodes.noninput;
+  const CpuActivationKernel sums = CpuKernel::get(
+          noninput ? row_start[noninput] / noninput : 0).sums;
+
+  // Copy only input activation state.
+  std::memcpy(act_other, act, sizeof(real_t) * input);
+
+  real_t *act_curr = act, *act_new = act_other;
+
+  for (size_t icycle = 0; icycle < ncycles; icycle++)
+  {
+    sums(noninput, row_start, weights, in_index, act_curr, act_new + input);
+
+    for (size_t i = input; i < dims.nnodes.all; i++)
+    {
+      // Sigmoidal activation- see comments under fsigmoid
+      act_new[i] = NEAT::fsigmoid(act_new[i], 4.924273);
+    }
+
+    std::swap(act_curr, act_new);
+  }
+
+  if (act_curr not_eq act)
+  {
+    // If an odd number of cycles, we have to copy non-input data
+    // of act_other back into act.
+    std::memcpy(act + input, act_other + input, sizeof(real_t) * noninput);
+  }
+}
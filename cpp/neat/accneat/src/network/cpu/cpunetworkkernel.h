@@ -0,0 +1,92 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Dot-product kernels used by CpuNetwork::activate()
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_NETWORK_CPU_CPUNETWORKKERNEL_H_
+#define CPP_NEAT_ACCNEAT_SRC_NETWORK_CPU_CPUNETWORKKERNEL_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "neattypes.h"
+#include "network/network.h"
+
+namespace NEAT
+{
+  /// \brief Every row of incoming links is padded to a multiple of this many
+  /// entries, so the vector kernels never need a scalar tail loop. Padding
+  /// entries have weight 0 and read node 0, which always exists (bias).
+  /// 4 keeps the waste low for the small rows typical of NEAT genomes; wider
+  /// kernels handle the last 4 entries of a row with a half-width step.
+  const size_t CPU_LINK_ROW_PAD = 4;
+
+  /// \brief Average row length, in padded entries, from which the vector
+  /// kernels are used. Shorter rows, as in most NEAT genomes, are summed
+  /// faster by the scalar kernel than by a gather per 4 or 8 entries.
+  const size_t CPU_SIMD_MIN_ROW_LENGTH = 16;
+
+  /// \brief Computes, for each of nrows nodes, the weighted sum of incoming
+  /// activations.
+  /// Row r spans [row_start[r], row_start[r + 1]) of weights/in_index, which
+  /// is a multiple of CPU_LINK_ROW_PAD long.
+  typedef void (*CpuActivationKernel)(
+          size_t nrows,
+          const uint32_t *row_start,
+          const real_t *weights,
+          const int32_t *in_index,
+          const real_t *act,
+          real_t *sums);
+
+  ///
+  /// CLASS CpuKernel
+  ///
+  struct CpuKernel
+  {
+    const char *name;
+    CpuActivationKernel sums;
+
+    /// \brief Kernel for rows of row_length entries on average: simd() from
+    /// CPU_SIMD_MIN_ROW_LENGTH on, scalar() below. Setting ACCNEAT_NO_SIMD
+    /// in the environment forces the scalar kernel, which is useful to
+    /// benchmark and to compare results.
+    static const CpuKernel &get(size_t row_length);
+
+    /// \brief Portable reference kernel
+    static const CpuKernel &scalar();
+
+    /// \brief Best vector kernel supported by the host CPU, resolved on first
+    /// use; scalar() if there is none. Ignores ACCNEAT_NO_SIMD.
+    static const CpuKernel &simd();
+  };
+
+  /// \brief Runs ncycles synchronous activation steps of one network in the
+  /// padded CSR layout. act holds the current state and receives the result;
+  /// act_other is scratch space of the same size.
+  void cpu_activate(
+          const NetDims &dims,
+          const uint32_t *row_start,
+          const real_t *weights,
+          const int32_t *in_index,
+          real_t *act,
+          real_t *act_other,
+          size_t ncycles);
+}
+
+#endif
@@ -39,6 +39,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include "neattypes.h"
 
@@ -93,6 +94,11 @@ namespace NEAT
 
     std::size_t population_index;
 
+    /// \brief Identifies the layout of nodes and links last passed to
+    /// configure(), as chosen by the genome; 0 when unknown. Genomes use it
+    /// to tell whether only the weights need to be updated.
+    uint64_t layout_id = 0;
+
     virtual ~Network()
     {}
 
@@ -101,6 +107,15 @@ namespace NEAT
             NetNode *nodes,
             NetLink *links) = 0;
 
+    /// \brief Replaces the weights of the links passed to the last
+    /// configure(), given in the same order, and resets the activations as
+    /// configure() does. Returns false if the network can't do this, in
+    /// which case it has to be configured again.
+    virtual bool update_weights(const real_t * /*weights*/)
+    {
+      return false;
+    }
+
     virtual NetDims get_dims() = 0;
   };
 
@@ -42,15 +42,19 @@
 
 using namespace NEAT;
 
-Organism::Organism(const Organism &other)
-        : genome(env->genome_manager->make_default())
+Organism::Organism(
+        const Organism &other,
+        GenomeManager *genome_manager)
+        : genome(genome_manager->make_default())
         , net(std::unique_ptr< Network >(Network::create()))
 {
   other.copy_into(*this);
 }
 
-Organism::Organism(const Genome &genome)
-        : genome(env->genome_manager->make_default())
+Organism::Organism(
+        const Genome &genome,
+        GenomeManager *genome_manager)
+        : genome(genome_manager->make_default())
         , net(std::unique_ptr< Network >(Network::create()))
 {
   *this->genome = genome;
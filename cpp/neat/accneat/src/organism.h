@@ -52,7 +52,7 @@ namespace NEAT
   class Organism
   {
     public:
-    /// \brief Unique within the population,always in [0, env->pop_size).
+    /// \brief Unique within the population,always in [0, pop_size).
     size_t population_index;
 
     /// \briefProvides client with convenient storage of associated
@@ -68,11 +68,18 @@ namespace NEAT
     /// \brief Tells which generation this Organism is from
     int generation;
 
+    /// \brief Copy of other, with a genome made by genome_manager
+    Organism(
+            const Organism &other,
+            class GenomeManager *genome_manager);
+
     /// \brief
-    Organism(const Organism &other);
+    Organism(
+            const Genome &genome,
+            class GenomeManager *genome_manager);
 
     /// \brief
-    Organism(const Genome &genome);
+    Organism(Organism &&other) = default;
 
     /// \brief
     virtual ~Organism();
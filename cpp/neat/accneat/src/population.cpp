@@ -43,27 +43,34 @@
 using namespace NEAT;
 // using namespace std;
 
-Population *NEAT::debug_population = nullptr;
-
 Population *Population::create(
         rng_t rng,
-        std::vector< std::unique_ptr< Genome>> &seeds)
+        std::vector< std::unique_ptr< Genome>> &seeds,
+        const NeatEnv *env)
 {
   Population *result;
 
   switch (env->population_type)
   {
     case PopulationType::SPECIES:
-      result = new SpeciesPopulation(rng, seeds);
+      result = new SpeciesPopulation(rng, seeds, env);
       break;
     case PopulationType::MULTI_NN_SPECIES:
-      result = new MultiNNSpeciesPopulation(rng, seeds);
+      result = new MultiNNSpeciesPopulation(rng, seeds, env);
       break;
     default:
     panic();
   }
 
-  debug_population = result;
-
   return result;
 }
+
+void Population::evaluated(size_t /*index*/)
+{
+  error("This population type doesn't support steady-state evolution");
+}
+
+int Population::replace_worst(size_t /*min_evaluated*/)
+{
+  error("This population type doesn't support steady-state evolution");
+}
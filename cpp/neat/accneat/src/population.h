@@ -51,8 +51,11 @@ namespace NEAT
   class Population
   {
     public:
+    /// \brief Creates a population of env's population_type. Every setting,
+    /// including the genome manager, comes from env, which must outlive it.
     static Population *create(rng_t rng,
-                              std::vector<std::unique_ptr<Genome>> &seeds);
+                              std::vector<std::unique_ptr<Genome>> &seeds,
+                              const NeatEnv *env = NEAT::env);
 
     virtual ~Population()
     {}
@@ -65,13 +68,35 @@ namespace NEAT
 
     virtual void next_generation() = 0;
 
+    /// \brief Whether evaluated() and replace_worst() are implemented
+    virtual bool supports_steady_state()
+    {
+      return false;
+    }
+
+    /// \brief Steady-state evolution: the organism at index has its fitness
+    /// set and takes part in selection from now on.
+    virtual void evaluated(size_t index);
+
+    /// \brief Steady-state evolution: replaces the evaluated organism with the
+    /// lowest shared fitness by a new offspring, once at least min_evaluated
+    /// organisms are evaluated. Returns the index of the offspring, or -1 when
+    /// nothing was replaced.
+    virtual int replace_worst(size_t min_evaluated);
+
     virtual void verify() = 0;
 
     //    virtual void
     //    write(std::ostream &out) = 0;
-  };
 
-  extern Population *debug_population;
+    protected:
+    Population(const NeatEnv *env)
+            : env(env)
+    {}
+
+    /// \brief The settings of this search
+    const NeatEnv *env;
+  };
 }  // namespace NEAT
 
 #endif
@@ -34,6 +34,8 @@
 */
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <vector>
 
 #include "genomemanager.h"
@@ -44,8 +46,11 @@
 using namespace NEAT;
 using std::vector;
 
-Species::Species(int i)
+Species::Species(
+        int i,
+        const NeatEnv *env)
         : id(i)
+        , env(env)
         , age(1)
         , ave_fitness(0.0)
         , max_fitness(0)
@@ -55,13 +60,18 @@ Species::Species(int i)
         , obliterate(false)
         , age_of_last_improvement(0)
         , average_est(0)
+        , fitness_sum(0)
+        , nevaluated(0)
+        , last_matched(0)
 {
 }
 
 Species::Species(
         int i,
-        bool n)
+        bool n,
+        const NeatEnv *env)
         : id(i)
+        , env(env)
         , age(1)
         , ave_fitness(0.0)
         , max_fitness(0)
@@ -71,6 +81,9 @@ Species::Species(
         , obliterate(false)
         , age_of_last_improvement(0)
         , average_est(0)
+        , fitness_sum(0)
+        , nevaluated(0)
+        , last_matched(0)
 {
 }
 
@@ -92,6 +105,33 @@ void Species::remove_eliminated()
   });
 }
 
+void Species::remove_Organism(SpeciesOrganism *o)
+{
+  auto it = std::find(organisms.begin(), organisms.end(), o);
+  assert(it not_eq organisms.end());
+  organisms.erase(it);
+
+  if (o->evaluated)
+  {
+    fitness_sum -= o->eval.fitness;
+    nevaluated--;
+    // Don't let rounding errors pile up in a species that keeps turning over.
+    if (nevaluated == 0)
+    {
+      fitness_sum = 0.0;
+    }
+    average_est = nevaluated ? fitness_sum / nevaluated : 0.0;
+  }
+}
+
+void Species::add_evaluated(SpeciesOrganism *o)
+{
+  assert(o->evaluated);
+  fitness_sum += o->eval.fitness;
+  nevaluated++;
+  average_est = fitness_sum / nevaluated;
+}
+
 void Species::remove_generation(int gen)
 {
   erase_if(organisms, [gen](SpeciesOrganism *org)
@@ -281,7 +321,7 @@ real_t Species::count_offspring(real_t skim)
   return skim;
 }
 
-static SpeciesOrganism *get_random(
+static Species *get_random_species(
         rng_t &rng,
         Species *thiz,
         const vector< Species * > &sorted_species)
@@ -296,7 +336,15 @@ static SpeciesOrganism *get_random(
     result = sorted_species[randspeciesnum];
   }
 
-  return result->first();
+  return result;
+}
+
+static SpeciesOrganism *get_random(
+        rng_t &rng,
+        Species *thiz,
+        const vector< Species * > &sorted_species)
+{
+  return get_random_species(rng, thiz, sorted_species)->first();
 }
 
 // TODO: this method better belongs in the population class.
@@ -371,6 +419,78 @@ void Species::reproduce(
   }
 }
 
+SpeciesOrganism *Species::best_evaluated()
+{
+  SpeciesOrganism *result = nullptr;
+  for (SpeciesOrganism *o: organisms)
+  {
+    if (o->evaluated
+        and ((result == nullptr) or (o->eval.fitness > result->eval.fitness)))
+    {
+      result = o;
+    }
+  }
+  return result;
+}
+
+void Species::reproduce_one(
+        SpeciesOrganism &baby,
+        GenomeManager *genome_manager,
+        vector< Species * > &sorted_species)
+{
+  Genome &new_genome = *baby.genome;
+  rng_t &rng = baby.genome->rng;
+
+  // Only the best survival_thresh of the evaluated organisms get to be
+  // parents, as in adjust_fitness().
+  vector< SpeciesOrganism * > parents;
+  for (SpeciesOrganism *o: organisms)
+  {
+    if (o->evaluated)
+    {
+      parents.push_back(o);
+    }
+  }
+  assert(not parents.empty());
+  std::sort(parents.begin(),
+            parents.end(),
+            [](SpeciesOrganism *x, SpeciesOrganism *y)
+            {
+              return x->eval.fitness > y->eval.fitness;
+            });
+  size_t nparents = (size_t)floor((env->survival_thresh * parents.size())
+                                  + 1.0);
+  parents.resize(std::min(nparents, parents.size()));
+
+  if ((rng.prob() < env->mutate_only_prob) or (parents.size() == 1))
+  {
+    // Clone a random parent
+    genome_manager->clone(*rng.element(parents)->genome, new_genome);
+    genome_manager->mutate(new_genome);
+  }
+  else
+  {
+    SpeciesOrganism *mom = rng.element(parents);
+
+    SpeciesOrganism *dad;
+    if ((rng.prob() > env->interspecies_mate_rate)
+        or (sorted_species.size() == 1))
+    {
+      dad = rng.element(parents);
+    }
+    else
+    {
+      dad = get_random_species(rng, this, sorted_species)->best_evaluated();
+    }
+
+    genome_manager->mate(*mom->genome,
+                         *dad->genome,
+                         new_genome,
+                         mom->eval.fitness,
+                         dad->eval.fitness);
+  }
+}
+
 bool NEAT::order_species(
         Species *x,
         Species *y)
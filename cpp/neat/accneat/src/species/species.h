@@ -35,8 +35,10 @@
 #ifndef _SPECIES_H_
 #define _SPECIES_H_
 
+#include <memory>
 #include <vector>
 
+#include "genomemanager.h"
 #include "neat.h"
 #include "speciesorganism.h"
 #include "population.h"
@@ -52,6 +54,9 @@ namespace NEAT
     /// \brief
     int id;
 
+    /// \brief The settings of the population this species belongs to
+    const NeatEnv *env;
+
     /// \brief The age of the Species
     int age;
 
@@ -85,6 +90,19 @@ namespace NEAT
     /// \brief When playing real-time allows estimating average fitness
     real_t average_est;
 
+    /// \brief Sum of the fitnesses of the evaluated organisms, in real-time
+    real_t fitness_sum;
+
+    /// \brief Number of evaluated organisms, in real-time
+    size_t nevaluated;
+
+    /// \brief Compact copy of first()'s genome, only valid while speciating
+    std::unique_ptr< GenomeManager::Representative > representative;
+
+    /// \brief Generation in which an organism from elsewhere last joined.
+    /// Species are searched in most-recently-matched order.
+    int last_matched;
+
     /// \brief
     bool add_Organism(SpeciesOrganism *o);
 
@@ -119,6 +137,12 @@ namespace NEAT
     /// \brief Remove an organism from Species
     void remove_eliminated();
 
+    /// \brief Remove a single organism, keeping average_est up to date
+    void remove_Organism(SpeciesOrganism *o);
+
+    /// \brief Add a freshly evaluated organism to average_est
+    void add_evaluated(SpeciesOrganism *o);
+
     /// \brief
     void remove_generation(int gen);
 
@@ -135,15 +159,29 @@ namespace NEAT
             class GenomeManager *genome_manager,
             std::vector< Species * > &sorted_species);
 
+    /// \brief Create a single offspring from the evaluated organisms, for
+    /// steady-state evolution. sorted_species are the species with evaluated
+    /// organisms, best average_est first.
+    void reproduce_one(
+            SpeciesOrganism &baby,
+            class GenomeManager *genome_manager,
+            std::vector< Species * > &sorted_species);
+
+    /// \brief Fittest evaluated organism, or nullptr
+    SpeciesOrganism *best_evaluated();
+
     // *** Real-time methods ***
     /// \brief
-    Species(int i);
+    Species(
+            int i,
+            const NeatEnv *env);
 
     /// \brief Allows the creation of a Species that won't age (a novel one)
     /// this protects new Species from aging inside their first generation
     Species(
             int i,
-            bool n);
+            bool n,
+            const NeatEnv *env);
 
     /// \brief
     ~Species();
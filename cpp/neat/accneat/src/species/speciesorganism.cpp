@@ -19,6 +19,7 @@
 
 #include <algorithm>
 
+#include "genomemanager.h"
 #include "network/network.h"
 #include "speciesorganism.h"
 #include "species.h"
@@ -26,16 +27,20 @@
 using namespace NEAT;
 using namespace std;
 
-SpeciesOrganism::SpeciesOrganism(const SpeciesOrganism &other)
+SpeciesOrganism::SpeciesOrganism(
+        const SpeciesOrganism &other,
+        GenomeManager *genome_manager)
 {
-  this->genome = env->genome_manager->make_default();
+  this->genome = genome_manager->make_default();
   this->net = unique_ptr< Network >(Network::create());
   other.copy_into(*this);
 }
 
-SpeciesOrganism::SpeciesOrganism(const Genome &genome)
+SpeciesOrganism::SpeciesOrganism(
+        const Genome &genome,
+        GenomeManager *genome_manager)
 {
-  this->genome = env->genome_manager->make_default();
+  this->genome = genome_manager->make_default();
   *this->genome = genome;
   this->net = unique_ptr< Network >(Network::create());
   init(0);
@@ -55,6 +60,7 @@ void SpeciesOrganism::init(int gen)
   eliminate = false;
   champion = false;
   super_champ_offspring = 0;
+  evaluated = false;
 }
 
 void
@@ -72,6 +78,7 @@ SpeciesOrganism::copy_into(Organism &dst_) const
   copy(eliminate);
   copy(champion);
   copy(super_champ_offspring);
+  copy(evaluated);
 
 #undef copy
 }
@@ -48,11 +48,21 @@ namespace NEAT
     /// \brief Number of reserved offspring for a population leader
     int super_champ_offspring;
 
+    /// \brief Set once the fitness is known, in steady-state evolution
+    bool evaluated;
+
+    /// \brief
+    SpeciesOrganism(
+            const SpeciesOrganism &other,
+            class GenomeManager *genome_manager);
+
     /// \brief
-    SpeciesOrganism(const SpeciesOrganism &other);
+    SpeciesOrganism(
+            const Genome &genome,
+            class GenomeManager *genome_manager);
 
     /// \brief
-    SpeciesOrganism(const Genome &genome);
+    SpeciesOrganism(SpeciesOrganism &&other) = default;
 
     /// \brief
     virtual ~SpeciesOrganism();
@@ -43,6 +43,7 @@
 #include "genomemanager.h"
 #include "organism.h"
 #include "species.h"
+#include "util/scheduler.h"
 #include "util/timer.h"
 #include "util/util.h"
 
@@ -53,10 +54,14 @@ using namespace std;
 
 SpeciesPopulation::SpeciesPopulation(
         rng_t rng,
-        vector< unique_ptr< Genome>> &seeds)
-        : norgs(seeds.size())
+        vector< unique_ptr< Genome>> &seeds,
+        const NeatEnv *env)
+        : Population(env)
+        , norgs(seeds.size())
         , generation(0)
-        , orgs(rng, seeds, seeds.size())
+        , orgs(rng, seeds, env->genome_manager, seeds.size())
+        , nevaluated(0)
+        , nreplaced(0)
         , highest_fitness(0.0)
         , highest_last_changed(0)
 {
@@ -89,7 +94,8 @@ Organism *SpeciesPopulation::get(size_t index)
 
 unique_ptr< Organism > SpeciesPopulation::make_copy(size_t index)
 {
-  SpeciesOrganism *copy = new SpeciesOrganism((SpeciesOrganism &)*get(index));
+  SpeciesOrganism *copy = new SpeciesOrganism((SpeciesOrganism &)*get(index),
+                                              env->genome_manager);
   return unique_ptr< Organism >(copy);
 }
 
@@ -111,26 +117,200 @@ void SpeciesPopulation::spawn()
 
 void SpeciesPopulation::speciate()
 {
+  GenomeManager *genome_manager = env->genome_manager;
+
+  // Most recently matched species first.
+  std::vector< Species * > search_order;
+
   last_species = 0;
   for (SpeciesOrganism &org: orgs.curr())
   {
     assert(org.species == nullptr);
-    for (Species *s: species)
+    for (size_t i = 0; i < search_order.size(); i++)
     {
-      if (env->genome_manager->are_compatible(*org.genome, *s->first()->genome))
+      Species *s = search_order[i];
+      if (genome_manager->is_compatible(*org.genome, *s->representative))
       {
         org.species = s;
+        std::rotate(search_order.begin(),
+                    search_order.begin() + i,
+                    search_order.begin() + i + 1);
         break;
       }
     }
     if (not org.species)
     {
-      Species *s = new Species(++last_species);
+      Species *s = new Species(++last_species, env);
+      s->representative = genome_manager->make_representative(*org.genome);
       species.push_back(s);
+      search_order.insert(search_order.begin(), s);
       org.species = s;
     }
     org.species->add_Organism(&org);
   }
+
+  for (Species *s: species)
+  {
+    s->representative.reset();
+  }
+}
+
+void SpeciesPopulation::speciate_one(
+        SpeciesOrganism &org,
+        Species *origin)
+{
+  GenomeManager *genome_manager = env->genome_manager;
+
+  assert(org.species == nullptr);
+  if (genome_manager->are_compatible(*org.genome, *origin->first()->genome))
+  {
+    org.species = origin;
+  }
+  else
+  {
+    for (Species *s: species)
+    {
+      if ((s not_eq origin)
+          and genome_manager->are_compatible(*org.genome, *s->first()->genome))
+      {
+        org.species = s;
+        s->last_matched = generation;
+        break;
+      }
+    }
+  }
+
+  if (not org.species)
+  {
+    org.species = new Species(++last_species, true, env);
+    species.push_back(org.species);
+  }
+  org.species->add_Organism(&org);
+}
+
+void SpeciesPopulation::evaluated(size_t index)
+{
+  SpeciesOrganism &org = orgs.curr()[index];
+  assert(not org.evaluated);
+
+  org.evaluated = true;
+  org.species->add_evaluated(&org);
+  nevaluated++;
+}
+
+int SpeciesPopulation::replace_worst(size_t min_evaluated)
+{
+  if (nevaluated < std::max(min_evaluated, size_t(2)))
+  {
+    return -1;
+  }
+
+  // Lowest fitness after sharing it within the species, see adjust_fitness()
+  SpeciesOrganism *worst = nullptr;
+  real_t worst_fitness = 0.0;
+  for (SpeciesOrganism &org: orgs.curr())
+  {
+    if (org.evaluated)
+    {
+      real_t shared_fitness = org.eval.fitness / org.species->size();
+      if ((worst == nullptr) or (shared_fitness < worst_fitness))
+      {
+        worst = &org;
+        worst_fitness = shared_fitness;
+      }
+    }
+  }
+
+  Species *old_species = worst->species;
+  old_species->remove_Organism(worst);
+  nevaluated--;
+  if (old_species->organisms.empty())
+  {
+    species.erase(std::find(species.begin(), species.end(), old_species));
+    delete old_species;
+  }
+
+  // Species take turns at reproducing in proportion to their average fitness
+  std::vector< Species * > sorted_species;
+  real_t total_average = 0.0;
+  for (Species *s: species)
+  {
+    if (s->nevaluated)
+    {
+      sorted_species.push_back(s);
+      total_average += std::max(real_t(0.0), s->average_est);
+    }
+  }
+  std::sort(sorted_species.begin(),
+            sorted_species.end(),
+            [](Species *x, Species *y)
+            {
+              return x->average_est > y->average_est;
+            });
+
+  SpeciesOrganism &baby = *worst;
+  rng_t &rng = baby.genome->rng;
+
+  Species *parent_species = sorted_species.back();
+  if (total_average > 0.0)
+  {
+    real_t marble = rng.prob() * total_average;
+    for (Species *s: sorted_species)
+    {
+      marble -= std::max(real_t(0.0), s->average_est);
+      if (marble <= 0.0)
+      {
+        parent_species = s;
+        break;
+      }
+    }
+  }
+  else
+  {
+    parent_species = rng.element(sorted_species);
+  }
+
+  baby.init(generation);
+  parent_species->reproduce_one(baby,
+                                env->genome_manager,
+                                sorted_species);
+  env->genome_manager->apply_innovations();
+  speciate_one(baby, parent_species);
+  baby.genome->init_phenotype(*baby.net);
+
+  // Every norgs offspring make up a generation, as far as aging and the
+  // genome manager's search phases are concerned.
+  if ((++nreplaced % norgs) == 0)
+  {
+    generation++;
+
+    real_t max_fitness = highest_fitness;
+    for (SpeciesOrganism &org: orgs.curr())
+    {
+      if (org.evaluated)
+      {
+        max_fitness = std::max(max_fitness, org.eval.fitness);
+      }
+    }
+    bool new_highest_fitness = max_fitness > highest_fitness;
+    highest_fitness = max_fitness;
+
+    for (Species *s: species)
+    {
+      if (s->novel)
+      {
+        s->novel = false;
+      }
+      else
+      {
+        s->age++;
+      }
+    }
+
+    env->genome_manager->finalize_generation(new_highest_fitness);
+  }
+
+  return static_cast<int>(baby.population_index);
 }
 
 // void
@@ -378,7 +558,8 @@ void SpeciesPopulation::next_generation()
   {
     Species *species;
     int ioffspring;
-  } reproduce_parms[norgs];
+  };
+  std::vector< reproduce_parms_t > reproduce_parms(norgs);
 
   {
     size_t iorg = 0;
@@ -401,21 +582,29 @@ void SpeciesPopulation::next_generation()
     static Timer timer("reproduce");
     timer.start();
 
-#ifdef WITH_OPENMP
-#pragma omp parallel for
-#endif
-    for (size_t iorg = 0; iorg < norgs; iorg++)
-    {
-      SpeciesOrganism &baby = orgs.curr()[iorg];
-      reproduce_parms_t &parms = reproduce_parms[iorg];
-
-      assert(baby.population_index == iorg);
-
-      parms.species->reproduce(parms.ioffspring,
-                               baby,
-                               env->genome_manager,
-                               sorted_species);
-    }
+    // Offspring size is unknown until mating, so the size of the species'
+    // champion stands in for it. Every baby has its own rng and innovations
+    // are applied in population order, so the schedule doesn't affect results.
+    static Scheduler scheduler("reproduce");
+    scheduler.run(norgs,
+                  [&reproduce_parms](size_t iorg)
+                  {
+                    Genome::Stats stats =
+                            reproduce_parms[iorg].species->first()->genome->get_stats();
+                    return stats.nnodes + stats.nlinks;
+                  },
+                  [&](size_t iorg)
+                  {
+                    SpeciesOrganism &baby = orgs.curr()[iorg];
+                    reproduce_parms_t &parms = reproduce_parms[iorg];
+
+                    assert(baby.population_index == iorg);
+
+                    parms.species->reproduce(parms.ioffspring,
+                                             baby,
+                                             env->genome_manager,
+                                             sorted_species);
+                  });
 
     env->genome_manager->finalize_generation(new_highest_fitness);
 
@@ -426,6 +615,28 @@ void SpeciesPopulation::next_generation()
     static Timer timer("speciate");
     timer.start();
 
+    GenomeManager *genome_manager = env->genome_manager;
+
+    // Take a compact copy of every representative up front, and search the
+    // species that most recently picked up outsiders first. The order is
+    // fixed for the whole loop, so the result doesn't depend on threads.
+    std::vector< Species * > search_order;
+    for (Species *s: species)
+    {
+      if (s->size())
+      {
+        s->representative = genome_manager->make_representative(
+                *s->first()->genome);
+        search_order.push_back(s);
+      }
+    }
+    std::stable_sort(search_order.begin(),
+                     search_order.end(),
+                     [](Species *x, Species *y)
+                     {
+                       return x->last_matched > y->last_matched;
+                     });
+
     {
 #ifdef WITH_OPENMP
 #pragma omp parallel for
@@ -435,9 +646,8 @@ void SpeciesPopulation::next_generation()
         SpeciesOrganism &org = orgs.curr()[i];
         Species *origin_species = reproduce_parms[i].species;
 
-        if (env->genome_manager->are_compatible(
-                *org.genome,
-                *origin_species->first()->genome))
+        if (genome_manager->is_compatible(*org.genome,
+                                          *origin_species->representative))
         {
           org.species = origin_species;
         }
@@ -445,12 +655,12 @@ void SpeciesPopulation::next_generation()
         {
           org.species = nullptr;
 
-          for (Species *s: species)
+          for (Species *s: search_order)
           {
-            if (s->size() and (s not_eq origin_species))
+            if (s not_eq origin_species)
             {
-              if (env->genome_manager->are_compatible(*org.genome,
-                                                      *s->first()->genome))
+              if (genome_manager->is_compatible(*org.genome,
+                                                *s->representative))
               {
                 org.species = s;
                 break;
@@ -463,19 +673,24 @@ void SpeciesPopulation::next_generation()
 
     size_t index_new_species = species.size();
 
-    for (SpeciesOrganism &org: orgs.curr())
+    for (size_t i = 0; i < norgs; i++)
     {
-      if (not org.species)
+      SpeciesOrganism &org = orgs.curr()[i];
+      if (org.species and (org.species not_eq reproduce_parms[i].species))
+      {
+        org.species->last_matched = generation;
+      }
+      else if (not org.species)
       {
         // It didn't fit into any of the existing species. Check if it fits
         // into one we've just created.
-        for (size_t i = index_new_species, n = species.size();
-             i < n;
-             i++)
+        for (size_t j = index_new_species, n = species.size();
+             j < n;
+             j++)
         {
-          Species *s = species[i];
-          if (env->genome_manager->are_compatible(*org.genome,
-                                                  *s->first()->genome))
+          Species *s = species[j];
+          if (genome_manager->is_compatible(*org.genome,
+                                            *s->representative))
           {
             org.species = s;
             break;
@@ -485,13 +700,21 @@ void SpeciesPopulation::next_generation()
         if (not org.species)
         {
           org.species = new Species(++last_species,
-                                    true);
+                                    true,
+                                    env);
+          org.species->representative =
+                  genome_manager->make_representative(*org.genome);
           species.push_back(org.species);
         }
       }
       org.species->add_Organism(&org);
     }
 
+    for (Species *s: species)
+    {
+      s->representative.reset();
+    }
+
     timer.stop();
   }
 
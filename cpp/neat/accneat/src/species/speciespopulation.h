@@ -53,7 +53,8 @@ namespace NEAT
     /// \brief Construct off of a single spawning Genome
     SpeciesPopulation(
             rng_t rng,
-            std::vector< std::unique_ptr< Genome>> &seeds);
+            std::vector< std::unique_ptr< Genome>> &seeds,
+            const NeatEnv *env);
 
     /// \brief
     virtual ~SpeciesPopulation();
@@ -73,6 +74,20 @@ namespace NEAT
     /// \brief
     virtual void verify() override;
 
+    /// \brief
+    virtual bool supports_steady_state() override
+    {
+      return true;
+    }
+
+    /// \brief Adds the organism's fitness to its species' average_est
+    virtual void evaluated(size_t index) override;
+
+    /// \brief Real-time NEAT: the organism with the lowest fitness divided by
+    /// its species' size makes room for an offspring of a species picked in
+    /// proportion to its average_est.
+    virtual int replace_worst(size_t min_evaluated) override;
+
     //    virtual void
     //    write(std::ostream &out) override;
 
@@ -83,6 +98,12 @@ namespace NEAT
     /// \brief
     void speciate();
 
+    /// \brief Puts a single new organism in a species, creating one if needed.
+    /// origin is searched first.
+    void speciate_one(
+            SpeciesOrganism &org,
+            Species *origin);
+
     /// \brief
     size_t norgs;
 
@@ -92,6 +113,12 @@ namespace NEAT
     /// \brief
     OrganismsBuffer< SpeciesOrganism > orgs;
 
+    /// \brief Number of evaluated organisms, in steady-state evolution
+    size_t nevaluated;
+
+    /// \brief Number of organisms replaced in steady-state evolution
+    size_t nreplaced;
+
     /// \brief Species in the SpeciesPopulation. Note that the species should
     /// comprise all the genomes
     std::vector< class Species * > species;
@@ -0,0 +1,139 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Little-endian binary files, read through mmap
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "binaryio.h"
+
+using namespace NEAT;
+using namespace std;
+
+bool NEAT::is_little_endian()
+{
+  const uint32_t one = 1;
+  uint8_t first;
+  memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+void BinaryWriter::write_string(const string &str)
+{
+  write(uint32_t(str.size()));
+  write_bytes(str.data(), str.size());
+}
+
+void BinaryWriter::write_bytes(
+        const void *data,
+        size_t len)
+{
+  _out.write(static_cast<const char *>(data), len);
+  _offset += len;
+}
+
+void BinaryWriter::align(size_t alignment)
+{
+  static const char zeros[16] = {0};
+  size_t pad = (alignment - _offset % alignment) % alignment;
+  write_bytes(zeros, pad);
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+bool MappedFile::open(const string &path)
+{
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) not_eq 0)
+  {
+    ::close(fd);
+    return false;
+  }
+
+  _size = st.st_size;
+  if (_size > 0)
+  {
+    void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+      ::close(fd);
+      _size = 0;
+      return false;
+    }
+    _data = static_cast<const char *>(data);
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  ::close(fd);
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (_data)
+  {
+    munmap(const_cast<char *>(_data), _size);
+  }
+  _data = nullptr;
+  _size = 0;
+}
+
+string BinaryReader::read_string()
+{
+  uint32_t len = read< uint32_t >();
+  if (not reserve(len))
+  {
+    return string();
+  }
+  string str(_pos, len);
+  _pos += len;
+  return str;
+}
+
+void BinaryReader::align(size_t alignment)
+{
+  size_t offset = _pos - _begin;
+  size_t pad = (alignment - offset % alignment) % alignment;
+  if (reserve(pad))
+  {
+    _pos += pad;
+  }
+}
+
+bool BinaryReader::reserve(size_t len)
+{
+  if (not _good or (len > size_t(_end - _pos)))
+  {
+    _good = false;
+    return false;
+  }
+  return true;
+}
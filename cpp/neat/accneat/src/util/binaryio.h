@@ -0,0 +1,204 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Little-endian binary files, read through mmap
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_UTIL_BINARYIO_H_
+#define CPP_NEAT_ACCNEAT_SRC_UTIL_BINARYIO_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace NEAT
+{
+  /// \brief True when the host stores numbers little-endian, which is the
+  /// byte order of all binary files. Arrays are stored in host layout so
+  /// they can be used in place, which only works on such hosts.
+  bool is_little_endian();
+
+  ///
+  /// CLASS BinaryWriter
+  ///
+  class BinaryWriter
+  {
+    std::ostream &_out;
+
+    size_t _offset = 0;
+
+    public:
+    BinaryWriter(std::ostream &out)
+            : _out(out)
+    {}
+
+    template < typename T >
+    void write(const T &value)
+    {
+      static_assert(std::is_trivially_copyable< T >::value,
+                    "Only plain data can be written");
+      write_bytes(&value, sizeof(T));
+    }
+
+    /// \brief Writes n elements, preceded by padding up to the alignment
+    /// of T so that the reader can use them in place.
+    template < typename T >
+    void write_array(
+            const T *values,
+            size_t n)
+    {
+      static_assert(std::is_trivially_copyable< T >::value,
+                    "Only plain data can be written");
+      align(alignof(T));
+      write_bytes(values, n * sizeof(T));
+    }
+
+    /// \brief Length as uint32, followed by the characters
+    void write_string(const std::string &str);
+
+    void write_bytes(
+            const void *data,
+            size_t len);
+
+    void align(size_t alignment);
+
+    size_t offset() const
+    {
+      return _offset;
+    }
+
+    bool good() const
+    {
+      return _out.good();
+    }
+  };
+
+  ///
+  /// CLASS MappedFile
+  ///
+  /// A whole file mapped read-only into memory.
+  ///
+  class MappedFile
+  {
+    const char *_data = nullptr;
+
+    size_t _size = 0;
+
+    public:
+    MappedFile()
+    {}
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    bool open(const std::string &path);
+
+    void close();
+
+    const char *data() const
+    {
+      return _data;
+    }
+
+    size_t size() const
+    {
+      return _size;
+    }
+  };
+
+  ///
+  /// CLASS BinaryReader
+  ///
+  /// Reads what a BinaryWriter wrote, from memory. Reading past the end
+  /// clears good() and yields zeros or null pointers instead.
+  ///
+  class BinaryReader
+  {
+    const char *_begin;
+
+    const char *_pos;
+
+    const char *_end;
+
+    bool _good = true;
+
+    public:
+    BinaryReader(
+            const char *data,
+            size_t size)
+            : _begin(data)
+            , _pos(data)
+            , _end(data + size)
+    {}
+
+    template < typename T >
+    T read()
+    {
+      T value;
+      std::memset(&value, 0, sizeof(T));
+      if (reserve(sizeof(T)))
+      {
+        std::memcpy(&value, _pos, sizeof(T));
+        _pos += sizeof(T);
+      }
+      return value;
+    }
+
+    /// \brief Returns the n elements written by write_array() without
+    /// copying them.
+    template < typename T >
+    const T *read_array(size_t n)
+    {
+      align(alignof(T));
+      if (not _good or (n > size_t(_end - _pos) / sizeof(T)))
+      {
+        _good = false;
+        return nullptr;
+      }
+      const T *values = reinterpret_cast<const T *>(_pos);
+      _pos += n * sizeof(T);
+      return values;
+    }
+
+    std::string read_string();
+
+    void align(size_t alignment);
+
+    bool good() const
+    {
+      return _good;
+    }
+
+    /// \brief Number of bytes not read yet
+    size_t remaining() const
+    {
+      return size_t(_end - _pos);
+    }
+
+    private:
+    bool reserve(size_t len);
+  };
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Fitness of recently evaluated genomes, by genome hash
+* Author: TODO <Add proper author>
+*
+*/
+
+#include "fitnesscache.h"
+
+using namespace NEAT;
+using namespace std;
+
+FitnessCache::FitnessCache(
+        size_t capacity,
+        size_t samples)
+        : _capacity(capacity)
+        , _samples(samples > 0 ? samples : 1)
+        , _hits(0)
+{
+}
+
+bool FitnessCache::lookup(
+        uint64_t hash,
+        double &fitness)
+{
+  if ((_capacity == 0) or (hash == 0))
+  {
+    return false;
+  }
+
+  lock_guard< mutex > lock(_mutex);
+  auto it = _index.find(hash);
+  if ((it == _index.end()) or (it->second->count < _samples))
+  {
+    return false;
+  }
+
+  _entries.splice(_entries.begin(), _entries, it->second);
+  fitness = it->second->sum / it->second->count;
+  _hits++;
+  return true;
+}
+
+void FitnessCache::add(
+        uint64_t hash,
+        double fitness)
+{
+  if ((_capacity == 0) or (hash == 0))
+  {
+    return;
+  }
+
+  lock_guard< mutex > lock(_mutex);
+  auto it = _index.find(hash);
+  if (it not_eq _index.end())
+  {
+    _entries.splice(_entries.begin(), _entries, it->second);
+    it->second->sum += fitness;
+    it->second->count++;
+    return;
+  }
+
+  if (_entries.size() == _capacity)
+  {
+    _index.erase(_entries.back().hash);
+    _entries.pop_back();
+  }
+  _entries.push_front({hash, fitness, 1});
+  _index.emplace(hash, _entries.begin());
+}
+
+size_t FitnessCache::hits()
+{
+  lock_guard< mutex > lock(_mutex);
+  return _hits;
+}
@@ -0,0 +1,121 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Fitness of recently evaluated genomes, by genome hash
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_UTIL_FITNESSCACHE_H_
+#define CPP_NEAT_ACCNEAT_SRC_UTIL_FITNESSCACHE_H_
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace NEAT
+{
+  ///
+  /// CLASS FitnessCache
+  ///
+  /// Remembers the fitness of the genomes evaluated last, keyed by a hash of
+  /// the genome (see Genome::get_hash()), so that offspring identical to one
+  /// of them needn't be evaluated again. Once the cache is full the least
+  /// recently used genome is forgotten. Hash 0 stands for a genome that can't
+  /// be hashed and is never cached. Safe to use from several threads.
+  ///
+  class FitnessCache
+  {
+    public:
+    /// \param capacity Number of genomes remembered; 0 disables the cache
+    /// \param samples Number of evaluations of a genome that are averaged
+    /// before the average is reused instead of evaluating it again
+    FitnessCache(
+            size_t capacity,
+            size_t samples = 1);
+
+    /// \brief False if the capacity is 0, so there is no need to hash
+    bool enabled() const
+    {
+      return _capacity > 0;
+    }
+
+    /// \brief If the genome with this hash has been evaluated at least
+    /// samples times, sets fitness to the average and returns true
+    bool lookup(
+            uint64_t hash,
+            double &fitness);
+
+    /// \brief Adds an evaluation of the genome with this hash
+    void add(
+            uint64_t hash,
+            double fitness);
+
+    /// \brief Number of successful lookups so far
+    size_t hits();
+
+    /// \brief Mixes value into the hash h
+    static uint64_t combine(
+            uint64_t h,
+            uint64_t value)
+    {
+      // boost::hash_combine followed by the finalizer of MurmurHash3, so that
+      // the order of the values matters and every bit reaches the whole hash.
+      h ^= value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+    /// \brief A weight rounded to a multiple of quantum, as an integer that
+    /// can be passed to combine(). quantum has to be positive; the owners of
+    /// a cache reject any other quantum when they are configured.
+    static uint64_t quantize(
+            double weight,
+            double quantum)
+    {
+      return static_cast< uint64_t >(std::llround(weight / quantum));
+    }
+
+    private:
+    struct Entry
+    {
+      uint64_t hash;
+      double sum;
+      size_t count;
+    };
+
+    const size_t _capacity;
+
+    const size_t _samples;
+
+    std::mutex _mutex;
+
+    /// \brief Most recently used first
+    std::list< Entry > _entries;
+
+    std::unordered_map< uint64_t, std::list< Entry >::iterator > _index;
+
+    size_t _hits;
+  };
+}
+
+#endif
@@ -429,7 +429,7 @@ namespace NEAT
     return map;
   }
 
-  Map parse_map(string &path)
+  Map parse_map(const string &path)
   {
     std::map< std::string, Section > sections = parse_sections(path);
 
@@ -23,10 +23,13 @@
 #pragma once
 
 #include <assert.h>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "organism.h"
 #include "rng.h"
+#include "scheduler.h"
 
 namespace NEAT
 {
@@ -47,6 +50,7 @@ namespace NEAT
     OrganismsBuffer(
             rng_t rng,
             std::vector< std::unique_ptr< Genome>> &seeds,
+            class GenomeManager *genome_manager,
             size_t n,
             size_t population_index = 0)
             : _n(n)
@@ -58,7 +62,7 @@ namespace NEAT
 
       for (size_t i = 0; i < n; i++)
       {
-        _a.emplace_back(*seeds[i + population_index]);
+        _a.emplace_back(*seeds[i + population_index], genome_manager);
         size_t ipop = i + population_index;
         _a[i].population_index = ipop;
         _a[i].net->population_index = ipop;
@@ -67,7 +71,7 @@ namespace NEAT
       }
       for (size_t i = 0; i < n; i++)
       {
-        _b.emplace_back(*seeds[i + population_index]);
+        _b.emplace_back(*seeds[i + population_index], genome_manager);
         size_t ipop = i + population_index;
         _b[i].population_index = ipop;
         _b[i].net->population_index = ipop;
@@ -78,11 +82,67 @@ namespace NEAT
 
     void init_phenotypes()
     {
-#pragma omp parallel for
+      match_networks();
+
+      static Scheduler scheduler("init_phenotypes");
+      scheduler.run(_n,
+                    [this](size_t i)
+                    {
+                      Genome::Stats stats = curr()[i].genome->get_stats();
+                      return stats.nnodes + stats.nlinks;
+                    },
+                    [this](size_t i)
+                    {
+                      Organism &org = curr()[i];
+                      org.genome->init_phenotype(*org.net);
+                    });
+    }
+
+    /// \brief Swaps the networks of the current generation around, so that
+    /// organisms whose genome only changed in its weights get a network that
+    /// already has the genome's layout, when there is one.
+    void match_networks()
+    {
+      std::vector< TOrganism > &orgs = curr();
+      std::vector< std::unique_ptr< Network > > spare;
+      std::unordered_multimap< uint64_t, size_t > spare_by_layout;
+      std::vector< size_t > needy;
+
       for (size_t i = 0; i < _n; i++)
       {
-        Organism &org = curr()[i];
-        org.genome->init_phenotype(*org.net);
+        TOrganism &org = orgs[i];
+        uint64_t layout_id = org.genome->get_layout_id();
+        if ((layout_id == 0) or (org.net->layout_id not_eq layout_id))
+        {
+          spare_by_layout.emplace(org.net->layout_id, spare.size());
+          spare.push_back(std::move(org.net));
+          needy.push_back(i);
+        }
+      }
+
+      // First give out the nets with a matching layout, then the rest.
+      for (size_t i: needy)
+      {
+        auto it = spare_by_layout.find(orgs[i].genome->get_layout_id());
+        if (it not_eq spare_by_layout.end())
+        {
+          orgs[i].net = std::move(spare[it->second]);
+          spare_by_layout.erase(it);
+        }
+      }
+      size_t next = 0;
+      for (size_t i: needy)
+      {
+        TOrganism &org = orgs[i];
+        if (not org.net)
+        {
+          while (not spare[next])
+          {
+            next++;
+          }
+          org.net = std::move(spare[next]);
+        }
+        org.net->population_index = org.population_index;
       }
     }
 
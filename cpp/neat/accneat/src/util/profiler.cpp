@@ -0,0 +1,284 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Scoped per-thread profiler with trace export
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "profiler.h"
+#include "timer.h"
+
+using namespace NEAT;
+using namespace std;
+
+std::atomic< bool > Profiler::_enabled(false);
+
+namespace
+{
+  struct Event
+  {
+    const char *name;
+
+    double start;
+
+    /// \brief 0 while the span is open
+    double end;
+
+    uint32_t depth;
+  };
+
+  struct ThreadLog
+  {
+    size_t tid;
+
+    vector< Event > events;
+
+    /// \brief Indices in events of the open spans, innermost last
+    vector< size_t > open;
+  };
+
+  /// \brief Owns the logs of all threads, so they survive their threads
+  struct Registry
+  {
+    mutex lock;
+
+    vector< unique_ptr< ThreadLog > > logs;
+
+    double origin = 0.0;
+  };
+
+  Registry &registry()
+  {
+    static Registry reg;
+    return reg;
+  }
+
+  ThreadLog &thread_log()
+  {
+    static thread_local ThreadLog *log = nullptr;
+    if (not log)
+    {
+      Registry &reg = registry();
+      lock_guard< mutex > guard(reg.lock);
+      reg.logs.emplace_back(new ThreadLog());
+      log = reg.logs.back().get();
+      log->tid = reg.logs.size() - 1;
+    }
+    return *log;
+  }
+
+  string escape(const char *s)
+  {
+    string result;
+    for (; *s; s++)
+    {
+      if ((*s == '"') or (*s == '\\'))
+      {
+        result += '\\';
+      }
+      result += *s;
+    }
+    return result;
+  }
+
+  /// \brief Writes the logs at exit when NEAT_PROFILE is set
+  struct EnvProfile
+  {
+    string prefix;
+
+    EnvProfile()
+    {
+      // Make sure the registry is destroyed after this object.
+      registry();
+
+      const char *env = getenv("NEAT_PROFILE");
+      if (env and *env)
+      {
+        prefix = env;
+        Profiler::enable();
+      }
+    }
+
+    ~EnvProfile()
+    {
+      if (not prefix.empty())
+      {
+        Profiler::enable(false);
+        Profiler::write_chrome_trace(prefix + ".json");
+        Profiler::write_csv(prefix + ".csv");
+      }
+    }
+  } env_profile;
+}
+
+void Profiler::enable(bool on)
+{
+  if (on)
+  {
+    Registry &reg = registry();
+    lock_guard< mutex > guard(reg.lock);
+    if (reg.origin == 0.0)
+    {
+      reg.origin = Timer::now();
+    }
+  }
+  _enabled.store(on, memory_order_relaxed);
+}
+
+void Profiler::begin(const char *name)
+{
+  ThreadLog &log = thread_log();
+  log.open.push_back(log.events.size());
+  log.events.push_back(Event{name,
+                             Timer::now(),
+                             0.0,
+                             static_cast<uint32_t>(log.open.size() - 1)});
+}
+
+void Profiler::end()
+{
+  double now = Timer::now();
+  ThreadLog &log = thread_log();
+  assert(not log.open.empty());
+  log.events[log.open.back()].end = now;
+  log.open.pop_back();
+}
+
+void Profiler::clear()
+{
+  Registry &reg = registry();
+  lock_guard< mutex > guard(reg.lock);
+  for (auto &log: reg.logs)
+  {
+    log->events.clear();
+    log->open.clear();
+  }
+  reg.origin = Timer::now();
+}
+
+bool Profiler::write_chrome_trace(const std::string &path)
+{
+  ofstream out(path);
+  if (not out)
+  {
+    return false;
+  }
+
+  Registry &reg = registry();
+  lock_guard< mutex > guard(reg.lock);
+
+  // Complete ("X") events with microsecond timestamps.
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (auto &log: reg.logs)
+  {
+    out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\","
+        << "\"pid\":0,\"tid\":" << log->tid
+        << ",\"args\":{\"name\":\"thread " << log->tid << "\"}}";
+    first = false;
+
+    for (const Event &e: log->events)
+    {
+      if (e.end == 0.0)
+      {
+        continue;
+      }
+      out << ",\n{\"name\":\"" << escape(e.name)
+          << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << log->tid
+          << ",\"ts\":" << static_cast<int64_t>((e.start - reg.origin) * 1e6)
+          << ",\"dur\":" << static_cast<int64_t>((e.end - e.start) * 1e6)
+          << "}";
+    }
+  }
+  out << "\n]}\n";
+
+  return bool(out);
+}
+
+bool Profiler::write_csv(const std::string &path)
+{
+  ofstream out(path);
+  if (not out)
+  {
+    return false;
+  }
+
+  struct Summary
+  {
+    size_t calls = 0;
+    double total = 0.0;
+    double self = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+  };
+  map< string, Summary > summaries;
+
+  Registry &reg = registry();
+  lock_guard< mutex > guard(reg.lock);
+  for (auto &log: reg.logs)
+  {
+    // Spans are logged in the order they were opened, so the parent of a
+    // span is the latest one seen at the depth above.
+    vector< Summary * > parents;
+    for (const Event &e: log->events)
+    {
+      parents.resize(e.depth);
+      if (e.end == 0.0)
+      {
+        parents.push_back(nullptr);
+        continue;
+      }
+
+      double t = e.end - e.start;
+      Summary &s = summaries[e.name];
+      s.min = (s.calls == 0) ? t : min(s.min, t);
+      s.max = (s.calls == 0) ? t : max(s.max, t);
+      s.calls++;
+      s.total += t;
+      s.self += t;
+      if ((e.depth > 0) and parents[e.depth - 1])
+      {
+        parents[e.depth - 1]->self -= t;
+      }
+      parents.push_back(&s);
+    }
+  }
+
+  out << "name,calls,total_s,self_s,mean_s,min_s,max_s\n";
+  for (auto &kv: summaries)
+  {
+    const Summary &s = kv.second;
+    out << kv.first << ","
+        << s.calls << ","
+        << s.total << ","
+        << s.self << ","
+        << s.total / s.calls << ","
+        << s.min << ","
+        << s.max << "\n";
+  }
+
+  return bool(out);
+}
@@ -0,0 +1,113 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Scoped per-thread profiler with trace export
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_UTIL_PROFILER_H_
+#define CPP_NEAT_ACCNEAT_SRC_UTIL_PROFILER_H_
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+namespace NEAT
+{
+  ///
+  /// CLASS Profiler
+  ///
+  /// Records nested, named time spans per thread. Every thread appends to
+  /// its own log, so recording takes no locks; while the profiler is
+  /// disabled, which is the default, a scope costs one relaxed atomic load.
+  ///
+  /// Setting the environment variable NEAT_PROFILE to a path prefix enables
+  /// it at startup and writes <prefix>.json and <prefix>.csv at exit.
+  ///
+  /// The logs can be written out as a Chrome trace (chrome://tracing or
+  /// Perfetto), and as a CSV summary with the calls, total, self, mean,
+  /// minimum and maximum time of every name. Export and clear() must not
+  /// run while other threads are inside a scope.
+  ///
+  class Profiler
+  {
+    public:
+    static bool is_enabled()
+    {
+      return _enabled.load(std::memory_order_relaxed);
+    }
+
+    static void enable(bool on = true);
+
+    /// \brief Opens a span on the calling thread. name must outlive the
+    /// profiler; string literals are the intended use.
+    static void begin(const char *name);
+
+    /// \brief Closes the innermost span opened by the calling thread
+    static void end();
+
+    /// \brief Drops everything recorded so far
+    static void clear();
+
+    static bool write_chrome_trace(const std::string &path);
+
+    static bool write_csv(const std::string &path);
+
+    private:
+    static std::atomic< bool > _enabled;
+  };
+
+  ///
+  /// CLASS ProfileScope
+  ///
+  /// A span from construction to destruction; see NEAT_PROFILE().
+  ///
+  class ProfileScope
+  {
+    bool _active;
+
+    public:
+    explicit ProfileScope(const char *name)
+            : _active(Profiler::is_enabled())
+    {
+      if (_active)
+      {
+        Profiler::begin(name);
+      }
+    }
+
+    ~ProfileScope()
+    {
+      if (_active)
+      {
+        Profiler::end();
+      }
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+
+    ProfileScope &operator=(const ProfileScope &) = delete;
+  };
+}
+
+#define NEAT_PROFILE_CONCAT_(a, b) a##b
+#define NEAT_PROFILE_CONCAT(a, b) NEAT_PROFILE_CONCAT_(a, b)
+
+/// \brief Profiles the rest of the enclosing block under name
+#define NEAT_PROFILE(name) \
+    ::NEAT::ProfileScope NEAT_PROFILE_CONCAT(neat_profile_scope_, __LINE__)(name)
+
+#endif
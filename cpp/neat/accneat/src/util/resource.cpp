@@ -42,6 +42,7 @@ namespace NEAT
     {
       error("Possible buffer overrun.");
     }
+    home[rc] = 0;
 
     *strrchr(home, '/') = 0;
 
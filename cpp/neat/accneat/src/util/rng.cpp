@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <cmath>
 #include <vector>
 
 // Must be included first. Precompiled header with standard library includes.
@@ -28,6 +29,67 @@
 using namespace NEAT;
 using namespace std;
 
+real_t rng_t::gauss()
+{
+  real_t z[2];
+  polar(z);
+  return z[0];
+}
+
+void rng_t::fill_prob(
+        real_t *out,
+        size_t n)
+{
+  size_t i = 0;
+  if (sizeof(real_t) < sizeof(double))
+  {
+    // 24 bits are all a float can hold.
+    const real_t scale = real_t(1.0 / 16777216.0);
+    for (; i + 2 <= n; i += 2)
+    {
+      uint64_t x = engine();
+      out[i] = static_cast<real_t>(x >> 40) * scale;
+      out[i + 1] = static_cast<real_t>((x >> 8) & 0xffffff) * scale;
+    }
+  }
+  for (; i < n; i++)
+  {
+    out[i] = static_cast<real_t>(unit(engine()));
+  }
+}
+
+void rng_t::polar(real_t z[2])
+{
+  // Marsaglia's polar method: a point drawn uniformly from the unit disk
+  // gives two independent normal values, without any trigonometry.
+  double u, v, r2;
+  do
+  {
+    u = 2.0 * unit(engine()) - 1.0;
+    v = 2.0 * unit(engine()) - 1.0;
+    r2 = u * u + v * v;
+  } while ((r2 >= 1.0) or (r2 == 0.0));
+
+  double scale = std::sqrt(-2.0 * std::log(r2) / r2);
+  z[0] = static_cast<real_t>(u * scale);
+  z[1] = static_cast<real_t>(v * scale);
+}
+
+void rng_t::fill_gauss(
+        real_t *out,
+        size_t n)
+{
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+  {
+    polar(out + i);
+  }
+  if (i < n)
+  {
+    out[i] = gauss();
+  }
+}
+
 static bool equals(
         real_t x,
         real_t y)
@@ -145,6 +207,28 @@ void rng_t::test()
     assert_equals(real_t(count[0]) / N, 0.5);
   }
 
+  // fill_prob
+  {
+    const size_t N = 1000000;
+    const size_t NBINS = 5;
+
+    rng_t rng;
+    vector< real_t > x(N);
+    rng.fill_prob(x.data(), N);
+    size_t count[NBINS] = {0};
+
+    for (real_t xi: x)
+    {
+      assert(xi >= 0.0 and xi <= 1.0);
+      count[min(size_t(xi * NBINS), NBINS - 1)]++;
+    }
+
+    for (auto n: count)
+    {
+      assert_equals(n / real_t(N), 1.0 / real_t(NBINS));
+    }
+  }
+
   // gauss
   {
     const size_t N = 10000000;
@@ -171,5 +255,30 @@ void rng_t::test()
     assert_equals(real_t(count_pos[2]) / N, 0.5 - 0.4772);
   }
 
+  // fill_gauss
+  {
+    const size_t N = 10000001;
+    const size_t NBINS = 3;
+
+    rng_t rng;
+    vector< real_t > x(N);
+    rng.fill_gauss(x.data(), N);
+    size_t count_neg[NBINS] = {0};
+    size_t count_pos[NBINS] = {0};
+
+    for (real_t xi: x)
+    {
+      size_t *count = xi < 0 ? count_neg : count_pos;
+      count[min(size_t(abs(xi)), NBINS - 1)]++;
+    }
+
+    assert_equals(real_t(count_neg[0]) / N, 0.3413);
+    assert_equals(real_t(count_neg[1]) / N, 0.4772 - 0.3413);
+    assert_equals(real_t(count_neg[2]) / N, 0.5 - 0.4772);
+    assert_equals(real_t(count_pos[0]) / N, 0.3413);
+    assert_equals(real_t(count_pos[1]) / N, 0.4772 - 0.3413);
+    assert_equals(real_t(count_pos[2]) / N, 0.5 - 0.4772);
+  }
+
   cout << "rng test passed" << endl;
 }
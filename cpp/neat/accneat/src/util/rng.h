@@ -23,6 +23,8 @@
 #pragma once
 
 #include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <random>
 #include <vector>
 
@@ -30,9 +32,81 @@
 
 namespace NEAT
 {
+  ///
+  /// CLASS xoshiro256pp
+  ///
+  /// The xoshiro256++ generator of Blackman and Vigna: 256 bits of state and
+  /// a handful of instructions per 64-bit output. It meets the requirements
+  /// of a uniform random bit generator, so the std distributions accept it.
+  ///
+  class xoshiro256pp
+  {
+    uint64_t s[4];
+
+    static uint64_t rotl(
+            uint64_t x,
+            int k)
+    {
+      return (x << k) | (x >> (64 - k));
+    }
+
+    public:
+    typedef uint64_t result_type;
+
+    static constexpr result_type min()
+    {
+      return 0;
+    }
+
+    static constexpr result_type max()
+    {
+      return UINT64_MAX;
+    }
+
+    explicit xoshiro256pp(uint64_t seedval = 1)
+    {
+      seed(seedval);
+    }
+
+    /// \brief Expands seedval into the state with splitmix64, as
+    /// recommended by the authors
+    void seed(uint64_t seedval)
+    {
+      for (uint64_t &word: s)
+      {
+        uint64_t z = (seedval += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        word = z ^ (z >> 31);
+      }
+    }
+
+    result_type operator()()
+    {
+      uint64_t result = rotl(s[0] + s[3], 23) + s[0];
+      uint64_t t = s[1] << 17;
+      s[2] ^= s[0];
+      s[3] ^= s[1];
+      s[1] ^= s[2];
+      s[0] ^= s[3];
+      s[2] ^= t;
+      s[3] = rotl(s[3], 45);
+      return result;
+    }
+  };
+
   class rng_t
   {
-    std::default_random_engine engine;
+    xoshiro256pp engine;
+
+    /// \brief Value in [0,1) from the top 53 bits of x
+    static double unit(uint64_t x)
+    {
+      return (x >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /// \brief Two independent values from the z distribution
+    void polar(real_t z[2]);
 
     public:
     rng_t()
@@ -77,8 +151,7 @@ namespace NEAT
     // value in [0,1] from uniform distribution
     real_t prob()
     {
-      std::uniform_real_distribution< real_t > dist(0, 1);
-      return dist(engine);
+      return static_cast<real_t>(unit(engine()));
     }
 
     bool under(real_t prob)
@@ -116,22 +189,29 @@ namespace NEAT
     // -1 or 1
     int posneg()
     {
-      std::uniform_int_distribution< int > dist(0, 1);
-      return dist(engine) * 2 - 1;
+      return static_cast<int>(engine() >> 63) * 2 - 1;
     }
 
     bool boolean()
     {
-      std::uniform_int_distribution< int > dist(0, 1);
-      return dist(engine) == 1;
+      return (engine() >> 63) == 1;
     }
 
     // value from z distribution
-    real_t gauss()
-    {
-      std::normal_distribution< real_t > dist;
-      return dist(engine);
-    }
+    real_t gauss();
+
+    /// \brief Fills out with n values of prob(). Cheaper than n calls when
+    /// a loop needs a fixed number of draws per element; in single
+    /// precision every 64-bit output makes two values.
+    void fill_prob(
+            real_t *out,
+            size_t n);
+
+    /// \brief Fills out with n values from the z distribution, generated
+    /// in pairs
+    void fill_gauss(
+            real_t *out,
+            size_t n);
 
     static void test();
   };
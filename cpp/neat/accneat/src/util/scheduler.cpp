@@ -0,0 +1,147 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: TODO: <Add brief description about file purpose>
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include "scheduler.h"
+
+using namespace NEAT;
+using namespace std;
+
+vector< Scheduler * > Scheduler::schedulers;
+
+// Function-level static schedulers may be constructed by several threads.
+static mutex &schedulers_mutex()
+{
+  static mutex m;
+  return m;
+}
+
+Scheduler::Scheduler(const char *name)
+        : _name(name)
+{
+  lock_guard< mutex > lock(schedulers_mutex());
+  schedulers.push_back(this);
+}
+
+Scheduler::~Scheduler()
+{
+  lock_guard< mutex > lock(schedulers_mutex());
+  schedulers.erase(find(schedulers.begin(), schedulers.end(), this));
+}
+
+size_t Scheduler::nthreads()
+{
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+void Scheduler::set_nthreads(size_t n)
+{
+#ifdef _OPENMP
+  omp_set_num_threads(static_cast<int>(n));
+#else
+  (void)n;
+#endif
+}
+
+size_t Scheduler::thread_num()
+{
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+double Scheduler::seconds()
+{
+  return chrono::duration< double >(
+          chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool Scheduler::steal(
+        vector< Queue > &queues,
+        size_t self,
+        size_t &task)
+{
+  // Take the cheapest task of the next non-empty victim; the victim keeps
+  // its large tasks and we don't lose cache locality on them.
+  for (size_t i = 1; i < queues.size(); i++)
+  {
+    Queue &victim = queues[(self + i) % queues.size()];
+    lock_guard< mutex > lock(victim.mutex);
+    if (not victim.tasks.empty())
+    {
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void Scheduler::report()
+{
+  lock_guard< mutex > schedulers_lock(schedulers_mutex());
+  for (Scheduler *s: schedulers)
+  {
+    lock_guard< mutex > lock(s->_mutex);
+    if (s->_nruns == 0)
+    {
+      continue;
+    }
+
+    double busy = 0.0;
+    for (ThreadStats &t: s->_stats)
+    {
+      busy += t.busy;
+    }
+    double capacity = s->_wall * s->_stats.size();
+
+    cout << s->_name
+         << ": wall="
+         << s->_wall
+         << ", utilization="
+         << (capacity > 0.0 ? busy / capacity : 1.0)
+         << endl;
+
+    for (size_t i = 0; i < s->_stats.size(); i++)
+    {
+      ThreadStats &t = s->_stats[i];
+      cout << "  thread "
+           << i
+           << ": tasks="
+           << t.ntasks
+           << ", stolen="
+           << t.nstolen
+           << ", busy="
+           << t.busy
+           << ", utilization="
+           << (s->_wall > 0.0 ? t.busy / s->_wall : 1.0)
+           << endl;
+    }
+  }
+}
@@ -0,0 +1,205 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: TODO: <Add brief description about file purpose>
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_UTIL_SCHEDULER_H_
+#define CPP_NEAT_ACCNEAT_SRC_UTIL_SCHEDULER_H_
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "profiler.h"
+
+namespace NEAT
+{
+  ///
+  /// CLASS Scheduler
+  ///
+  /// Cost-aware work-stealing loop over the OpenMP thread team.
+  /// Tasks are sorted by estimated cost and dealt largest first to the
+  /// least loaded thread's deque. Each thread works through its own deque
+  /// from the front (largest first) and, once empty, steals from the back of
+  /// the other deques. This keeps the tail of a generation short when
+  /// genome sizes, and therefore task costs, differ by orders of magnitude.
+  ///
+  /// Like Timer, schedulers are meant to be function-level statics; all of
+  /// them can be printed with Scheduler::report(). Independent populations
+  /// may run() the same scheduler from several threads at once.
+  ///
+  class Scheduler
+  {
+    static std::vector< Scheduler * > schedulers;
+
+    struct Queue
+    {
+      std::mutex mutex;
+      std::deque< size_t > tasks;
+    };
+
+    public:
+    /// \brief Statistics of one thread during the most recent run()
+    struct ThreadStats
+    {
+      size_t ntasks;
+      size_t nstolen;
+      double busy;
+    };
+
+    Scheduler(const char *name);
+
+    ~Scheduler();
+
+    /// \brief Calls func(i) for every i in [0, n), in parallel.
+    /// cost(i) estimates the work of task i; only the ordering matters.
+    template < typename CostFunc, typename Func >
+    void run(
+            size_t n,
+            CostFunc cost,
+            Func func);
+
+    /// \brief Per-thread statistics of the most recent run()
+    std::vector< ThreadStats > get_stats() const
+    {
+      std::lock_guard< std::mutex > lock(_mutex);
+      return _stats;
+    }
+
+    /// \brief Prints the per-thread utilization of every scheduler
+    static void report();
+
+    /// \brief Number of threads a run() is spread over
+    static size_t nthreads();
+
+    /// \brief Sets the number of threads for parallel regions started by
+    /// the calling thread, including every run()
+    static void set_nthreads(size_t n);
+
+    private:
+
+    static size_t thread_num();
+
+    static double seconds();
+
+    bool steal(
+            std::vector< Queue > &queues,
+            size_t self,
+            size_t &task);
+
+    const char *_name;
+
+    /// \brief Guards the statistics below
+    mutable std::mutex _mutex;
+
+    std::vector< ThreadStats > _stats;
+
+    double _wall = 0.0;
+
+    size_t _nruns = 0;
+  };
+
+  template < typename CostFunc, typename Func >
+  void Scheduler::run(
+          size_t n,
+          CostFunc cost,
+          Func func)
+  {
+    const size_t nthr = nthreads();
+
+    std::vector< double > costs(n);
+    std::vector< size_t > order(n);
+    for (size_t i = 0; i < n; i++)
+    {
+      costs[i] = cost(i);
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(),
+                     order.end(),
+                     [&costs](size_t a, size_t b)
+                     {
+                       return costs[a] > costs[b];
+                     });
+
+    // Deal largest first to whichever thread has the least work so far.
+    std::vector< Queue > queues(nthr);
+    std::vector< double > load(nthr, 0.0);
+    for (size_t task: order)
+    {
+      size_t t = std::min_element(load.begin(), load.end()) - load.begin();
+      queues[t].tasks.push_back(task);
+      load[t] += costs[task];
+    }
+
+    std::vector< ThreadStats > run_stats(nthr, ThreadStats{0, 0, 0.0});
+    double start = seconds();
+
+#pragma omp parallel num_threads(nthr)
+    {
+      ProfileScope scope(_name);
+      size_t self = thread_num();
+      Queue &own = queues[self];
+      ThreadStats &stats = run_stats[self];
+
+      for (;;)
+      {
+        size_t task;
+        bool found = false;
+        {
+          std::lock_guard< std::mutex > lock(own.mutex);
+          if (not own.tasks.empty())
+          {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            found = true;
+          }
+        }
+        if (not found)
+        {
+          if (not steal(queues, self, task))
+          {
+            break;
+          }
+          stats.nstolen++;
+        }
+
+        double t = seconds();
+        func(task);
+        stats.busy += seconds() - t;
+        stats.ntasks++;
+      }
+    }
+
+    double wall = seconds() - start;
+
+    std::lock_guard< std::mutex > lock(_mutex);
+    _stats.swap(run_stats);
+    _wall = wall;
+    _nruns++;
+  }
+}
+
+#endif
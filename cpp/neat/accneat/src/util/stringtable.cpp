@@ -0,0 +1,126 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Append-only table of interned strings
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <assert.h>
+
+#include "stringtable.h"
+
+using namespace NEAT;
+using namespace std;
+
+constexpr StringTable::id_t StringTable::EMPTY;
+
+StringTable::StringTable()
+        : _size(1)
+{
+  for (atomic< string * > &block: _blocks)
+  {
+    block.store(nullptr, memory_order_relaxed);
+  }
+  // EMPTY is the first string of the first block.
+  _blocks[0].store(new string[FIRST_BLOCK_SIZE], memory_order_relaxed);
+  _ids.emplace(string(), EMPTY);
+}
+
+StringTable::~StringTable()
+{
+  for (atomic< string * > &block: _blocks)
+  {
+    delete[] block.load(memory_order_relaxed);
+  }
+}
+
+void StringTable::locate(
+        size_t id,
+        size_t &block,
+        size_t &offset)
+{
+  // Blocks 0 .. b - 1 hold FIRST_BLOCK_SIZE * (2^b - 1) strings.
+  size_t n = id / FIRST_BLOCK_SIZE + 1;
+  block = 63 - __builtin_clzll(n);
+  offset = id - FIRST_BLOCK_SIZE * ((size_t(1) << block) - 1);
+}
+
+StringTable::id_t StringTable::intern(const string &str)
+{
+  if (str.empty())
+  {
+    return EMPTY;
+  }
+
+  // Genes are created from the same robot name over and over, so remember
+  // the last string per thread and skip the lock for it.
+  static thread_local const StringTable *last_table = nullptr;
+  static thread_local string last_str;
+  static thread_local id_t last_id = -1;
+  if ((last_table == this) and (last_str == str))
+  {
+    return last_id;
+  }
+
+  id_t id;
+  {
+    lock_guard< mutex > lock(_mutex);
+    auto it = _ids.find(str);
+    if (it == _ids.end())
+    {
+      size_t size = _size.load(memory_order_relaxed);
+      size_t block, offset;
+      locate(size, block, offset);
+      string *strings = _blocks[block].load(memory_order_relaxed);
+      if (strings == nullptr)
+      {
+        strings = new string[FIRST_BLOCK_SIZE << block];
+        _blocks[block].store(strings, memory_order_release);
+      }
+      strings[offset] = str;
+      id = size;
+      _ids.emplace(str, id);
+      _size.store(size + 1, memory_order_release);
+    }
+    else
+    {
+      id = it->second;
+    }
+  }
+
+  last_table = this;
+  last_str = str;
+  last_id = id;
+  return id;
+}
+
+const string &StringTable::lookup(id_t id) const
+{
+  assert((id >= 0) and (size_t(id) < size()));
+  size_t block, offset;
+  locate(id, block, offset);
+  return _blocks[block].load(memory_order_acquire)[offset];
+}
+
+size_t StringTable::size() const
+{
+  return _size.load(memory_order_acquire);
+}
+
+StringTable &StringTable::creators()
+{
+  static StringTable table;
+  return table;
+}
@@ -0,0 +1,97 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Append-only table of interned strings
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef CPP_NEAT_ACCNEAT_SRC_UTIL_STRINGTABLE_H_
+#define CPP_NEAT_ACCNEAT_SRC_UTIL_STRINGTABLE_H_
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace NEAT
+{
+  ///
+  /// CLASS StringTable
+  ///
+  /// Maps strings to small integer ids and back. Entries are never removed,
+  /// so an id stays valid, and a looked up string stays at the same address,
+  /// for the lifetime of the table. Every table starts with the empty string
+  /// as EMPTY. Safe to use from several threads; only intern() locks, so
+  /// lookups can run in parallel loops.
+  ///
+  class StringTable
+  {
+    public:
+    typedef int32_t id_t;
+
+    /// \brief Id of the empty string
+    static constexpr id_t EMPTY = 0;
+
+    StringTable();
+
+    ~StringTable();
+
+    StringTable(const StringTable &) = delete;
+
+    StringTable &operator=(const StringTable &) = delete;
+
+    /// \brief Returns the id of str, adding it to the table if needed
+    id_t intern(const std::string &str);
+
+    /// \brief Returns the string of an id obtained from intern()
+    const std::string &lookup(id_t id) const;
+
+    /// \brief Number of strings; ids are 0 .. size() - 1
+    size_t size() const;
+
+    /// \brief Names of the robots that created genes
+    static StringTable &creators();
+
+    private:
+    /// \brief Block b holds FIRST_BLOCK_SIZE << b strings. Blocks are never
+    /// moved, so lookup() needs no lock, and NUM_BLOCKS of them hold more
+    /// strings than id_t can number.
+    static const size_t FIRST_BLOCK_SIZE = 64;
+
+    static const size_t NUM_BLOCKS = 32;
+
+    /// \brief Block and position in the block of the string with id
+    static void locate(
+            size_t id,
+            size_t &block,
+            size_t &offset);
+
+    /// \brief Serializes intern()
+    std::mutex _mutex;
+
+    std::atomic< std::string * > _blocks[NUM_BLOCKS];
+
+    /// \brief Published after the string with id _size - 1 is stored
+    std::atomic< size_t > _size;
+
+    std::unordered_map< std::string, id_t > _ids;
+  };
+}
+
+#endif
@@ -19,11 +19,14 @@
 
 #include <algorithm>
 #include <assert.h>
-#include <sys/time.h>
+#include <chrono>
+#include <cstring>
+#include <mutex>
 #include <vector>
 
 // Must be included first. Precompiled header with standard library includes.
 #include "std.h"
+#include "profiler.h"
 #include "timer.h"
 
 using namespace NEAT;
@@ -31,40 +34,70 @@ using namespace std;
 
 vector<Timer *> Timer::timers;
 
-static double seconds()
+// Function-level static timers may be constructed by several threads.
+static mutex &timers_mutex()
 {
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
+  static mutex m;
+  return m;
+}
+
+namespace
+{
+  /// \brief A start() that is waiting for its stop()
+  struct Running
+  {
+    const Timer *timer;
+    double start;
+    bool profiled;
+  };
+
+  /// \brief Timers started on this thread, innermost last
+  thread_local vector< Running > running;
+}
 
-  return static_cast<double>(tv.tv_sec + tv.tv_usec / 1000000.0);
+double Timer::now()
+{
+  return chrono::duration< double >(
+          chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 Timer::Timer(const char *name)
         : _name(name)
 {
+  lock_guard< mutex > lock(timers_mutex());
   timers.push_back(this);
 }
 
 Timer::~Timer()
 {
+  lock_guard< mutex > lock(timers_mutex());
   timers.erase(find(timers.begin(), timers.end(), this));
 }
 
 void Timer::start()
 {
-  assert(_start == 0.0);
-
-  _start = seconds();
+  bool profiled = Profiler::is_enabled();
+  if (profiled)
+  {
+    Profiler::begin(_name);
+  }
+  running.push_back(Running{this, now(), profiled});
 }
 
 void Timer::stop()
 {
-  assert(_start not_eq 0.0);
+  assert(not running.empty() and running.back().timer == this);
 
-  double t = seconds() - _start;
-  _recent = t;
-  _start = 0.0;
+  Running r = running.back();
+  running.pop_back();
+  double t = now() - r.start;
+  if (r.profiled)
+  {
+    Profiler::end();
+  }
 
+  lock_guard< mutex > lock(timers_mutex());
+  _recent = t;
   if (_n == 0)
   {
     _min = _max = t;
@@ -80,6 +113,7 @@ void Timer::stop()
 
 void Timer::report()
 {
+  lock_guard< mutex > lock(timers_mutex());
   for (Timer *t: timers)
   {
     cout << t->_name
@@ -98,3 +132,17 @@ void Timer::report()
          << endl;
   }
 }
+
+double Timer::get_total(const char *name)
+{
+  lock_guard< mutex > lock(timers_mutex());
+  double total = 0.0;
+  for (Timer *t: timers)
+  {
+    if (strcmp(t->_name, name) == 0)
+    {
+      total += t->_total;
+    }
+  }
+  return total;
+}
@@ -26,6 +26,15 @@
 
 namespace NEAT
 {
+  ///
+  /// CLASS Timer
+  ///
+  /// Named statistics over repeated timings, meant to be a function-level
+  /// static around serial code. While the Profiler is enabled, every
+  /// start()/stop() pair is also recorded as a span of the same name.
+  /// start() and stop() must pair up on the calling thread, so independent
+  /// populations on several threads can share a timer.
+  ///
   class Timer
   {
     static std::vector<Timer *> timers;
@@ -40,8 +49,6 @@ namespace NEAT
 
     double _max = 0.0;
 
-    double _start = 0.0;
-
     double _recent = 0.0;
 
     public:
@@ -54,6 +61,12 @@ namespace NEAT
     void stop();
 
     static void report();
+
+    /// \brief Seconds recorded so far by all timers called name
+    static double get_total(const char *name);
+
+    /// \brief Monotonic time in seconds, shared with the Profiler
+    static double now();
   };
 }
 
@@ -0,0 +1,71 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Shared driver of the thread scaling tests
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVE_NEAT_TEST_THREADSCALING_H_
+#define REVOLVE_NEAT_TEST_THREADSCALING_H_
+
+#include <cstddef>
+#include <iostream>
+
+/// \brief Runs the same seeded evolution on 1, 2 and 4 threads, reports how
+/// it scales and checks that its result doesn't depend on the threads.
+/// More threads than cores are used too, so the parallel paths are
+/// exercised on any machine.
+/// \param run Called as run(nthreads, seconds, result). Sets seconds to the
+/// time spent in the parallel part and result to something that doesn't
+/// depend on addresses. Returns false if the run failed.
+/// \param generations Number of generations timed by one run
+template < typename Result, typename Run >
+bool testThreadScaling(
+        Run run,
+        size_t generations)
+{
+  double serial_seconds;
+  Result serial;
+  if (not run(1, serial_seconds, serial))
+  {
+    return false;
+  }
+  std::cout << "1 thread: " << serial_seconds / generations
+            << " s per generation" << std::endl;
+
+  for (size_t nthreads: {2, 4})
+  {
+    double seconds;
+    Result parallel;
+    if (not run(nthreads, seconds, parallel))
+    {
+      return false;
+    }
+    std::cout << nthreads << " threads: " << seconds / generations
+              << " s per generation (speedup " << serial_seconds / seconds
+              << ")" << std::endl;
+
+    if (not (parallel == serial))
+    {
+      std::cout << "The result on " << nthreads << " threads differs from "
+                << "the one on 1 thread" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#endif  //  REVOLVE_NEAT_TEST_THREADSCALING_H_
@@ -17,11 +17,19 @@
 *
 */
 
+#include <atomic>
+#include <cmath>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "neat/AsyncNEAT.h"
+#include "innovgenome/innovgenome.h"
 #include "network/cpu/cpunetwork.h"
 
 #include "test_AsyncNEAT.h"
@@ -43,6 +51,46 @@ bool TestAsyncNeat::test()
     return false;
   }
 
+  if (not testConcurrentEvaluations(false))
+  {
+    return false;
+  }
+
+  if (not testSteadyStateXOR())
+  {
+    return false;
+  }
+
+  if (not testConcurrentEvaluations(true))
+  {
+    return false;
+  }
+
+  if (not testIndependentSearches())
+  {
+    return false;
+  }
+
+  if (not testFitnessCache(false))
+  {
+    return false;
+  }
+
+  if (not testFitnessCache(true))
+  {
+    return false;
+  }
+
+  if (not testLateFinish(false))
+  {
+    return false;
+  }
+
+  if (not testLateFinish(true))
+  {
+    return false;
+  }
+
   return true;
 }
 
@@ -106,6 +154,331 @@ bool TestAsyncNeat::testXOR()
   return success;
 }
 
+bool TestAsyncNeat::testSteadyStateXOR()
+{
+  AsyncNeat::Init(test_name);
+  AsyncNeat::SetSearchType(NEAT::GeneticSearchType::BLENDED);
+  AsyncNeat::SetPopulationSize(50);
+  AsyncNeat::SetSteadyState(true);
+  AsyncNeat neat(2, 1, 1, test_name);
+  AsyncNeat::SetSteadyState(false);
+  float success_margin_error = 0.0001;
+
+  bool success = false;
+  float min_error = std::numeric_limits<float>().max();
+  std::vector<float> inputs0 = {0, 0, 1, 1};
+  std::vector<float> inputs1 = {0, 1, 0, 1};
+  std::vector<float> expectedOutputs = {0, 1, 1, 0};
+
+  int evaluation;
+  for (evaluation = 1; evaluation < MAX_EVALUATIONS; evaluation++)
+  {
+    // Evaluations are finished one at a time, so there always is a new one.
+    std::shared_ptr<NeatEvaluation> eval = neat.Evaluation();
+    if (not eval)
+    {
+      std::cout << "No evaluation available in steady-state mode" << std::endl;
+      break;
+    }
+    const NEAT::Organism *organism = eval->Organism();
+    NEAT::CpuNetwork *net = reinterpret_cast< NEAT::CpuNetwork *> (
+            organism->net.get());
+
+    float error = 0;
+    for (size_t test = 0; test < inputs0.size(); test++)
+    {
+      net->load_sensor(0, inputs0[test]);
+      net->load_sensor(1, inputs1[test]);
+
+      net->activate(1);
+      NEAT::real_t *outputs = net->Outputs();
+      error += std::abs(outputs[0] - expectedOutputs[test]);
+    }
+
+    if (min_error > error)
+    {
+      min_error = error;
+    }
+
+    eval->finish(1 / error);
+
+    if (min_error < success_margin_error)
+    {
+      std::cout << "\nAfter "<< evaluation
+                << " steady-state evaluations, a successful organism was "
+                << "found with an error of " << min_error << std::endl;
+      success = true;
+      break;
+    }
+  }
+
+  neat.CleanUp();
+  return success;
+}
+
+bool TestAsyncNeat::testConcurrentEvaluations(bool steady_state)
+{
+  const size_t population_size = 20;
+  const size_t n_generations = 25;
+  const size_t n_threads = 8;
+  const size_t n_evaluations = population_size * n_generations;
+
+  AsyncNeat::Init(test_name);
+  AsyncNeat::SetPopulationSize(population_size);
+  AsyncNeat::SetSteadyState(steady_state);
+  AsyncNeat neat(2, 1, 1, test_name);
+  AsyncNeat::SetSteadyState(false);
+
+  std::atomic< size_t > reserved(0);
+  std::mutex evaluations_mutex;
+  std::vector< std::shared_ptr< NeatEvaluation > > evaluations;
+
+  std::vector< std::thread > workers;
+  for (size_t t = 0; t < n_threads; t++)
+  {
+    workers.emplace_back(
+            [&]()
+            {
+              while (reserved.fetch_add(1) < n_evaluations)
+              {
+                std::shared_ptr< NeatEvaluation > eval;
+                while (not(eval = neat.Evaluation()))
+                {
+                  std::this_thread::yield();
+                }
+
+                {
+                  std::lock_guard< std::mutex > lock(evaluations_mutex);
+                  evaluations.push_back(eval);
+                }
+                eval->finish(1 + eval->Organism()->population_index % 7);
+              }
+            });
+  }
+  for (std::thread &worker: workers)
+  {
+    worker.join();
+  }
+
+  neat.CleanUp();
+
+  // The evaluations are all kept alive, so their addresses are unique.
+  std::set< NeatEvaluation * > unique;
+  for (const std::shared_ptr< NeatEvaluation > &eval: evaluations)
+  {
+    unique.insert(eval.get());
+  }
+
+  std::cout << (steady_state ? "steady-state: " : "generational: ")
+            << n_threads << " threads finished " << evaluations.size()
+            << " evaluations, " << unique.size() << " distinct" << std::endl;
+  return (evaluations.size() == n_evaluations)
+         and (unique.size() == n_evaluations);
+}
+
+double TestAsyncNeat::runXOR(
+        AsyncNeat &neat,
+        int n_evaluations)
+{
+  std::vector<float> inputs0 = {0, 0, 1, 1};
+  std::vector<float> inputs1 = {0, 1, 0, 1};
+  std::vector<float> expectedOutputs = {0, 1, 1, 0};
+
+  double total_error = 0;
+  for (int i = 0; i < n_evaluations; i++)
+  {
+    std::shared_ptr<NeatEvaluation> eval = neat.Evaluation();
+    NEAT::CpuNetwork *net = reinterpret_cast< NEAT::CpuNetwork *> (
+            eval->Organism()->net.get());
+
+    float error = 0;
+    for (size_t test = 0; test < inputs0.size(); test++)
+    {
+      net->load_sensor(0, inputs0[test]);
+      net->load_sensor(1, inputs1[test]);
+
+      net->activate(1);
+      error += std::abs(net->Outputs()[0] - expectedOutputs[test]);
+    }
+    total_error += error;
+
+    eval->finish(4 - error);
+  }
+  return total_error;
+}
+
+bool TestAsyncNeat::testIndependentSearches()
+{
+  const int n_evaluations = 400;
+
+  std::unique_ptr< NEAT::NeatEnv > settings_a = AsyncNeat::DefaultSettings();
+  settings_a->pop_size = 10;
+  settings_a->search_type = NEAT::GeneticSearchType::BLENDED;
+
+  std::unique_ptr< NEAT::NeatEnv > settings_b = AsyncNeat::DefaultSettings();
+  settings_b->pop_size = 20;
+  settings_b->mutate_add_node_prob = 0.1;
+
+  double alone;
+  {
+    AsyncNeat neat_a(2, 1, 1, test_name,
+                     std::unique_ptr< NEAT::NeatEnv >(
+                             new NEAT::NeatEnv(*settings_a)));
+    alone = runXOR(neat_a, n_evaluations);
+  }
+
+  double together_a = 0;
+  double together_b = 0;
+  {
+    AsyncNeat neat_a(2, 1, 1, test_name, std::move(settings_a));
+    AsyncNeat neat_b(2, 1, 2, test_name, std::move(settings_b));
+
+    std::thread thread_a([&]()
+                         {
+                           together_a = runXOR(neat_a, n_evaluations);
+                         });
+    std::thread thread_b([&]()
+                         {
+                           together_b = runXOR(neat_b, n_evaluations);
+                         });
+    thread_a.join();
+    thread_b.join();
+  }
+
+  std::cout << "independent searches: error " << alone << " alone, "
+            << together_a << " next to another search (" << together_b
+            << ")" << std::endl;
+  return alone == together_a;
+}
+
+bool TestAsyncNeat::testFitnessCache(bool steady_state)
+{
+  const int n_evaluations = 600;
+
+  // The fitness has to depend on the genome only, which the network state
+  // left over from other organisms doesn't.
+  auto weight_fitness = [](const NeatEvaluation &eval)
+  {
+    const NEAT::InnovGenome *genome = dynamic_cast< NEAT::InnovGenome * >(
+            eval.Organism()->genome.get());
+    float fitness = 100;
+    for (const NEAT::InnovLinkGene &link: genome->links)
+    {
+      if (link.enable)
+      {
+        fitness -= std::abs(link.weight() - 0.5f);
+      }
+    }
+    return fitness;
+  };
+
+  std::unique_ptr< NEAT::NeatEnv > settings = AsyncNeat::DefaultSettings();
+  settings->pop_size = 20;
+  std::unique_ptr< NEAT::NeatEnv > cached_settings(
+          new NEAT::NeatEnv(*settings));
+  cached_settings->fitness_cache_size = 100;
+
+  std::unique_ptr< NEAT::NeatEnv > unquantized_settings(
+          new NEAT::NeatEnv(*cached_settings));
+  unquantized_settings->fitness_cache_weight_quantum = 0;
+  try
+  {
+    AsyncNeat unquantized(2, 1, 1, test_name,
+                          std::move(unquantized_settings));
+    std::cout << "a fitness cache with a weight quantum of 0 was accepted"
+              << std::endl;
+    return false;
+  }
+  catch (const std::invalid_argument &)
+  {
+  }
+
+  AsyncNeat::SetSteadyState(steady_state);
+  AsyncNeat neat(2, 1, 1, test_name, std::move(settings));
+  AsyncNeat cached(2, 1, 1, test_name, std::move(cached_settings));
+  AsyncNeat::SetSteadyState(false);
+
+  for (int i = 0; i < n_evaluations; i++)
+  {
+    std::shared_ptr< NeatEvaluation > eval = neat.Evaluation();
+    eval->finish(weight_fitness(*eval));
+  }
+
+  int handed_out = 0;
+  while (handed_out + cached.CachedEvaluations() < size_t(n_evaluations))
+  {
+    std::shared_ptr< NeatEvaluation > eval = cached.Evaluation();
+    eval->finish(weight_fitness(*eval));
+    handed_out++;
+  }
+
+  float fittest = weight_fitness(*neat.Fittest());
+  float cached_fittest = weight_fitness(*cached.Fittest());
+  std::cout << (steady_state ? "steady-state" : "generational")
+            << " fitness cache: " << cached.CachedEvaluations() << " of "
+            << n_evaluations << " evaluations reused, best fitness "
+            << fittest << " without cache, " << cached_fittest << " with it"
+            << std::endl;
+  return (cached.CachedEvaluations() > 0) and (fittest == cached_fittest);
+}
+
+bool TestAsyncNeat::testLateFinish(bool steady_state)
+{
+  const size_t population_size = 20;
+  const float fitness = 1;
+  const float late_fitness = 1000;
+
+  std::unique_ptr< NEAT::NeatEnv > settings = AsyncNeat::DefaultSettings();
+  settings->pop_size = population_size;
+  AsyncNeat::SetSteadyState(steady_state);
+  AsyncNeat neat(2, 1, 1, test_name, std::move(settings));
+  AsyncNeat::SetSteadyState(false);
+
+  // All of the first generation, so that in steady-state mode the worst of
+  // them are replaced while the evaluations are still around.
+  std::vector< std::shared_ptr< NeatEvaluation > > evaluations;
+  for (size_t i = 0; i < population_size; i++)
+  {
+    evaluations.push_back(neat.Evaluation());
+  }
+
+  // Finishes the first evaluation twice before the generation is over
+  evaluations[0]->finish(fitness);
+  evaluations[0]->finish(late_fitness);
+  bool passed = evaluations[0]->Organism()->eval.fitness == fitness;
+
+  if (steady_state)
+  {
+    for (size_t i = 1; i < population_size; i++)
+    {
+      evaluations[i]->finish(fitness);
+    }
+
+    // Half of them are offspring by now, waiting in the queue
+    size_t replaced = 0;
+    for (const std::shared_ptr< NeatEvaluation > &eval: evaluations)
+    {
+      eval->finish(late_fitness);
+      replaced += eval->Organism()->eval.fitness not_eq fitness;
+      passed = passed and eval->Organism()->eval.fitness not_eq late_fitness;
+    }
+    std::cout << "steady-state late finish: " << replaced << " of "
+              << population_size << " organisms replaced" << std::endl;
+    passed = passed and replaced > 0;
+  }
+  else
+  {
+    std::cout << "generational late finish: fitness "
+              << evaluations[0]->Organism()->eval.fitness << std::endl;
+    for (size_t i = 1; i < population_size; i++)
+    {
+      evaluations[i]->finish(fitness);
+    }
+  }
+
+  return passed;
+}
+
 int main()
 {
   TestAsyncNeat t;
@@ -41,6 +41,43 @@ class TestAsyncNeat
    */
   bool testXOR();
 
+  /**
+   * test if many threads can take and finish evaluations at the same time,
+   * each evaluation being handed out exactly once
+   */
+  bool testConcurrentEvaluations(bool steady_state);
+
+  /**
+   * test if steady-state replacement is able to resolve the XOR problem
+   */
+  bool testSteadyStateXOR();
+
+  /**
+   * test if searches with their own settings evolve independently, also when
+   * they run in parallel
+   */
+  bool testIndependentSearches();
+
+  /**
+   * test if a search that reuses the fitness of known genomes ends up where
+   * the same search evaluating every organism does, with fewer evaluations,
+   * and if a cache without a positive weight quantum is rejected
+   */
+  bool testFitnessCache(bool steady_state);
+
+  /**
+   * test if finishing an evaluation a second time, or after its organism was
+   * replaced, leaves the fitness of the organism alone
+   */
+  bool testLateFinish(bool steady_state);
+
+  /**
+   * evaluates XOR for n_evaluations and returns the sum of the errors
+   */
+  double runXOR(
+          class AsyncNeat &neat,
+          int n_evaluations);
+
   const int MAX_EVALUATIONS = 9999;
 };
 
@@ -0,0 +1,190 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Agreement of the dot-product kernels of CpuNetwork
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "neat.h"
+#include "util/rng.h"
+
+#include "test_CpuNetworkKernel.h"
+
+bool TestCpuNetworkKernel::test()
+{
+  // ACCNEAT_NO_SIMD is read on the first activation, so testNoSimd() has to
+  // come first.
+  if (not testNoSimd())
+  {
+    return false;
+  }
+
+  if (not testSimd())
+  {
+    return false;
+  }
+
+  return true;
+}
+
+TestCpuNetworkKernel::Network TestCpuNetworkKernel::network(
+        int seed,
+        size_t max_row_length)
+{
+  NEAT::rng_t rng(seed);
+
+  Network net;
+  net.dims.nnodes.bias = 1;
+  net.dims.nnodes.sensor = 8;
+  net.dims.nnodes.output = 4;
+  net.dims.nnodes.hidden = 36;
+  net.dims.nnodes.input = net.dims.nnodes.bias + net.dims.nnodes.sensor;
+  net.dims.nnodes.noninput = net.dims.nnodes.output + net.dims.nnodes.hidden;
+  net.dims.nnodes.all = net.dims.nnodes.input + net.dims.nnodes.noninput;
+
+  uint32_t nlinks_padded = 0;
+  size_t nlinks = 0;
+  for (size_t i = 0; i < net.dims.nnodes.noninput; i++)
+  {
+    size_t n = rng.integer(1, max_row_length);
+    net.row_start.push_back(nlinks_padded);
+    for (size_t j = 0; j < n; j++)
+    {
+      net.weights.push_back(rng.prob() * 4 - 2);
+      net.in_index.push_back(rng.integer(0, net.dims.nnodes.all - 1));
+    }
+    nlinks += n;
+    // padding entries read the bias with weight 0
+    for (; n % NEAT::CPU_LINK_ROW_PAD; n++)
+    {
+      net.weights.push_back(0.0);
+      net.in_index.push_back(0);
+    }
+    nlinks_padded += n;
+  }
+  net.row_start.push_back(nlinks_padded);
+  net.dims.nlinks = nlinks;
+
+  net.act.assign(net.dims.nnodes.all, 0.0);
+  net.act[0] = 1.0;
+  for (size_t i = net.dims.nnodes.bias; i < net.dims.nnodes.input; i++)
+  {
+    net.act[i] = rng.prob();
+  }
+  return net;
+}
+
+std::vector< NEAT::real_t > TestCpuNetworkKernel::activate(
+        const NEAT::CpuKernel &kernel,
+        const Network &net,
+        size_t ncycles)
+{
+  const size_t input = net.dims.nnodes.input;
+  std::vector< NEAT::real_t > act = net.act;
+  std::vector< NEAT::real_t > act_new = net.act;
+  for (size_t icycle = 0; icycle < ncycles; icycle++)
+  {
+    kernel.sums(net.dims.nnodes.noninput,
+                net.row_start.data(),
+                net.weights.data(),
+                net.in_index.data(),
+                act.data(),
+                act_new.data() + input);
+    for (size_t i = input; i < net.dims.nnodes.all; i++)
+    {
+      act_new[i] = NEAT::fsigmoid(act_new[i], 4.924273);
+    }
+    std::swap(act, act_new);
+  }
+  return act;
+}
+
+bool TestCpuNetworkKernel::testSimd()
+{
+  const NEAT::CpuKernel &simd = NEAT::CpuKernel::simd();
+  std::cout << "vector kernel of this host: " << simd.name << std::endl;
+
+  for (size_t max_row_length : {4, 8, 13, 64, 200})
+  {
+    for (int seed = 1; seed <= 10; seed++)
+    {
+      Network net = network(seed, max_row_length);
+      std::vector< NEAT::real_t > expected =
+              activate(NEAT::CpuKernel::scalar(), net, CYCLES);
+      std::vector< NEAT::real_t > actual = activate(simd, net, CYCLES);
+      for (size_t i = 0; i < expected.size(); i++)
+      {
+        // the vector kernels add in another order and fuse multiply-adds
+        if (std::abs(actual[i] - expected[i]) > 1e-4)
+        {
+          std::cout << simd.name << " activation " << i << " of a network "
+                    << "with rows up to " << max_row_length << " links is "
+                    << actual[i] << " instead of " << expected[i]
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+bool TestCpuNetworkKernel::testNoSimd()
+{
+  setenv("ACCNEAT_NO_SIMD", "1", 1);
+
+  const size_t row_length = 4 * NEAT::CPU_SIMD_MIN_ROW_LENGTH;
+  if (&NEAT::CpuKernel::get(row_length) not_eq &NEAT::CpuKernel::scalar())
+  {
+    std::cout << "ACCNEAT_NO_SIMD didn't select the scalar kernel"
+              << std::endl;
+    return false;
+  }
+
+  Network net = network(1, row_length);
+  std::vector< NEAT::real_t > expected =
+          activate(NEAT::CpuKernel::scalar(), net, CYCLES);
+  std::vector< NEAT::real_t > act = net.act;
+  std::vector< NEAT::real_t > act_other(act.size());
+  NEAT::cpu_activate(net.dims,
+                     net.row_start.data(),
+                     net.weights.data(),
+                     net.in_index.data(),
+                     act.data(),
+                     act_other.data(),
+                     CYCLES);
+  if (act not_eq expected)
+  {
+    std::cout << "cpu_activate() with ACCNEAT_NO_SIMD differs from the "
+              << "scalar kernel" << std::endl;
+    return false;
+  }
+
+  unsetenv("ACCNEAT_NO_SIMD");
+  return true;
+}
+
+int main()
+{
+  TestCpuNetworkKernel t;
+  return t.test() ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Agreement of the dot-product kernels of CpuNetwork
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVE_NEAT_TEST_CPUNETWORKKERNEL_H_
+#define REVOLVE_NEAT_TEST_CPUNETWORKKERNEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "network/cpu/cpunetworkkernel.h"
+
+class TestCpuNetworkKernel
+{
+  public:
+  /// \brief Runs all tests. Returns false if one of the tests fails.
+  bool test();
+
+  private:
+  /// \brief A network in the padded layout of cpu_activate()
+  struct Network
+  {
+    NEAT::NetDims dims;
+    std::vector< uint32_t > row_start;
+    std::vector< NEAT::real_t > weights;
+    std::vector< int32_t > in_index;
+    std::vector< NEAT::real_t > act;
+  };
+
+  /// \brief A network whose rows are between 1 and max_row_length links
+  /// long, with random weights and input activations
+  Network network(
+          int seed,
+          size_t max_row_length);
+
+  /// \brief Activations of net after ncycles steps of cpu_activate(),
+  /// summing with kernel instead of the one cpu_activate() picks
+  std::vector< NEAT::real_t > activate(
+          const NEAT::CpuKernel &kernel,
+          const Network &net,
+          size_t ncycles);
+
+  /// \brief test if the vector kernel of the host (AVX2 or NEON) gives the
+  /// activations of the scalar kernel, for short and long rows
+  bool testSimd();
+
+  /// \brief test if ACCNEAT_NO_SIMD makes cpu_activate() use the scalar
+  /// kernel, also for rows long enough for the vector kernels
+  bool testNoSimd();
+
+  const size_t CYCLES = 3;
+};
+
+#endif  //  REVOLVE_NEAT_TEST_CPUNETWORKKERNEL_H_
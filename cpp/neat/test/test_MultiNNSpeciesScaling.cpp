@@ -0,0 +1,143 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Thread scaling of MultiNNSpeciesPopulation
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "genomemanager.h"
+#include "neat.h"
+#include "organism.h"
+#include "population.h"
+#include "network/cpu/cpunetwork.h"
+#include "util/rng.h"
+#include "util/scheduler.h"
+#include "util/timer.h"
+
+#include "ThreadScaling.h"
+#include "test_MultiNNSpeciesScaling.h"
+
+// Genomes keep a pointer to their robot name.
+const std::string test_name = "TestMultiNNSpeciesScaling";
+
+TestMultiNNSpeciesScaling::TestMultiNNSpeciesScaling()
+{
+}
+
+TestMultiNNSpeciesScaling::~TestMultiNNSpeciesScaling()
+{
+}
+
+bool TestMultiNNSpeciesScaling::test()
+{
+  if (not testScaling())
+  {
+    return false;
+  }
+
+  return true;
+}
+
+bool TestMultiNNSpeciesScaling::run(
+        size_t nthreads,
+        double &seconds,
+        double &checksum)
+{
+  NEAT::Scheduler::set_nthreads(nthreads);
+
+  NEAT::env->population_type = NEAT::PopulationType::MULTI_NN_SPECIES;
+  NEAT::env->pop_size = POPULATION_SIZE;
+  NEAT::env->genome_manager = NEAT::GenomeManager::create(test_name);
+
+  NEAT::rng_t rng(1);
+  std::vector< std::unique_ptr< NEAT::Genome > > seeds =
+          NEAT::env->genome_manager->create_seed_generation(
+                  POPULATION_SIZE, rng, 1, 2, 1, 2, test_name);
+  std::unique_ptr< NEAT::Population > population(
+          NEAT::Population::create(rng, seeds));
+
+  std::vector< float > inputs0 = {0, 0, 1, 1};
+  std::vector< float > inputs1 = {0, 1, 0, 1};
+  std::vector< float > expectedOutputs = {0, 1, 1, 0};
+
+  seconds = 0.0;
+  checksum = 0.0;
+  for (size_t gen = 1; gen <= GENERATIONS; gen++)
+  {
+    for (size_t i = 0; i < population->size(); i++)
+    {
+      NEAT::Organism *organism = population->get(i);
+      NEAT::CpuNetwork *net = reinterpret_cast< NEAT::CpuNetwork * >(
+              organism->net.get());
+
+      float error = 0;
+      for (size_t test = 0; test < inputs0.size(); test++)
+      {
+        net->clear_noninput();
+        net->load_sensor(0, inputs0[test]);
+        net->load_sensor(1, inputs1[test]);
+        net->activate(1);
+        error += std::abs(net->Outputs()[0] - expectedOutputs[test]);
+      }
+      organism->eval.error = error;
+      organism->eval.fitness = 4 - error;
+    }
+
+    if (gen == GENERATIONS)
+    {
+      break;
+    }
+
+    double start = NEAT::Timer::now();
+    population->next_generation();
+    seconds += NEAT::Timer::now() - start;
+  }
+
+  for (size_t i = 0; i < population->size(); i++)
+  {
+    NEAT::Organism *organism = population->get(i);
+    NEAT::Genome::Stats stats = organism->genome->get_stats();
+    checksum += (i + 1) * (organism->eval.fitness
+                           + stats.nnodes
+                           + 3 * stats.nlinks);
+  }
+
+  population.reset();
+  delete NEAT::env->genome_manager;
+  NEAT::env->genome_manager = nullptr;
+
+  return true;
+}
+
+bool TestMultiNNSpeciesScaling::testScaling()
+{
+  return testThreadScaling< double >(
+          [this](size_t nthreads, double &seconds, double &checksum)
+          {
+            return this->run(nthreads, seconds, checksum);
+          },
+          GENERATIONS - 1);
+}
+
+int main()
+{
+  TestMultiNNSpeciesScaling t;
+  return t.test() ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Thread scaling of MultiNNSpeciesPopulation
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVE_NEAT_TEST_MULTINNSPECIESSCALING_H_
+#define REVOLVE_NEAT_TEST_MULTINNSPECIESSCALING_H_
+
+#include <cstddef>
+
+class TestMultiNNSpeciesScaling
+{
+  public:
+  TestMultiNNSpeciesScaling();
+
+  ~TestMultiNNSpeciesScaling();
+
+  /// \brief Runs all tests. Returns false if one of the tests fails.
+  bool test();
+
+  private:
+  /// \brief Evolves a population for GENERATIONS generations on nthreads
+  /// threads, setting seconds to the time spent creating new generations
+  /// and checksum to a sum over the final population
+  bool run(
+          size_t nthreads,
+          double &seconds,
+          double &checksum);
+
+  /// \brief test if reproduction and speciation give the same population on
+  /// any number of threads, and report how they scale
+  bool testScaling();
+
+  const size_t POPULATION_SIZE = 500;
+
+  const size_t GENERATIONS = 30;
+};
+
+#endif  //  REVOLVE_NEAT_TEST_MULTINNSPECIESSCALING_H_
@@ -0,0 +1,515 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Batch ask/tell of NEATLearner, alone and driving a fleet
+* through ConverterSplitBrain
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+
+#include "brain/learner/cppneat/CPPNMutator.h"
+
+#include "test_LearnerBatch.h"
+
+// NEATLearner appends every evaluated genotype to <name>.policy, and
+// ConverterSplitBrain every fitness to <name>.log
+const std::string test_name = "/tmp/TestLearnerBatch";
+
+cppneat::GeneticEncodingPtr BatchController::getPhenotype()
+{
+  return this->phenotype;
+}
+
+void BatchController::setPhenotype(cppneat::GeneticEncodingPtr phenotype)
+{
+  this->phenotype = phenotype;
+  this->phenotypes++;
+}
+
+void BatchController::update(
+        const std::vector< revolve::brain::ActuatorPtr > &/*actuators*/,
+        const std::vector< revolve::brain::SensorPtr > &/*sensors*/,
+        double /*t*/,
+        double /*step*/)
+{
+}
+
+BatchEvaluator::BatchEvaluator(
+        boost::shared_ptr< BatchController > controller)
+        : controller(controller)
+{
+}
+
+void BatchEvaluator::start()
+{
+}
+
+double BatchEvaluator::fitness()
+{
+  this->evaluations++;
+  double weights = 0;
+  for (const auto &connection : this->controller->phenotype->connectionGenes_)
+  {
+    weights += connection.weight_;
+  }
+  return 1.0 / (1.0 + std::abs(weights - 1.0));
+}
+
+cppneat::GeneticEncodingPtr BatchConverter::convertForController(
+        cppneat::GeneticEncodingPtr genotype)
+{
+  this->conversions++;
+  return genotype;
+}
+
+cppneat::GeneticEncodingPtr BatchConverter::convertForLearner(
+        cppneat::GeneticEncodingPtr phenotype)
+{
+  this->learnerConversions++;
+  return phenotype;
+}
+
+boost::shared_ptr< BatchConverter::Converter > BatchConverter::Clone() const
+{
+  if (not this->cloneable)
+  {
+    return nullptr;
+  }
+  this->clones.push_back(boost::make_shared< BatchConverter >());
+  return this->clones.back();
+}
+
+BatchBrain::BatchBrain(
+        boost::shared_ptr< cppneat::NEATLearner > learner,
+        boost::shared_ptr< BatchController > controller,
+        revolve::brain::EvaluatorPtr evaluator,
+        boost::shared_ptr< BatchConverter > converter)
+        : revolve::brain::ConverterSplitBrain< cppneat::GeneticEncodingPtr,
+                                               cppneat::GeneticEncodingPtr >(
+        converter,
+        test_name)
+{
+  this->learner_ = learner;
+  this->controller_ = controller;
+  this->evaluator_ = evaluator;
+}
+
+bool TestLearnerBatch::test()
+{
+  std::remove((test_name + ".policy").c_str());
+  std::remove((test_name + ".log").c_str());
+  bool passed = testGenerations() and testCache() and testAlone()
+                and testFleet();
+  std::remove((test_name + ".policy").c_str());
+  std::remove((test_name + ".log").c_str());
+  return passed;
+}
+
+boost::shared_ptr< cppneat::NEATLearner > TestLearnerBatch::learner(
+        int _cacheSize,
+        double _weightQuantum)
+{
+  std::map< cppneat::Neuron::Ntype, cppneat::Neuron::NeuronTypeSpec > spec;
+  spec[cppneat::Neuron::INPUT].possibleLayers = {
+          cppneat::Neuron::INPUT_LAYER};
+  spec[cppneat::Neuron::SIGMOID].parameters = {
+          {"rv:bias", -1, 1, false, false, 1e-9},
+          {"rv:gain", 0, 1, false, false, 1e-9}};
+  spec[cppneat::Neuron::SIGMOID].possibleLayers = {
+          cppneat::Neuron::HIDDEN_LAYER,
+          cppneat::Neuron::OUTPUT_LAYER};
+
+  // 3 inputs connected to an output
+  cppneat::GeneticEncodingPtr start(new cppneat::GeneticEncoding(false));
+  for (size_t i = 1; i <= 3; i++)
+  {
+    start->AddNeuron(
+            cppneat::Neuron("Input-" + std::to_string(i),
+                            cppneat::Neuron::INPUT_LAYER,
+                            cppneat::Neuron::INPUT,
+                            {}),
+            cppneat::Gene(i));
+  }
+  start->AddNeuron(
+          cppneat::Neuron("Output-0",
+                          cppneat::Neuron::OUTPUT_LAYER,
+                          cppneat::Neuron::SIGMOID,
+                          {{"rv:bias", 0}, {"rv:gain", 0.5}}),
+          cppneat::Gene(4));
+  for (size_t i = 1; i <= 3; i++)
+  {
+    start->AddConnection(cppneat::ConnectionGene(4, i, 0, 4 + i));
+  }
+
+  cppneat::MutatorPtr mutator(new cppneat::Mutator(
+          spec, 1, 8, 100, std::vector< cppneat::Neuron::Ntype >()));
+
+  cppneat::NEATLearner::LearningConfiguration config;
+  config.asexual = false;
+  config.popSize = POPULATION_SIZE;
+  config.tournamentSize = cppneat::NEATLearner::TOURNAMENT_SIZE;
+  config.numChildren = POPULATION_SIZE / 2;
+  config.maxGenerations = 100;
+  config.repeat_evaluations = REPEAT_EVALUATIONS;
+  config.initialStructuralMutations = 1;
+  config.speciationThreshold = cppneat::NEATLearner::SPECIATION_TRESHOLD;
+  config.weightMutationProbability =
+          cppneat::NEATLearner::WEIGHT_MUTATION_PROBABILITY;
+  config.weightMutationSigma = cppneat::NEATLearner::WEIGHT_MUTATION_SIGMA;
+  config.paramMutationProbability =
+          cppneat::NEATLearner::PARAM_MUTATION_PROBABILITY;
+  config.paramMutationSigma = cppneat::NEATLearner::PARAM_MUTATION_SIGMA;
+  config.structuralAugmentationProbability =
+          cppneat::NEATLearner::STRUCTURAL_AUGMENTATION_PROBABILITY;
+  config.structuralRemovalProbability =
+          cppneat::NEATLearner::STRUCTURAL_REMOVAL_PROBABILITY;
+  config.interspeciesMateProbability =
+          cppneat::NEATLearner::INTERSPECIES_MATE_PROBABILITY;
+  config.fitnessCacheSize = _cacheSize;
+  config.fitnessCacheWeightQuantum = _weightQuantum;
+  config.rngSeed = 1;
+  config.startFrom = start;
+
+  return boost::make_shared< cppneat::NEATLearner >(mutator, "none", config);
+}
+
+bool TestLearnerBatch::check(cppneat::GeneticEncodingPtr _genotype)
+{
+  for (const auto &connection : _genotype->connectionGenes_)
+  {
+    if (not _genotype->ExistingNeuron(connection.from_)
+        or not _genotype->ExistingNeuron(connection.to_))
+    {
+      std::cout << "Connection " << connection.InnovationNumber()
+                << " joins a missing neuron" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestLearnerBatch::testGenerations()
+{
+  auto neat = this->learner();
+  revolve::brain::Learner< cppneat::GeneticEncodingPtr > &learner = *neat;
+
+  for (size_t gen = 0; gen < GENERATIONS; gen++)
+  {
+    std::map< cppneat::GeneticEncodingPtr, size_t > handedOut;
+    size_t evaluations = 0;
+    for (;;)
+    {
+      auto batch = learner.askBatch(FLEET_SIZE);
+      if (batch.size() > FLEET_SIZE)
+      {
+        std::cout << "Asked for " << FLEET_SIZE << " genotypes, got "
+                  << batch.size() << std::endl;
+        return false;
+      }
+
+      // told in reverse order, as robots may finish in any order
+      std::vector< revolve::brain::Ticket > tickets;
+      std::vector< double > fitnesses;
+      for (auto it = batch.rbegin(); it not_eq batch.rend(); ++it)
+      {
+        if (not check(it->second))
+        {
+          return false;
+        }
+        handedOut[it->second]++;
+        tickets.push_back(it->first);
+        fitnesses.push_back(1.0 / (1.0 + tickets.size()));
+      }
+      evaluations += batch.size();
+      learner.tellBatch(test_name, tickets, fitnesses);
+
+      if (batch.size() < FLEET_SIZE
+          or evaluations > POPULATION_SIZE * REPEAT_EVALUATIONS)
+      {
+        break;
+      }
+    }
+
+    if (evaluations not_eq POPULATION_SIZE * REPEAT_EVALUATIONS
+        or handedOut.size() not_eq POPULATION_SIZE)
+    {
+      std::cout << "Generation " << gen << " had " << evaluations
+                << " evaluations of " << handedOut.size() << " genotypes"
+                << std::endl;
+      return false;
+    }
+    for (const auto &genotype : handedOut)
+    {
+      if (genotype.second not_eq REPEAT_EVALUATIONS)
+      {
+        std::cout << "A genotype of generation " << gen << " was handed out "
+                  << genotype.second << " times" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  try
+  {
+    learner.tellBatch(test_name, {1000000}, {0.0});
+    std::cout << "Told an unknown ticket" << std::endl;
+    return false;
+  }
+  catch (const std::invalid_argument &)
+  {
+  }
+
+  return true;
+}
+
+bool TestLearnerBatch::testCache()
+{
+  // Without a positive quantum all weights would round alike, or to NaN
+  this->learner(0, 0);
+  try
+  {
+    this->learner(1000, 0);
+    std::cout << "A cache with a weight quantum of 0 was accepted"
+              << std::endl;
+    return false;
+  }
+  catch (const std::invalid_argument &)
+  {
+  }
+
+  // Elites are carried over unchanged, so from the second generation on
+  // the cache passes them over.
+  auto neat = this->learner(1000);
+  revolve::brain::Learner< cppneat::GeneticEncodingPtr > &learner = *neat;
+
+  // Tickets in the order they were handed out, with their generation
+  std::deque< std::pair< revolve::brain::Ticket, int > > outstanding;
+  std::map< revolve::brain::Ticket, cppneat::GeneticEncodingPtr > genotypes;
+  int generation = neat->Generation();
+  for (size_t round = 0; round < CACHE_ROUNDS; round++)
+  {
+    bool waiting = not outstanding.empty();
+    auto batch = learner.askBatch(3);
+    if (neat->Generation() not_eq generation and waiting)
+    {
+      std::cout << "Generation " << neat->Generation() << " started in "
+                << "askBatch with tickets outstanding" << std::endl;
+      return false;
+    }
+    generation = neat->Generation();
+    for (const auto &ticket : batch)
+    {
+      if (not check(ticket.second))
+      {
+        return false;
+      }
+      outstanding.push_back({ticket.first, generation});
+      genotypes[ticket.first] = ticket.second;
+    }
+    if (outstanding.empty())
+    {
+      std::cout << "Round " << round << " has nothing to evaluate"
+                << std::endl;
+      return false;
+    }
+
+    // one robot finishes per round, so the others are still evaluating
+    auto told = outstanding.front();
+    outstanding.pop_front();
+    if (told.second not_eq generation)
+    {
+      std::cout << "A ticket of generation " << told.second
+                << " was told in generation " << generation << std::endl;
+      return false;
+    }
+    double weights = 0;
+    for (const auto &connection : genotypes[told.first]->connectionGenes_)
+    {
+      weights += connection.weight_;
+    }
+    learner.tellBatch(test_name, {told.first},
+                      {1.0 / (1.0 + std::abs(weights - 1.0))});
+    genotypes.erase(told.first);
+    if (neat->Generation() not_eq generation and not outstanding.empty())
+    {
+      std::cout << "Generation " << neat->Generation() << " started with "
+                << outstanding.size() << " tickets outstanding" << std::endl;
+      return false;
+    }
+    generation = neat->Generation();
+  }
+
+  if (generation < 3)
+  {
+    std::cout << "Only " << generation << " generations in "
+              << CACHE_ROUNDS << " rounds" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestLearnerBatch::testAlone()
+{
+  auto controller = boost::make_shared< BatchController >();
+  auto evaluator = boost::make_shared< BatchEvaluator >(controller);
+  auto converter = boost::make_shared< BatchConverter >();
+  auto neat = this->learner();
+  BatchBrain brain(neat, controller, evaluator, converter);
+
+  std::vector< revolve::brain::ActuatorPtr > actuators;
+  std::vector< revolve::brain::SensorPtr > sensors;
+  for (double t = 0; evaluator->evaluations < POPULATION_SIZE
+                                              * REPEAT_EVALUATIONS; t += 1)
+  {
+    brain.update(actuators, sensors, t, 1);
+  }
+
+  // The first genotype and the one after every evaluation
+  if (converter->learnerConversions not_eq evaluator->evaluations
+      or converter->conversions not_eq evaluator->evaluations + 1
+      or neat->Generation() not_eq 1)
+  {
+    std::cout << "Alone: " << evaluator->evaluations << " evaluations, "
+              << converter->conversions << " conversions, "
+              << converter->learnerConversions << " back, generation "
+              << neat->Generation() << std::endl;
+    return false;
+  }
+
+  // Robots can't join once the brain evaluates alone
+  try
+  {
+    brain.addRobot(controller, evaluator);
+    std::cout << "Robot added after the first update" << std::endl;
+    return false;
+  }
+  catch (const std::logic_error &)
+  {
+  }
+  return true;
+}
+
+bool TestLearnerBatch::testFleet()
+{
+  std::vector< boost::shared_ptr< BatchController > > controllers;
+  std::vector< boost::shared_ptr< BatchEvaluator > > evaluators;
+  for (size_t i = 0; i <= FLEET_SIZE; i++)
+  {
+    controllers.push_back(boost::make_shared< BatchController >());
+    evaluators.push_back(
+            boost::make_shared< BatchEvaluator >(controllers.back()));
+  }
+
+  // controller 0 is the one of the brain itself
+  auto brainConverter = boost::make_shared< BatchConverter >();
+  BatchBrain brain(this->learner(),
+                   controllers[0],
+                   evaluators[0],
+                   brainConverter);
+  auto converter = boost::make_shared< BatchConverter >();
+  for (size_t i = 1; i <= FLEET_SIZE; i++)
+  {
+    auto robot = i == 1 ? brain.addRobot(controllers[i], evaluators[i],
+                                         converter)
+                        : brain.addRobot(controllers[i], evaluators[i]);
+    if (robot not_eq i - 1)
+    {
+      std::cout << "Robot " << i << " got the wrong index" << std::endl;
+      return false;
+    }
+  }
+
+  std::vector< revolve::brain::ActuatorPtr > actuators;
+  std::vector< revolve::brain::SensorPtr > sensors;
+  size_t evaluations = 0;
+  for (double t = 0; evaluations < GENERATIONS * POPULATION_SIZE
+                                   * REPEAT_EVALUATIONS; t += 1)
+  {
+    brain.update(actuators, sensors, t, 1);
+    for (size_t i = 1; i <= FLEET_SIZE; i++)
+    {
+      brain.updateRobot(i - 1, actuators, sensors, t, 1);
+    }
+
+    evaluations = 0;
+    for (const auto &evaluator : evaluators)
+    {
+      evaluations += evaluator->evaluations;
+    }
+  }
+
+  for (size_t i = 0; i <= FLEET_SIZE; i++)
+  {
+    if (controllers[i]->phenotypes < 2 or not check(controllers[i]->phenotype))
+    {
+      std::cout << "Robot " << i << " evaluated " << controllers[i]->phenotypes
+                << " genotypes" << std::endl;
+      return false;
+    }
+  }
+  // Every robot converts its genotypes with a converter of its own
+  std::vector< boost::shared_ptr< BatchConverter > > converters;
+  converters.push_back(brainConverter);
+  converters.push_back(converter);
+  converters.insert(converters.end(),
+                    brainConverter->clones.begin(),
+                    brainConverter->clones.end());
+  if (converters.size() not_eq FLEET_SIZE + 1)
+  {
+    std::cout << "The converter of the brain was cloned "
+              << brainConverter->clones.size() << " times" << std::endl;
+    return false;
+  }
+  for (size_t i = 0; i <= FLEET_SIZE; i++)
+  {
+    if (converters[i]->conversions not_eq controllers[i]->phenotypes)
+    {
+      std::cout << "Robot " << i << " converted "
+                << converters[i]->conversions << " of "
+                << controllers[i]->phenotypes << " genotypes" << std::endl;
+      return false;
+    }
+  }
+
+  // A converter that can't be cloned has to be given for every robot
+  brainConverter->cloneable = false;
+  try
+  {
+    brain.addRobot(controllers[1], evaluators[1]);
+    std::cout << "Robot added without a converter" << std::endl;
+    return false;
+  }
+  catch (const std::invalid_argument &)
+  {
+  }
+
+  return true;
+}
+
+int main()
+{
+  TestLearnerBatch t;
+  return t.test() ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Batch ask/tell of NEATLearner, alone and driving a fleet
+* through ConverterSplitBrain
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVE_BRAIN_TESTLEARNERBATCH_H
+#define REVOLVE_BRAIN_TESTLEARNERBATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "brain/Converter.h"
+#include "brain/ConverterSplitBrain.h"
+#include "brain/Evaluator.h"
+#include "brain/controller/Controller.h"
+#include "brain/learner/NEATLearner.h"
+
+/// \brief Keeps the genotype it is given as its phenotype
+class BatchController
+        : public revolve::brain::Controller< cppneat::GeneticEncodingPtr >
+{
+  public:
+  cppneat::GeneticEncodingPtr getPhenotype() override;
+
+  void setPhenotype(cppneat::GeneticEncodingPtr phenotype) override;
+
+  void update(
+          const std::vector< revolve::brain::ActuatorPtr > &actuators,
+          const std::vector< revolve::brain::SensorPtr > &sensors,
+          double t,
+          double step) override;
+
+  cppneat::GeneticEncodingPtr phenotype;
+
+  size_t phenotypes = 0;
+};
+
+/// \brief Fitness of the phenotype of a BatchController
+class BatchEvaluator
+        : public revolve::brain::Evaluator
+{
+  public:
+  explicit BatchEvaluator(boost::shared_ptr< BatchController > controller);
+
+  void start() override;
+
+  double fitness() override;
+
+  boost::shared_ptr< BatchController > controller;
+
+  size_t evaluations = 0;
+};
+
+/// \brief Passes genotypes on unchanged and counts them
+class BatchConverter
+        : public revolve::brain::Converter< cppneat::GeneticEncodingPtr,
+                                            cppneat::GeneticEncodingPtr >
+{
+  public:
+  cppneat::GeneticEncodingPtr convertForController(
+          cppneat::GeneticEncodingPtr genotype) override;
+
+  cppneat::GeneticEncodingPtr convertForLearner(
+          cppneat::GeneticEncodingPtr phenotype) override;
+
+  /// \brief A new converter, kept in clones, or nullptr if not cloneable
+  boost::shared_ptr< Converter > Clone() const override;
+
+  size_t conversions = 0;
+
+  size_t learnerConversions = 0;
+
+  bool cloneable = true;
+
+  mutable std::vector< boost::shared_ptr< BatchConverter > > clones;
+};
+
+/// \brief A brain with a NEATLearner, a BatchController and a
+/// BatchConverter
+class BatchBrain
+        : public revolve::brain::ConverterSplitBrain<
+                cppneat::GeneticEncodingPtr,
+                cppneat::GeneticEncodingPtr >
+{
+  public:
+  BatchBrain(
+          boost::shared_ptr< cppneat::NEATLearner > learner,
+          boost::shared_ptr< BatchController > controller,
+          revolve::brain::EvaluatorPtr evaluator,
+          boost::shared_ptr< BatchConverter > converter);
+};
+
+class TestLearnerBatch
+{
+  public:
+  /// \brief Runs all tests. Returns false if one of the tests fails.
+  bool test();
+
+  private:
+  /// \brief A learner evolving POPULATION_SIZE genotypes of 3 inputs and an
+  /// output, evaluating each of them REPEAT_EVALUATIONS times and
+  /// remembering the fitness of _cacheSize genotypes, whose weights are
+  /// compared after rounding them to a multiple of _weightQuantum
+  boost::shared_ptr< cppneat::NEATLearner > learner(
+          int _cacheSize = 0,
+          double _weightQuantum =
+                  cppneat::NEATLearner::FITNESS_CACHE_WEIGHT_QUANTUM);
+
+  /// \brief Whether the connections of _genotype join existing neurons
+  bool check(cppneat::GeneticEncodingPtr _genotype);
+
+  /// \brief Every genotype of a generation is handed out
+  /// REPEAT_EVALUATIONS times, batches are never larger than asked, and
+  /// the last batch of a generation falls short
+  bool testGenerations();
+
+  /// \brief With the fitness cache on, robots that finish in any order
+  /// only tell tickets of the current generation, and the generation
+  /// doesn't change while tickets are outstanding. The cache needs a
+  /// positive weight quantum.
+  bool testCache();
+
+  /// \brief A brain without a fleet evaluates through currentGenotype()
+  /// and reportFitness(), converting every phenotype back for the learner
+  bool testAlone();
+
+  /// \brief A fleet of FLEET_SIZE robots keeps evaluating through
+  /// ConverterSplitBrain, the first one with the converter it is given and
+  /// the others with clones of the one of the brain
+  bool testFleet();
+
+  const size_t POPULATION_SIZE = 20;
+
+  const size_t REPEAT_EVALUATIONS = 2;
+
+  const size_t GENERATIONS = 3;
+
+  const size_t FLEET_SIZE = 7;
+
+  const size_t CACHE_ROUNDS = 400;
+};
+
+#endif  // REVOLVE_BRAIN_TESTLEARNERBATCH_H
@@ -0,0 +1,226 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Thread scaling of the generation turnover of NEATLearner
+* Author: TODO <Add proper author>
+*
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "brain/learner/NEATLearner.h"
+#include "brain/learner/cppneat/CPPNMutator.h"
+#include "util/scheduler.h"
+#include "util/timer.h"
+
+#include "neat/test/ThreadScaling.h"
+#include "test_NEATLearnerScaling.h"
+
+// NEATLearner appends every evaluated genotype to <name>.policy
+const std::string test_name = "/tmp/TestNEATLearnerScaling";
+
+TestNEATLearnerScaling::TestNEATLearnerScaling()
+{
+}
+
+TestNEATLearnerScaling::~TestNEATLearnerScaling()
+{
+}
+
+bool TestNEATLearnerScaling::test()
+{
+  if (not testScaling())
+  {
+    return false;
+  }
+
+  return true;
+}
+
+bool TestNEATLearnerScaling::check(
+        cppneat::GeneticEncodingPtr genotype,
+        std::map< std::pair< size_t, size_t >, size_t > &innovations)
+{
+  for (const auto &connection : genotype->connectionGenes_)
+  {
+    if (not genotype->ExistingNeuron(connection.from_)
+        or not genotype->ExistingNeuron(connection.to_))
+    {
+      std::cout << "Connection " << connection.InnovationNumber()
+                << " joins a missing neuron" << std::endl;
+      return false;
+    }
+    auto edge = std::make_pair(connection.from_, connection.to_);
+    auto known = innovations.insert({edge, connection.InnovationNumber()});
+    if (known.first->second not_eq connection.InnovationNumber())
+    {
+      std::cout << "Connections from " << edge.first << " to " << edge.second
+                << " have innovation numbers " << known.first->second
+                << " and " << connection.InnovationNumber() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestNEATLearnerScaling::run(
+        size_t nthreads,
+        double &seconds,
+        Links &links)
+{
+  NEAT::Scheduler::set_nthreads(nthreads);
+  std::remove((test_name + ".policy").c_str());
+
+  std::map< cppneat::Neuron::Ntype, cppneat::Neuron::NeuronTypeSpec > spec;
+  spec[cppneat::Neuron::INPUT].possibleLayers = {
+          cppneat::Neuron::INPUT_LAYER};
+  spec[cppneat::Neuron::SIGMOID].parameters = {
+          {"rv:bias", -1, 1, false, false, 1e-9},
+          {"rv:gain", 0, 1, false, false, 1e-9}};
+  spec[cppneat::Neuron::SIGMOID].possibleLayers = {
+          cppneat::Neuron::HIDDEN_LAYER,
+          cppneat::Neuron::OUTPUT_LAYER};
+
+  // 6 inputs fully connected to 2 outputs
+  cppneat::GeneticEncodingPtr start(new cppneat::GeneticEncoding(false));
+  size_t innovation = 1;
+  for (size_t i = 0; i < 6; i++)
+  {
+    start->AddNeuron(
+            cppneat::Neuron("Input-" + std::to_string(i),
+                            cppneat::Neuron::INPUT_LAYER,
+                            cppneat::Neuron::INPUT,
+                            {}),
+            cppneat::Gene(innovation++));
+  }
+  for (size_t o = 0; o < 2; o++)
+  {
+    start->AddNeuron(
+            cppneat::Neuron("Output-" + std::to_string(o),
+                            cppneat::Neuron::OUTPUT_LAYER,
+                            cppneat::Neuron::SIGMOID,
+                            {{"rv:bias", 0}, {"rv:gain", 0.5}}),
+            cppneat::Gene(innovation++));
+  }
+  for (size_t o = 7; o <= 8; o++)
+  {
+    for (size_t i = 1; i <= 6; i++)
+    {
+      start->AddConnection(cppneat::ConnectionGene(o, i, 0, innovation++));
+    }
+  }
+
+  cppneat::MutatorPtr mutator(new cppneat::Mutator(
+          spec, 1, innovation, 100, std::vector< cppneat::Neuron::Ntype >()));
+
+  cppneat::NEATLearner::LearningConfiguration config;
+  config.asexual = false;
+  config.popSize = POPULATION_SIZE;
+  config.tournamentSize = cppneat::NEATLearner::TOURNAMENT_SIZE;
+  config.numChildren = POPULATION_SIZE * 9 / 10;
+  config.maxGenerations = GENERATIONS + 1;
+  config.repeat_evaluations = 1;
+  config.initialStructuralMutations = 3;
+  config.speciationThreshold = 1.0;
+  config.weightMutationProbability =
+          cppneat::NEATLearner::WEIGHT_MUTATION_PROBABILITY;
+  config.weightMutationSigma = 0.5;
+  config.paramMutationProbability =
+          cppneat::NEATLearner::PARAM_MUTATION_PROBABILITY;
+  config.paramMutationSigma = cppneat::NEATLearner::PARAM_MUTATION_SIGMA;
+  config.structuralAugmentationProbability =
+          cppneat::NEATLearner::STRUCTURAL_AUGMENTATION_PROBABILITY;
+  config.structuralRemovalProbability = 0.2;
+  config.interspeciesMateProbability =
+          cppneat::NEATLearner::INTERSPECIES_MATE_PROBABILITY;
+  // every genotype is evaluated, so a generation is POPULATION_SIZE reports
+  config.fitnessCacheSize = 0;
+  config.rngSeed = 1;
+  config.startFrom = start;
+
+  cppneat::NEATLearner neat(mutator, "none", config);
+  revolve::brain::Learner< cppneat::GeneticEncodingPtr > &learner = neat;
+
+  std::map< std::pair< size_t, size_t >, size_t > innovations;
+  seconds = 0.0;
+  links.assign(GENERATIONS, {});
+  for (size_t gen = 1; gen <= GENERATIONS; gen++)
+  {
+    for (size_t i = 0; i < POPULATION_SIZE; i++)
+    {
+      cppneat::GeneticEncodingPtr genotype = learner.currentGenotype();
+      if (not check(genotype, innovations))
+      {
+        return false;
+      }
+      for (const auto &connection : genotype->connectionGenes_)
+      {
+        links[gen - 1].push_back(std::make_tuple(
+                connection.from_,
+                connection.to_,
+                connection.InnovationNumber()));
+      }
+
+      double weights = 0;
+      for (const auto &connection : genotype->connectionGenes_)
+      {
+        weights += connection.weight_;
+      }
+      double fitness = 1.0 / (1.0 + std::abs(weights - 3.0));
+
+      // The last report of a generation creates the next one.
+      double start = NEAT::Timer::now();
+      learner.reportFitness(test_name, genotype, fitness);
+      if (i == POPULATION_SIZE - 1 and gen < GENERATIONS)
+      {
+        seconds += NEAT::Timer::now() - start;
+      }
+    }
+  }
+
+  std::remove((test_name + ".policy").c_str());
+
+  // The connections of a generation are compared regardless of the order
+  // in which its genotypes were handed out.
+  for (auto &generation : links)
+  {
+    std::sort(generation.begin(), generation.end());
+  }
+  return true;
+}
+
+bool TestNEATLearnerScaling::testScaling()
+{
+  return testThreadScaling< Links >(
+          [this](size_t nthreads, double &seconds, Links &links)
+          {
+            return this->run(nthreads, seconds, links);
+          },
+          GENERATIONS - 1);
+}
+
+int main()
+{
+  TestNEATLearnerScaling t;
+  return t.test() ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+/*
+* Copyright (C) 2017 Vrije Universiteit Amsterdam
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* Description: Thread scaling of the generation turnover of NEATLearner
+* Author: TODO <Add proper author>
+*
+*/
+
+#ifndef REVOLVE_BRAIN_TESTNEATLEARNERSCALING_H
+#define REVOLVE_BRAIN_TESTNEATLEARNERSCALING_H
+
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "brain/learner/cppneat/CPPNTypes.h"
+
+class TestNEATLearnerScaling
+{
+  public:
+  TestNEATLearnerScaling();
+
+  ~TestNEATLearnerScaling();
+
+  /// \brief Runs all tests. Returns false if one of the tests fails.
+  bool test();
+
+  private:
+  /// \brief Sorted (from, to, innovation number) of the connections of all
+  /// genotypes, per generation
+  typedef std::vector< std::vector< std::tuple< size_t, size_t, size_t > > >
+          Links;
+
+  /// \brief Evolves a population for GENERATIONS generations on nthreads
+  /// threads, setting seconds to the time spent creating new generations.
+  /// Returns false if a genotype was broken.
+  bool run(
+          size_t nthreads,
+          double &seconds,
+          Links &links);
+
+  /// \brief Whether the connections of genotype join existing neurons, and
+  /// every connection between the same two neurons, in any genotype seen
+  /// so far, has the same innovation number
+  bool check(
+          cppneat::GeneticEncodingPtr genotype,
+          std::map< std::pair< size_t, size_t >, size_t > &innovations);
+
+  /// \brief report how the generation turnover scales with the number of
+  /// threads, test that no thread breaks the genotypes or the innovation
+  /// numbers, and that the connections of every generation don't depend on
+  /// the number of threads
+  bool testScaling();
+
+  const size_t POPULATION_SIZE = 500;
+
+  const size_t GENERATIONS = 10;
+};
+
+#endif  // REVOLVE_BRAIN_TESTNEATLEARNERSCALING_H